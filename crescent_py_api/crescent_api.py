@@ -1110,6 +1110,22 @@ class SceneTree:
         crescent_api_internal.scene_tree_change_scene(path=path)
 
 
+# PREFAB REGISTRY
+class PrefabRegistry:
+    @staticmethod
+    def register(name: str, node) -> None:
+        crescent_api_internal.prefab_registry_register(
+            name=name, entity_id=node.entity_id
+        )
+
+    @staticmethod
+    def instantiate(name: str, parent):
+        node = crescent_api_internal.prefab_registry_instantiate(
+            name=name, parent_entity_id=parent.entity_id
+        )
+        return Node.parse_scene_node_from_engine(scene_node=node)
+
+
 # AUDIO MANAGER
 class AudioManager:
     @staticmethod
@@ -69,6 +69,14 @@ def scene_tree_change_scene(path: str) -> None:
     pass
 
 
+def prefab_registry_register(name: str, entity_id: int) -> None:
+    pass
+
+
+def prefab_registry_instantiate(name: str, parent_entity_id: int):
+    return None
+
+
 def audio_manager_play_sound(path: str, loops: bool) -> None:
     pass
 
@@ -2,6 +2,7 @@
 
 #include "data_structures/rbe_hash_map_string.h"
 #include "rendering/texture.h"
+#include "rendering/texture_atlas.h"
 #include "rendering/font.h"
 #include "audio/audio.h"
 #include "audio/audio_manager.h"
@@ -35,6 +36,22 @@ Texture* rbe_asset_manager_load_texture(const char* fileName, const char* key) {
     return texture;
 }
 
+// Loads textures packed together into shared atlas pages so they can be drawn in the same batch
+void rbe_asset_manager_load_textures_into_atlas(const char** fileNames, const char** keys, size_t count) {
+    RBE_ASSERT(texturesMap != NULL);
+    Texture** textures = (Texture**) RBE_MEM_ALLOCATE_SIZE(count * sizeof(Texture*));
+    for (size_t i = 0; i < count; i++) {
+        RBE_ASSERT_FMT(!rbe_string_hash_map_has(texturesMap, keys[i]), "Already loaded texture at file path '%s'!  Has key '%s'.", fileNames[i], keys[i]);
+        textures[i] = rbe_texture_load_texture_image(fileNames[i]);
+    }
+    rbe_texture_atlas_build(textures, count);
+    for (size_t i = 0; i < count; i++) {
+        rbe_string_hash_map_add(texturesMap, keys[i], textures[i], sizeof(Texture));
+        RBE_MEM_FREE(textures[i]);
+    }
+    RBE_MEM_FREE(textures);
+}
+
 Texture* rbe_asset_manager_get_texture(const char* key) {
     return (Texture*) rbe_string_hash_map_get(texturesMap, key);
 }
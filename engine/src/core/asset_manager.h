@@ -1,11 +1,13 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 
 void rbe_asset_manager_initialize();
 void rbe_asset_manager_finalize();
 // --- Texture --- //
 struct Texture* rbe_asset_manager_load_texture(const char* fileName, const char* key);
+void rbe_asset_manager_load_textures_into_atlas(const char** fileNames, const char** keys, size_t count);
 struct Texture* rbe_asset_manager_get_texture(const char* key);
 bool rbe_asset_manager_has_texture(const char* key);
 // --- Font --- //
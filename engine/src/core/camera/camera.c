@@ -1,5 +1,7 @@
 #include "camera.h"
 
+#include <math.h>
+
 #include "../game_properties.h"
 
 void rbe_camera2d_clamp_viewport_to_boundary(RBECamera2D* camera2D) {
@@ -15,3 +17,19 @@ void rbe_camera2d_clamp_viewport_to_boundary(RBECamera2D* camera2D) {
         camera2D->viewport.y = camera2D->boundary.h - (float) gameProperties->resolutionHeight;
     }
 }
+
+Rect2 rbe_camera2d_get_world_view_rect(const RBECamera2D* camera2D) {
+    RBEGameProperties* gameProperties = rbe_game_props_get();
+    // Inverse of the renderer's view, zoom(position + offset - viewport)
+    const float width = (float) gameProperties->resolutionWidth / camera2D->zoom.x;
+    const float height = (float) gameProperties->resolutionHeight / camera2D->zoom.y;
+    const float x = camera2D->viewport.x - camera2D->offset.x;
+    const float y = camera2D->viewport.y - camera2D->offset.y;
+    const Rect2 viewRect = {
+        .x = width < 0.0f ? x + width : x,
+        .y = height < 0.0f ? y + height : y,
+        .w = fabsf(width),
+        .h = fabsf(height)
+    };
+    return viewRect;
+}
@@ -10,3 +10,5 @@ typedef struct RBECamera2D {
 } RBECamera2D;
 
 void rbe_camera2d_clamp_viewport_to_boundary(RBECamera2D* camera2D);
+// Area of the world visible through the camera at the game's resolution
+Rect2 rbe_camera2d_get_world_view_rect(const RBECamera2D* camera2D);
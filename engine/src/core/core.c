@@ -9,13 +9,16 @@
 #include "engine_context.h"
 #include "asset_manager.h"
 #include "input/input.h"
+#include "memory/rbe_mem.h"
 #include "utils/logger.h"
 #include "utils/command_line_args_util.h"
 #include "utils/rbe_file_system_utils.h"
 #include "utils/rbe_assert.h"
 #include "scripting/python/rbe_py.h"
 #include "rendering/renderer.h"
+#include "rendering/headless_context.h"
 #include "audio/audio_manager.h"
+#include "ecs/ecs_command_buffer.h"
 #include "ecs/ecs_manager.h"
 #include "ecs/system/ec_system.h"
 #include "scene/scene_manager.h"
@@ -32,6 +35,7 @@ void rbe_render();
 
 static SDL_Window* window = NULL;
 static SDL_GLContext openGlContext;
+static CommandLineFlagResult commandLineFlagResult;
 RBEGameProperties* gameProperties = NULL;
 RBEEngineContext* engineContext = NULL;
 
@@ -42,7 +46,7 @@ bool rbe_initialize(int argv, char** args) {
     rbe_logger_set_level(LogLevel_DEBUG);
 
     // TODO: Check for working directory overrides
-    CommandLineFlagResult commandLineFlagResult = rbe_command_line_args_parse(argv, args);
+    commandLineFlagResult = rbe_command_line_args_parse(argv, args);
     if (strcmp(commandLineFlagResult.workingDirOverride, "") != 0) {
         rbe_logger_debug("Changing working directory from override to '%s'.", commandLineFlagResult.workingDirOverride);
         rbe_fs_chdir(commandLineFlagResult.workingDirOverride);
@@ -79,6 +83,9 @@ bool rbe_initialize(int argv, char** args) {
     }
 
     rbe_scene_manager_initialize();
+    if (strcmp(commandLineFlagResult.sceneExportDir, "") != 0) {
+        rbe_scene_manager_set_scene_binary_export_directory(commandLineFlagResult.sceneExportDir);
+    }
 
     rbe_load_assets_from_configuration();
 
@@ -94,7 +101,9 @@ bool rbe_initialize(int argv, char** args) {
 }
 
 bool rbe_initialize_sdl() {
-    if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+    // Video is skipped when headless as there may not be a display
+    const Uint32 sdlFlags = commandLineFlagResult.isHeadless ? SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_EVERYTHING;
+    if (SDL_Init(sdlFlags) != 0) {
         rbe_logger_error("Failed to initialize sdl!");
         return false;
     }
@@ -102,6 +111,20 @@ bool rbe_initialize_sdl() {
 }
 
 bool rbe_initialize_rendering() {
+    if (commandLineFlagResult.isHeadless) {
+        RBEGameProperties* props = rbe_game_props_get();
+        const RBEHeadlessFrameCapture frameCapture = {
+            .logChecksums = commandLineFlagResult.logFrameChecksums,
+            .dumpDirectory = commandLineFlagResult.frameDumpDir
+        };
+        if (!rbe_headless_context_initialize(props->resolutionWidth, props->resolutionHeight, frameCapture)) {
+            rbe_logger_error("Failed to initialize headless context!");
+            return false;
+        }
+        rbe_renderer_initialize();
+        return true;
+    }
+
     // OpenGL attributes
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
@@ -168,10 +191,12 @@ bool rbe_load_assets_from_configuration() {
     }
 
     // Textures
+    const char** texturePaths = (const char**) RBE_MEM_ALLOCATE_SIZE(gameProperties->textureCount * sizeof(const char*));
     for (size_t i = 0; i < gameProperties->textureCount; i++) {
-        const RBEAssetTexture assetTexture = gameProperties->textures[i];
-        rbe_asset_manager_load_texture(assetTexture.file_path, assetTexture.file_path);
+        texturePaths[i] = gameProperties->textures[i].file_path;
     }
+    rbe_asset_manager_load_textures_into_atlas(texturePaths, texturePaths, gameProperties->textureCount);
+    RBE_MEM_FREE(texturePaths);
 
     // Fonts
     for (size_t i = 0; i < gameProperties->fontCount; i++) {
@@ -196,6 +221,9 @@ void rbe_update() {
     // Process Scene change if exists
     rbe_scene_manager_process_queued_scene_change();
 
+    // Apply structural changes recorded last frame, entity destruction goes through the deletion queue below
+    rbe_ecs_command_buffer_playback();
+
     // Clear out queued nodes for deletion
     rbe_scene_manager_process_queued_deletion_entities();
 
@@ -216,6 +244,12 @@ void rbe_update() {
     }
     float averageFPS = (float) countedFrames / ((float) SDL_GetTicks() / 1000.f);
     engineContext->averageFPS = averageFPS;
+
+    static int framesRendered = 0;
+    framesRendered++;
+    if (commandLineFlagResult.frameLimit > 0 && framesRendered >= commandLineFlagResult.frameLimit) {
+        engineContext->isRunning = false;
+    }
 }
 
 void rbe_process_inputs() {
@@ -238,7 +272,8 @@ void rbe_process_game_update() {
     const uint32_t targetFps = engineContext->targetFPS;
     const uint32_t FRAME_TARGET_TIME = MILLISECONDS_PER_TICK / targetFps;
     const uint32_t timeToWait = FRAME_TARGET_TIME - (SDL_GetTicks() - lastFrameTime);
-    if (timeToWait > 0 && timeToWait <= FRAME_TARGET_TIME) {
+    // Headless runs aren't capped to the target fps so they measure how fast frames can be produced
+    if (!commandLineFlagResult.isHeadless && timeToWait > 0 && timeToWait <= FRAME_TARGET_TIME) {
         SDL_Delay(timeToWait);
     }
 
@@ -276,11 +311,17 @@ void rbe_render() {
     glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
+    // Render systems only read global transforms from here on
+    rbe_scene_manager_update_global_transforms();
     rbe_ec_system_render_systems();
 
     rbe_renderer_flush_batches();
 
-    SDL_GL_SwapWindow(window);
+    if (commandLineFlagResult.isHeadless) {
+        rbe_headless_context_end_frame();
+    } else {
+        SDL_GL_SwapWindow(window);
+    }
 }
 
 bool rbe_is_running() {
@@ -288,10 +329,18 @@ bool rbe_is_running() {
 }
 
 void rbe_shutdown() {
-    SDL_DestroyWindow(window);
-    SDL_GL_DeleteContext(openGlContext);
+    if (commandLineFlagResult.isHeadless) {
+        const unsigned int frameCount = rbe_headless_context_get_frame_count();
+        const uint32_t elapsedTime = SDL_GetTicks();
+        rbe_logger_info("Headless run rendered '%u' frames in '%u' ms since startup", frameCount, elapsedTime);
+        rbe_renderer_finalize();
+        rbe_headless_context_finalize();
+    } else {
+        SDL_DestroyWindow(window);
+        SDL_GL_DeleteContext(openGlContext);
+        rbe_renderer_finalize();
+    }
     SDL_Quit();
-    rbe_renderer_finalize();
     rbe_game_props_finalize();
     rbe_audio_manager_finalize();
     rbe_input_finalize();
@@ -0,0 +1,44 @@
+#pragma once
+
+// Helper class for generalized use of dynamic arrays, same interface as static arrays but grows on demand
+
+#include <string.h>
+
+#include "../memory/rbe_mem.h"
+
+#define RBE_DYNAMIC_ARRAY_INITIAL_CAPACITY 16
+
+#define RBE_DYNAMIC_ARRAY_CREATE(ARRAY_TYPE, ARRAY_NAME) \
+static ARRAY_TYPE* ARRAY_NAME = NULL;                    \
+static size_t ARRAY_NAME ##_count = 0;                   \
+static size_t ARRAY_NAME ##_capacity = 0
+
+#define RBE_DYNAMIC_ARRAY_ADD(ARRAY_NAME, ARRAY_VALUE)                                                                      \
+{                                                                                                                          \
+if (ARRAY_NAME ##_count >= ARRAY_NAME ##_capacity) {                                                                       \
+ARRAY_NAME ##_capacity = ARRAY_NAME ##_capacity == 0 ? RBE_DYNAMIC_ARRAY_INITIAL_CAPACITY : ARRAY_NAME ##_capacity * 2;    \
+ARRAY_NAME = RBE_MEM_REALLOCATE(ARRAY_NAME, ARRAY_NAME ##_capacity * sizeof(*ARRAY_NAME));                                  \
+}                                                                                                                          \
+ARRAY_NAME[ARRAY_NAME ##_count++] = ARRAY_VALUE;                                                                           \
+}
+
+// Removes the first matching value and keeps the order of the remaining values
+#define RBE_DYNAMIC_ARRAY_REMOVE(ARRAY_NAME, ARRAY_VALUE)                                                  \
+{                                                                                                         \
+for (size_t i = 0; i < ARRAY_NAME ##_count; i++) {                                                        \
+if (ARRAY_NAME[i] == ARRAY_VALUE) {                                                                       \
+memmove(&ARRAY_NAME[i], &ARRAY_NAME[i + 1], (ARRAY_NAME ##_count - i - 1) * sizeof(*ARRAY_NAME));         \
+ARRAY_NAME ##_count--;                                                                                    \
+break;                                                                                                    \
+}                                                                                                         \
+}                                                                                                         \
+}
+
+#define RBE_DYNAMIC_ARRAY_EMPTY(ARRAY_NAME) \
+ARRAY_NAME ##_count = 0;
+
+#define RBE_DYNAMIC_ARRAY_FREE(ARRAY_NAME) \
+RBE_MEM_FREE(ARRAY_NAME);                  \
+ARRAY_NAME = NULL;                         \
+ARRAY_NAME ##_count = 0;                   \
+ARRAY_NAME ##_capacity = 0;
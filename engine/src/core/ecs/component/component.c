@@ -1,165 +1,600 @@
 #include "component.h"
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
+#include "node_component.h"
+#include "transform2d_component.h"
+#include "sprite_component.h"
+#include "animated_sprite_component.h"
+#include "text_label_component.h"
+#include "script_component.h"
+#include "collider2d_component.h"
+#include "color_square_component.h"
 #include "../../memory/rbe_mem.h"
 #include "../../utils/rbe_assert.h"
 
-//--- Component Array ---//
-typedef struct ComponentArray {
-    void* components[MAX_COMPONENTS];
-} ComponentArray;
+//--- Component Archetype ---//
+// Entities with the same set of components share an archetype.  An archetype's rows are stored in fixed size chunks
+// that never move once allocated, each chunk holds its entities followed by an array per component type.  Removing a
+// row swaps the archetype's last row into it, adding or removing a component moves the entity's row to another
+// archetype.  The empty archetype holds entities without components and has no storage.
+// Every component array is followed by the change tick of each row and the latest change tick of the whole chunk.
+#define COMPONENT_MANAGER_INITIAL_ENTITY_CAPACITY 1024
+#define COMPONENT_ARCHETYPE_EMPTY_INDEX 0
+#define COMPONENT_ARCHETYPE_INVALID_INDEX UINT32_MAX
+#define COMPONENT_ARCHETYPE_NO_COLUMN UINT32_MAX
 
-ComponentArray* component_array_create() {
-    ComponentArray* componentArray = RBE_MEM_ALLOCATE(ComponentArray);
-    for (unsigned int i = 0; i < MAX_COMPONENTS; i++) {
-        componentArray->components[i] = NULL;
-    }
-    return componentArray;
+typedef struct ComponentTypeInfo {
+    const char* name;
+    size_t size;
+    size_t stride; // Size rounded up to the component's alignment
+    ComponentDestructorFunc destructor;
+} ComponentTypeInfo;
+
+struct ComponentArchetype {
+    ComponentSignature signature;
+    uint32_t columnOffsets[MAX_COMPONENTS]; // Byte offset of a component type's array within a chunk
+    uint32_t changeTickOffsets[MAX_COMPONENTS]; // Byte offset of a component type's change ticks within a chunk
+    ComponentDataIndex columnIndices[MAX_COMPONENTS];
+    size_t columnCount;
+    size_t chunkSize;
+    char** chunks;
+    size_t chunkCount;
+    size_t count;
+    // Archetypes reached by adding or removing a component, looked up on first use
+    uint32_t addEdges[MAX_COMPONENTS];
+    uint32_t removeEdges[MAX_COMPONENTS];
+};
+
+// Where an entity's components are stored, indexed by entity index
+typedef struct ComponentEntityRecord {
+    uint32_t archetypeIndex;
+    uint32_t row;
+} ComponentEntityRecord;
+
+struct ComponentQuery {
+    ComponentSignature signature;
+    uint32_t* archetypeIndices;
+    size_t archetypeCount;
+    size_t archetypeCapacity;
+    ComponentQueryChunk* chunks;
+    size_t chunkCapacity;
+};
+
+//--- Component Manager ---//
+typedef struct ComponentManager {
+    ComponentTypeInfo componentTypes[MAX_COMPONENTS];
+    size_t componentTypeCount;
+    ComponentArchetype** archetypes;
+    size_t archetypeCount;
+    size_t archetypeCapacity;
+    ComponentEntityRecord* entityRecords;
+    size_t entityRecordsCapacity;
+    ComponentQuery** queries;
+    size_t queryCount;
+    uint32_t changeTick;
+} ComponentManager;
+
+static ComponentManager* componentManager = NULL;
+
+static inline char* component_archetype_get_component(const ComponentArchetype* archetype, uint32_t row, ComponentDataIndex index) {
+    return archetype->chunks[row / COMPONENT_ARCHETYPE_CHUNK_CAPACITY] + archetype->columnOffsets[index]
+           + (row % COMPONENT_ARCHETYPE_CHUNK_CAPACITY) * componentManager->componentTypes[index].stride;
+}
+
+static inline uint32_t* component_archetype_get_change_ticks(const ComponentArchetype* archetype, uint32_t row, ComponentDataIndex index) {
+    return (uint32_t*) (archetype->chunks[row / COMPONENT_ARCHETYPE_CHUNK_CAPACITY] + archetype->changeTickOffsets[index]);
 }
 
-void component_array_initialize(ComponentArray* componentArray) {
-    for (unsigned int i = 0; i < MAX_COMPONENTS; i++) {
-        componentArray->components[i] = NULL;
+// Chunk ticks only ever go up, so they may be newer than any row left in the chunk
+static inline void component_archetype_set_change_tick(const ComponentArchetype* archetype, uint32_t row, ComponentDataIndex index, uint32_t changeTick) {
+    uint32_t* changeTicks = component_archetype_get_change_ticks(archetype, row, index);
+    changeTicks[row % COMPONENT_ARCHETYPE_CHUNK_CAPACITY] = changeTick;
+    if (changeTick > changeTicks[COMPONENT_ARCHETYPE_CHUNK_CAPACITY]) {
+        changeTicks[COMPONENT_ARCHETYPE_CHUNK_CAPACITY] = changeTick;
     }
 }
 
-bool component_array_has_component(ComponentArray* componentArray, ComponentDataIndex index) {
-    return componentArray->components[index] == NULL ? false : true;
+static inline uint32_t component_archetype_get_change_tick(const ComponentArchetype* archetype, uint32_t row, ComponentDataIndex index) {
+    return component_archetype_get_change_ticks(archetype, row, index)[row % COMPONENT_ARCHETYPE_CHUNK_CAPACITY];
 }
 
-void* component_array_get_component(ComponentArray* componentArray, ComponentDataIndex index) {
-    return componentArray->components[index];
+static inline Entity* component_archetype_get_entity(const ComponentArchetype* archetype, uint32_t row) {
+    return &((Entity*) archetype->chunks[row / COMPONENT_ARCHETYPE_CHUNK_CAPACITY])[row % COMPONENT_ARCHETYPE_CHUNK_CAPACITY];
 }
 
-void component_array_set_component(ComponentArray* componentArray, ComponentDataIndex index, void* component) {
-    componentArray->components[index] = component;
+static inline bool component_signature_equals(const ComponentSignature* signatureA, const ComponentSignature* signatureB) {
+    return memcmp(signatureA->bits, signatureB->bits, sizeof(signatureA->bits)) == 0;
 }
 
-void component_array_remove_component(ComponentArray* componentArray, ComponentDataIndex index) {
-    if (component_array_has_component(componentArray, index)) {
-        RBE_MEM_FREE(componentArray->components[index]);
-        componentArray->components[index] = NULL;
+void component_query_add_archetype(ComponentQuery* query, uint32_t archetypeIndex);
+
+uint32_t component_manager_get_archetype(const ComponentSignature* signature) {
+    for (size_t i = 0; i < componentManager->archetypeCount; i++) {
+        if (component_signature_equals(&componentManager->archetypes[i]->signature, signature)) {
+            return (uint32_t) i;
+        }
+    }
+    if (componentManager->archetypeCount >= componentManager->archetypeCapacity) {
+        componentManager->archetypeCapacity = componentManager->archetypeCapacity == 0 ? 32 : componentManager->archetypeCapacity * 2;
+        componentManager->archetypes = RBE_MEM_REALLOCATE(componentManager->archetypes, componentManager->archetypeCapacity * sizeof(ComponentArchetype*));
+    }
+    ComponentArchetype* archetype = RBE_MEM_ALLOCATE(ComponentArchetype);
+    archetype->signature = *signature;
+    archetype->columnCount = 0;
+    archetype->chunks = NULL;
+    archetype->chunkCount = 0;
+    archetype->count = 0;
+    memset(archetype->columnOffsets, 0xFF, sizeof(archetype->columnOffsets));
+    memset(archetype->changeTickOffsets, 0xFF, sizeof(archetype->changeTickOffsets));
+    memset(archetype->addEdges, 0xFF, sizeof(archetype->addEdges));
+    memset(archetype->removeEdges, 0xFF, sizeof(archetype->removeEdges));
+    // Entities come first, followed by every component array aligned for any type
+    const size_t alignment = _Alignof(max_align_t);
+    size_t chunkSize = COMPONENT_ARCHETYPE_CHUNK_CAPACITY * sizeof(Entity);
+    for (size_t i = 0; i < componentManager->componentTypeCount; i++) {
+        if (component_signature_has(signature, (ComponentDataIndex) i)) {
+            chunkSize = (chunkSize + alignment - 1) & ~(alignment - 1);
+            archetype->columnOffsets[i] = (uint32_t) chunkSize;
+            archetype->columnIndices[archetype->columnCount++] = (ComponentDataIndex) i;
+            chunkSize += COMPONENT_ARCHETYPE_CHUNK_CAPACITY * componentManager->componentTypes[i].stride;
+            chunkSize = (chunkSize + _Alignof(uint32_t) - 1) & ~(_Alignof(uint32_t) - 1);
+            archetype->changeTickOffsets[i] = (uint32_t) chunkSize;
+            chunkSize += (COMPONENT_ARCHETYPE_CHUNK_CAPACITY + 1) * sizeof(uint32_t);
+        }
+    }
+    archetype->chunkSize = chunkSize;
+    const uint32_t archetypeIndex = (uint32_t) componentManager->archetypeCount++;
+    componentManager->archetypes[archetypeIndex] = archetype;
+    for (size_t i = 0; i < componentManager->queryCount; i++) {
+        component_query_add_archetype(componentManager->queries[i], archetypeIndex);
     }
+    return archetypeIndex;
 }
 
-void component_array_remove_all_components(ComponentArray* componentArray) {
-    for (size_t i = 0; i < MAX_COMPONENTS; i++) {
-        component_array_remove_component(componentArray, (ComponentDataIndex) i);
+uint32_t component_manager_get_archetype_edge(uint32_t archetypeIndex, ComponentDataIndex index, bool isAdding) {
+    uint32_t* edges = isAdding ? componentManager->archetypes[archetypeIndex]->addEdges : componentManager->archetypes[archetypeIndex]->removeEdges;
+    if (edges[index] == COMPONENT_ARCHETYPE_INVALID_INDEX) {
+        ComponentSignature signature = componentManager->archetypes[archetypeIndex]->signature;
+        if (isAdding) {
+            component_signature_add(&signature, index);
+        } else {
+            component_signature_remove(&signature, index);
+        }
+        const uint32_t edgeArchetypeIndex = component_manager_get_archetype(&signature);
+        // Archetypes may have been reallocated
+        edges = isAdding ? componentManager->archetypes[archetypeIndex]->addEdges : componentManager->archetypes[archetypeIndex]->removeEdges;
+        edges[index] = edgeArchetypeIndex;
     }
+    return edges[index];
 }
 
-//--- Component Manager ---//
-typedef struct ComponentManager {
-    ComponentArray* entityComponentArrays[MAX_ENTITIES];
-    ComponentType entityComponentSignatures[MAX_ENTITIES];
-} ComponentManager;
+ComponentEntityRecord* component_manager_get_entity_record(Entity entity) {
+    const uint32_t entityIndex = entity_get_index(entity);
+    if (entityIndex >= componentManager->entityRecordsCapacity) {
+        size_t newCapacity = componentManager->entityRecordsCapacity * 2;
+        while (entityIndex >= newCapacity) {
+            newCapacity *= 2;
+        }
+        componentManager->entityRecords = RBE_MEM_REALLOCATE(componentManager->entityRecords, newCapacity * sizeof(ComponentEntityRecord));
+        memset(&componentManager->entityRecords[componentManager->entityRecordsCapacity], 0,
+               (newCapacity - componentManager->entityRecordsCapacity) * sizeof(ComponentEntityRecord));
+        componentManager->entityRecordsCapacity = newCapacity;
+    }
+    return &componentManager->entityRecords[entityIndex];
+}
 
-static ComponentManager* componentManager = NULL;
+// Returns NULL for entities without components and stale handles
+static inline const ComponentEntityRecord* component_manager_find_entity_record(Entity entity) {
+    const uint32_t entityIndex = entity_get_index(entity);
+    if (entityIndex >= componentManager->entityRecordsCapacity) {
+        return NULL;
+    }
+    const ComponentEntityRecord* record = &componentManager->entityRecords[entityIndex];
+    if (record->archetypeIndex == COMPONENT_ARCHETYPE_EMPTY_INDEX
+            || *component_archetype_get_entity(componentManager->archetypes[record->archetypeIndex], record->row) != entity) {
+        return NULL;
+    }
+    return record;
+}
 
-ComponentType component_manager_translate_index_to_type(ComponentDataIndex index);
+uint32_t component_archetype_add_row(ComponentArchetype* archetype, Entity entity) {
+    if (archetype->count >= archetype->chunkCount * COMPONENT_ARCHETYPE_CHUNK_CAPACITY) {
+        archetype->chunkCount++;
+        archetype->chunks = RBE_MEM_REALLOCATE(archetype->chunks, archetype->chunkCount * sizeof(char*));
+        // Zeroed so chunk change ticks start out older than any change
+        archetype->chunks[archetype->chunkCount - 1] = RBE_MEM_ALLOCATE_SIZE_ZERO(1, archetype->chunkSize);
+    }
+    const uint32_t row = (uint32_t) archetype->count++;
+    *component_archetype_get_entity(archetype, row) = entity;
+    return row;
+}
+
+void component_archetype_remove_row(ComponentArchetype* archetype, uint32_t row) {
+    const uint32_t lastRow = (uint32_t) --archetype->count;
+    if (row != lastRow) {
+        const Entity lastEntity = *component_archetype_get_entity(archetype, lastRow);
+        *component_archetype_get_entity(archetype, row) = lastEntity;
+        for (size_t i = 0; i < archetype->columnCount; i++) {
+            const ComponentDataIndex index = archetype->columnIndices[i];
+            memcpy(component_archetype_get_component(archetype, row, index), component_archetype_get_component(archetype, lastRow, index), componentManager->componentTypes[index].size);
+            component_archetype_set_change_tick(archetype, row, index, component_archetype_get_change_tick(archetype, lastRow, index));
+        }
+        componentManager->entityRecords[entity_get_index(lastEntity)].row = row;
+    }
+}
+
+// Components both archetypes have are carried over, the caller takes care of the rest
+void component_manager_move_entity(Entity entity, ComponentEntityRecord* record, uint32_t newArchetypeIndex) {
+    const ComponentArchetype* oldArchetype = componentManager->archetypes[record->archetypeIndex];
+    ComponentArchetype* newArchetype = componentManager->archetypes[newArchetypeIndex];
+    uint32_t newRow = 0;
+    if (newArchetypeIndex != COMPONENT_ARCHETYPE_EMPTY_INDEX) {
+        newRow = component_archetype_add_row(newArchetype, entity);
+    }
+    if (record->archetypeIndex != COMPONENT_ARCHETYPE_EMPTY_INDEX) {
+        for (size_t i = 0; i < newArchetype->columnCount; i++) {
+            const ComponentDataIndex index = newArchetype->columnIndices[i];
+            if (oldArchetype->columnOffsets[index] != COMPONENT_ARCHETYPE_NO_COLUMN) {
+                memcpy(component_archetype_get_component(newArchetype, newRow, index), component_archetype_get_component(oldArchetype, record->row, index), componentManager->componentTypes[index].size);
+                component_archetype_set_change_tick(newArchetype, newRow, index, component_archetype_get_change_tick(oldArchetype, record->row, index));
+            }
+        }
+        component_archetype_remove_row(componentManager->archetypes[record->archetypeIndex], record->row);
+    }
+    record->archetypeIndex = newArchetypeIndex;
+    record->row = newRow;
+}
 
 void component_manager_initialize() {
     RBE_ASSERT(componentManager == NULL);
     componentManager = RBE_MEM_ALLOCATE(ComponentManager);
-    for (int i = 0; i < MAX_ENTITIES; i++) {
-        componentManager->entityComponentArrays[i] = RBE_MEM_ALLOCATE(ComponentArray);
-        component_array_initialize(componentManager->entityComponentArrays[i]);
-        componentManager->entityComponentSignatures[i] = ComponentType_NONE;
+    componentManager->componentTypeCount = 0;
+    componentManager->archetypes = NULL;
+    componentManager->archetypeCount = 0;
+    componentManager->archetypeCapacity = 0;
+    componentManager->entityRecordsCapacity = COMPONENT_MANAGER_INITIAL_ENTITY_CAPACITY;
+    componentManager->entityRecords = RBE_MEM_ALLOCATE_SIZE_ZERO(COMPONENT_MANAGER_INITIAL_ENTITY_CAPACITY, sizeof(ComponentEntityRecord));
+    componentManager->queries = NULL;
+    componentManager->queryCount = 0;
+    componentManager->changeTick = 1; // Systems that haven't run yet have seen tick 0
+    const ComponentSignature emptySignature = { .bits = { 0 } };
+    // Empty archetype is created first so it always lives at 'COMPONENT_ARCHETYPE_EMPTY_INDEX'
+    const uint32_t emptyArchetypeIndex = component_manager_get_archetype(&emptySignature);
+    RBE_ASSERT(emptyArchetypeIndex == COMPONENT_ARCHETYPE_EMPTY_INDEX);
+    (void) emptyArchetypeIndex;
+    // Engine components, registered in the same order as 'ComponentDataIndex'
+#define COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(INDEX, NAME, TYPE)                                      \
+{                                                                                                          \
+const ComponentDataIndex registeredIndex = component_manager_register_component_type(NAME, sizeof(TYPE), _Alignof(TYPE), NULL); \
+RBE_ASSERT(registeredIndex == INDEX);                                                                      \
+(void) registeredIndex;                                                                                    \
+}
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_NODE, "Node", NodeComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_TRANSFORM_2D, "Transform2D", Transform2DComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_SPRITE, "Sprite", SpriteComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_ANIMATED_SPRITE, "Animated Sprite", AnimatedSpriteComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_TEXT_LABEL, "Text Label", TextLabelComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_SCRIPT, "Script", ScriptComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_COLLIDER_2D, "Collider2D", Collider2DComponent);
+    COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT(ComponentDataIndex_COLOR_SQUARE, "ColorSquare", ColorSquareComponent);
+#undef COMPONENT_MANAGER_REGISTER_ENGINE_COMPONENT
+}
+
+void component_manager_finalize() {
+    if (componentManager == NULL) {
+        return;
+    }
+    for (size_t archetypeIndex = 0; archetypeIndex < componentManager->archetypeCount; archetypeIndex++) {
+        ComponentArchetype* archetype = componentManager->archetypes[archetypeIndex];
+        for (size_t i = 0; i < archetype->columnCount; i++) {
+            const ComponentDataIndex index = archetype->columnIndices[i];
+            if (componentManager->componentTypes[index].destructor != NULL) {
+                for (uint32_t row = 0; row < archetype->count; row++) {
+                    componentManager->componentTypes[index].destructor(component_archetype_get_component(archetype, row, index));
+                }
+            }
+        }
+        for (size_t i = 0; i < archetype->chunkCount; i++) {
+            RBE_MEM_FREE(archetype->chunks[i]);
+        }
+        if (archetype->chunks != NULL) {
+            RBE_MEM_FREE(archetype->chunks);
+        }
+        RBE_MEM_FREE(archetype);
     }
+    for (size_t i = 0; i < componentManager->queryCount; i++) {
+        ComponentQuery* query = componentManager->queries[i];
+        if (query->archetypeIndices != NULL) {
+            RBE_MEM_FREE(query->archetypeIndices);
+        }
+        if (query->chunks != NULL) {
+            RBE_MEM_FREE(query->chunks);
+        }
+        RBE_MEM_FREE(query);
+    }
+    if (componentManager->queries != NULL) {
+        RBE_MEM_FREE(componentManager->queries);
+    }
+    RBE_MEM_FREE(componentManager->archetypes);
+    RBE_MEM_FREE(componentManager->entityRecords);
+    RBE_MEM_FREE(componentManager);
+    componentManager = NULL;
+}
+
+ComponentDataIndex component_manager_register_component_type(const char* name, size_t size, size_t alignment, ComponentDestructorFunc destructor) {
+    RBE_ASSERT_FMT(componentManager->componentTypeCount < MAX_COMPONENTS, "Reached max component types '%d', can't register '%s'!", MAX_COMPONENTS, name);
+    // Chunks come from the general allocator, so they're only aligned for fundamental types
+    RBE_ASSERT_FMT(alignment > 0 && (alignment & (alignment - 1)) == 0 && alignment <= _Alignof(max_align_t),
+                   "Component type '%s' has an unsupported alignment '%zu'!", name, alignment);
+    const ComponentDataIndex index = (ComponentDataIndex) componentManager->componentTypeCount++;
+    componentManager->componentTypes[index] = (ComponentTypeInfo) {
+        .name = name, .size = size, .stride = (size + alignment - 1) & ~(alignment - 1), .destructor = destructor
+    };
+    rbe_logger_debug("Registered component type '%s' with index '%d'", name, index);
+    return index;
 }
 
-void component_manager_finalize() {}
+size_t component_manager_get_component_type_count() {
+    return componentManager->componentTypeCount;
+}
+
+size_t component_manager_get_component_type_size(ComponentDataIndex index) {
+    return componentManager->componentTypes[index].size;
+}
 
 void* component_manager_get_component(Entity entity, ComponentDataIndex index) {
-    void* component = component_array_get_component(componentManager->entityComponentArrays[entity], index);
+    void* component = component_manager_get_component_unsafe(entity, index);
     RBE_ASSERT_FMT(component != NULL, "Entity '%d' doesn't have '%s' component!",
                    entity, component_get_component_data_index_string(index));
     return component;
 }
 
 void* component_manager_get_component_unsafe(Entity entity, ComponentDataIndex index) {
-    return component_array_get_component(componentManager->entityComponentArrays[entity], index);
+    const ComponentEntityRecord* record = component_manager_find_entity_record(entity);
+    if (record == NULL) {
+        return NULL;
+    }
+    const ComponentArchetype* archetype = componentManager->archetypes[record->archetypeIndex];
+    if (archetype->columnOffsets[index] == COMPONENT_ARCHETYPE_NO_COLUMN) {
+        return NULL;
+    }
+    return component_archetype_get_component(archetype, record->row, index);
+}
+
+void* component_manager_get_component_for_write(Entity entity, ComponentDataIndex index) {
+    void* component = component_manager_get_component(entity, index);
+    component_manager_mark_component_changed(entity, index);
+    return component;
+}
+
+void component_manager_mark_component_changed(Entity entity, ComponentDataIndex index) {
+    const ComponentEntityRecord* record = component_manager_find_entity_record(entity);
+    if (record != NULL && componentManager->archetypes[record->archetypeIndex]->columnOffsets[index] != COMPONENT_ARCHETYPE_NO_COLUMN) {
+        component_archetype_set_change_tick(componentManager->archetypes[record->archetypeIndex], record->row, index, componentManager->changeTick);
+    }
+}
+
+uint32_t component_manager_get_component_change_tick(Entity entity, ComponentDataIndex index) {
+    const ComponentEntityRecord* record = component_manager_find_entity_record(entity);
+    if (record == NULL || componentManager->archetypes[record->archetypeIndex]->columnOffsets[index] == COMPONENT_ARCHETYPE_NO_COLUMN) {
+        return 0;
+    }
+    return component_archetype_get_change_tick(componentManager->archetypes[record->archetypeIndex], record->row, index);
+}
+
+uint32_t component_manager_get_change_tick() {
+    return componentManager->changeTick;
 }
 
-void component_manager_set_component(Entity entity, ComponentDataIndex index, void* component) {
-    component_array_set_component(componentManager->entityComponentArrays[entity], index, component);
-    // Update signature
-    ComponentType componentSignature = component_manager_get_component_signature(entity);
-    componentSignature |= component_manager_translate_index_to_type(index);
-    component_manager_set_component_signature(entity, componentSignature);
+uint32_t component_manager_advance_change_tick() {
+    return ++componentManager->changeTick;
+}
+
+void* component_manager_set_component(Entity entity, ComponentDataIndex index, void* component) {
+    // Component is copied into its archetype, the passed in allocation is no longer needed
+    void* storedComponent = component_manager_copy_component(entity, index, component);
+    RBE_MEM_FREE(component);
+    return storedComponent;
+}
+
+void* component_manager_copy_component(Entity entity, ComponentDataIndex index, const void* component) {
+    ComponentEntityRecord* record = component_manager_get_entity_record(entity);
+    if (record->archetypeIndex != COMPONENT_ARCHETYPE_EMPTY_INDEX) {
+        RBE_ASSERT_FMT(*component_archetype_get_entity(componentManager->archetypes[record->archetypeIndex], record->row) == entity,
+                       "Entity '%u' is stale, can't set '%s' component!", entity, component_get_component_data_index_string(index));
+    }
+    const ComponentTypeInfo* componentType = &componentManager->componentTypes[index];
+    if (componentManager->archetypes[record->archetypeIndex]->columnOffsets[index] != COMPONENT_ARCHETYPE_NO_COLUMN) {
+        // Overwriting an existing component
+        char* storedComponent = component_archetype_get_component(componentManager->archetypes[record->archetypeIndex], record->row, index);
+        if (componentType->destructor != NULL) {
+            componentType->destructor(storedComponent);
+        }
+        memcpy(storedComponent, component, componentType->size);
+        component_archetype_set_change_tick(componentManager->archetypes[record->archetypeIndex], record->row, index, componentManager->changeTick);
+        return storedComponent;
+    }
+    component_manager_move_entity(entity, record, component_manager_get_archetype_edge(record->archetypeIndex, index, true));
+    char* storedComponent = component_archetype_get_component(componentManager->archetypes[record->archetypeIndex], record->row, index);
+    memcpy(storedComponent, component, componentType->size);
+    component_archetype_set_change_tick(componentManager->archetypes[record->archetypeIndex], record->row, index, componentManager->changeTick);
+    return storedComponent;
 }
 
 void component_manager_remove_component(Entity entity, ComponentDataIndex index) {
-    ComponentType componentSignature = component_manager_get_component_signature(entity);
-    componentSignature &= component_manager_translate_index_to_type(index);
-    component_manager_set_component_signature(entity, componentSignature);
-    component_array_remove_component(componentManager->entityComponentArrays[entity], index);
+    void* storedComponent = component_manager_get_component_unsafe(entity, index);
+    if (storedComponent == NULL) {
+        return;
+    }
+    if (componentManager->componentTypes[index].destructor != NULL) {
+        componentManager->componentTypes[index].destructor(storedComponent);
+    }
+    ComponentEntityRecord* record = component_manager_get_entity_record(entity);
+    component_manager_move_entity(entity, record, component_manager_get_archetype_edge(record->archetypeIndex, index, false));
 }
 
 void component_manager_remove_all_components(Entity entity) {
-    component_array_remove_all_components(componentManager->entityComponentArrays[entity]);
+    if (component_manager_find_entity_record(entity) == NULL) {
+        return;
+    }
+    ComponentEntityRecord* record = component_manager_get_entity_record(entity);
+    ComponentArchetype* archetype = componentManager->archetypes[record->archetypeIndex];
+    for (size_t i = 0; i < archetype->columnCount; i++) {
+        const ComponentDataIndex index = archetype->columnIndices[i];
+        if (componentManager->componentTypes[index].destructor != NULL) {
+            componentManager->componentTypes[index].destructor(component_archetype_get_component(archetype, record->row, index));
+        }
+    }
+    component_archetype_remove_row(archetype, record->row);
+    record->archetypeIndex = COMPONENT_ARCHETYPE_EMPTY_INDEX;
+    record->row = 0;
 }
 
 bool component_manager_has_component(Entity entity, ComponentDataIndex index) {
-    return component_array_has_component(componentManager->entityComponentArrays[entity], index);
-}
-
-void component_manager_set_component_signature(Entity entity, ComponentType componentTypeSignature) {
-    componentManager->entityComponentSignatures[entity] = componentTypeSignature;
-}
-
-ComponentType component_manager_get_component_signature(Entity entity) {
-    return componentManager->entityComponentSignatures[entity];
-}
-
-ComponentType component_manager_translate_index_to_type(ComponentDataIndex index) {
-    switch (index) {
-    case ComponentDataIndex_NODE:
-        return ComponentType_NODE;
-    case ComponentDataIndex_TRANSFORM_2D:
-        return ComponentType_TRANSFORM_2D;
-    case ComponentDataIndex_SPRITE:
-        return ComponentType_SPRITE;
-    case ComponentDataIndex_ANIMATED_SPRITE:
-        return ComponentType_ANIMATED_SPRITE;
-    case ComponentDataIndex_TEXT_LABEL:
-        return ComponentType_TEXT_LABEL;
-    case ComponentDataIndex_SCRIPT:
-        return ComponentType_SCRIPT;
-    case ComponentDataIndex_COLLIDER_2D:
-        return ComponentType_COLLIDER_2D;
-    case ComponentDataIndex_COLOR_SQUARE:
-        return ComponentType_COLOR_SQUARE;
-    case ComponentDataIndex_NONE:
-    default:
-        rbe_logger_error("Not a valid component data index: '%d'", index);
-        return ComponentType_NONE;
+    return component_manager_get_component_unsafe(entity, index) != NULL;
+}
+
+ComponentSignature component_manager_get_component_signature(Entity entity) {
+    const ComponentEntityRecord* record = component_manager_find_entity_record(entity);
+    if (record == NULL) {
+        return (ComponentSignature) { .bits = { 0 } };
+    }
+    return componentManager->archetypes[record->archetypeIndex]->signature;
+}
+
+//--- Component Block ---//
+static inline size_t component_block_align(size_t offset) {
+    return (offset + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+size_t component_manager_get_component_block_size(const ComponentSignature* signature) {
+    size_t blockSize = 0;
+    for (size_t i = 0; i < componentManager->componentTypeCount; i++) {
+        if (component_signature_has(signature, (ComponentDataIndex) i)) {
+            blockSize = component_block_align(blockSize) + componentManager->componentTypes[i].size;
+        }
+    }
+    return blockSize;
+}
+
+void* component_block_get_component(void* block, const ComponentSignature* signature, ComponentDataIndex index) {
+    RBE_ASSERT_FMT(component_signature_has(signature, index), "Component block doesn't have '%s' component!", component_get_component_data_index_string(index));
+    size_t offset = 0;
+    for (size_t i = 0; i < (size_t) index; i++) {
+        if (component_signature_has(signature, (ComponentDataIndex) i)) {
+            offset = component_block_align(offset) + componentManager->componentTypes[i].size;
+        }
+    }
+    return (char*) block + component_block_align(offset);
+}
+
+ComponentSignature component_manager_copy_component_block(Entity entity, void* block) {
+    const ComponentEntityRecord* record = component_manager_find_entity_record(entity);
+    if (record == NULL) {
+        return (ComponentSignature) { .bits = { 0 } };
+    }
+    const ComponentArchetype* archetype = componentManager->archetypes[record->archetypeIndex];
+    size_t offset = 0;
+    for (size_t i = 0; i < archetype->columnCount; i++) {
+        const ComponentDataIndex index = archetype->columnIndices[i];
+        offset = component_block_align(offset);
+        memcpy((char*) block + offset, component_archetype_get_component(archetype, record->row, index), componentManager->componentTypes[index].size);
+        offset += componentManager->componentTypes[index].size;
+    }
+    return archetype->signature;
+}
+
+void component_manager_set_component_block(Entity entity, const ComponentSignature* signature, const void* block) {
+    RBE_ASSERT_FMT(component_manager_find_entity_record(entity) == NULL, "Entity '%u' already has components, can't set a component block!", entity);
+    ComponentEntityRecord* record = component_manager_get_entity_record(entity);
+    record->archetypeIndex = component_manager_get_archetype(signature);
+    if (record->archetypeIndex == COMPONENT_ARCHETYPE_EMPTY_INDEX) {
+        record->row = 0;
+        return;
+    }
+    ComponentArchetype* archetype = componentManager->archetypes[record->archetypeIndex];
+    record->row = component_archetype_add_row(archetype, entity);
+    size_t offset = 0;
+    for (size_t i = 0; i < archetype->columnCount; i++) {
+        const ComponentDataIndex index = archetype->columnIndices[i];
+        offset = component_block_align(offset);
+        memcpy(component_archetype_get_component(archetype, record->row, index), (const char*) block + offset, componentManager->componentTypes[index].size);
+        component_archetype_set_change_tick(archetype, record->row, index, componentManager->changeTick);
+        offset += componentManager->componentTypes[index].size;
+    }
+}
+
+//--- Component Query ---//
+void component_query_add_archetype(ComponentQuery* query, uint32_t archetypeIndex) {
+    if (archetypeIndex == COMPONENT_ARCHETYPE_EMPTY_INDEX || !component_signature_matches(&componentManager->archetypes[archetypeIndex]->signature, &query->signature)) {
+        return;
     }
+    if (query->archetypeCount >= query->archetypeCapacity) {
+        query->archetypeCapacity = query->archetypeCapacity == 0 ? 8 : query->archetypeCapacity * 2;
+        query->archetypeIndices = RBE_MEM_REALLOCATE(query->archetypeIndices, query->archetypeCapacity * sizeof(uint32_t));
+    }
+    query->archetypeIndices[query->archetypeCount++] = archetypeIndex;
+}
+
+ComponentQuery* component_manager_query(ComponentSignature signature) {
+    ComponentQuery* query = RBE_MEM_ALLOCATE(ComponentQuery);
+    query->signature = signature;
+    query->archetypeIndices = NULL;
+    query->archetypeCount = 0;
+    query->archetypeCapacity = 0;
+    query->chunks = NULL;
+    query->chunkCapacity = 0;
+    for (size_t i = 0; i < componentManager->archetypeCount; i++) {
+        component_query_add_archetype(query, (uint32_t) i);
+    }
+    componentManager->queries = RBE_MEM_REALLOCATE(componentManager->queries, (componentManager->queryCount + 1) * sizeof(ComponentQuery*));
+    componentManager->queries[componentManager->queryCount++] = query;
+    return query;
+}
+
+const ComponentQueryChunk* component_query_get_chunks(ComponentQuery* query, size_t* chunkCount) {
+    size_t count = 0;
+    for (size_t i = 0; i < query->archetypeCount; i++) {
+        const ComponentArchetype* archetype = componentManager->archetypes[query->archetypeIndices[i]];
+        for (size_t chunkIndex = 0; chunkIndex * COMPONENT_ARCHETYPE_CHUNK_CAPACITY < archetype->count; chunkIndex++) {
+            if (count >= query->chunkCapacity) {
+                query->chunkCapacity = query->chunkCapacity == 0 ? 16 : query->chunkCapacity * 2;
+                query->chunks = RBE_MEM_REALLOCATE(query->chunks, query->chunkCapacity * sizeof(ComponentQueryChunk));
+            }
+            const size_t remainingRows = archetype->count - chunkIndex * COMPONENT_ARCHETYPE_CHUNK_CAPACITY;
+            query->chunks[count++] = (ComponentQueryChunk) {
+                .archetype = archetype,
+                .data = archetype->chunks[chunkIndex],
+                .entities = (const Entity*) archetype->chunks[chunkIndex],
+                .count = remainingRows < COMPONENT_ARCHETYPE_CHUNK_CAPACITY ? remainingRows : COMPONENT_ARCHETYPE_CHUNK_CAPACITY
+            };
+        }
+    }
+    *chunkCount = count;
+    return query->chunks;
+}
+
+void* component_query_chunk_get_components(const ComponentQueryChunk* chunk, ComponentDataIndex index) {
+    RBE_ASSERT_FMT(chunk->archetype->columnOffsets[index] != COMPONENT_ARCHETYPE_NO_COLUMN, "Query chunk doesn't have '%s' components!", component_get_component_data_index_string(index));
+    return chunk->data + chunk->archetype->columnOffsets[index];
+}
+
+const uint32_t* component_query_chunk_get_change_ticks(const ComponentQueryChunk* chunk, ComponentDataIndex index) {
+    RBE_ASSERT_FMT(chunk->archetype->changeTickOffsets[index] != COMPONENT_ARCHETYPE_NO_COLUMN, "Query chunk doesn't have '%s' components!", component_get_component_data_index_string(index));
+    return (const uint32_t*) (chunk->data + chunk->archetype->changeTickOffsets[index]);
+}
+
+bool component_query_chunk_has_changed(const ComponentQueryChunk* chunk, ComponentDataIndex index, uint32_t sinceTick) {
+    return component_query_chunk_get_change_ticks(chunk, index)[COMPONENT_ARCHETYPE_CHUNK_CAPACITY] > sinceTick;
 }
 
 const char* component_get_component_data_index_string(ComponentDataIndex index) {
-    switch (index) {
-    case ComponentDataIndex_NODE:
-        return "Node";
-    case ComponentDataIndex_TRANSFORM_2D:
-        return "Transform2D";
-    case ComponentDataIndex_SPRITE:
-        return "Sprite";
-    case ComponentDataIndex_ANIMATED_SPRITE:
-        return "Animated Sprite";
-    case ComponentDataIndex_TEXT_LABEL:
-        return "Text Label";
-    case ComponentDataIndex_SCRIPT:
-        return "Script";
-    case ComponentDataIndex_COLLIDER_2D:
-        return "Collider2D";
-    case ComponentDataIndex_COLOR_SQUARE:
-        return "ColorSquare";
-    case ComponentDataIndex_NONE:
-    default:
+    if (index < 0 || (size_t) index >= componentManager->componentTypeCount) {
         rbe_logger_error("Not a valid component data index: '%d'", index);
         return "NONE";
     }
-    return "INVALID";
+    return componentManager->componentTypes[index].name;
 }
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "../entity/entity.h"
 
-#define MAX_COMPONENTS 8
+#define MAX_COMPONENTS 128
+#define COMPONENT_SIGNATURE_WORD_COUNT (MAX_COMPONENTS / 64)
 
+// Indices of the engine's own components, other component types are registered at runtime and get the following indices
 typedef enum ComponentDataIndex {
     ComponentDataIndex_NONE = -1,
     ComponentDataIndex_NODE = 0,
@@ -18,6 +22,7 @@ typedef enum ComponentDataIndex {
     ComponentDataIndex_COLOR_SQUARE = 7,
 } ComponentDataIndex;
 
+// Bit flags of the engine's components, used to build signatures with 'component_signature_create'
 typedef enum ComponentType {
     ComponentType_NONE = 0,
     ComponentType_NODE = 1 << 0,
@@ -30,16 +35,123 @@ typedef enum ComponentType {
     ComponentType_COLOR_SQUARE = 1 << 7,
 } ComponentType;
 
+// --- Component Signature --- //
+// Bitset with a bit per registered component type
+typedef struct ComponentSignature {
+    uint64_t bits[COMPONENT_SIGNATURE_WORD_COUNT];
+} ComponentSignature;
+
+static inline ComponentSignature component_signature_create(ComponentType engineComponentTypes) {
+    ComponentSignature signature = { .bits = { 0 } };
+    signature.bits[0] = (uint64_t) engineComponentTypes;
+    return signature;
+}
+
+static inline void component_signature_add(ComponentSignature* signature, ComponentDataIndex index) {
+    signature->bits[index / 64] |= (uint64_t) 1 << (index % 64);
+}
+
+static inline void component_signature_remove(ComponentSignature* signature, ComponentDataIndex index) {
+    signature->bits[index / 64] &= ~((uint64_t) 1 << (index % 64));
+}
+
+static inline bool component_signature_has(const ComponentSignature* signature, ComponentDataIndex index) {
+    return (signature->bits[index / 64] & ((uint64_t) 1 << (index % 64))) != 0;
+}
+
+static inline ComponentSignature component_signature_create_full() {
+    ComponentSignature signature;
+    for (size_t i = 0; i < COMPONENT_SIGNATURE_WORD_COUNT; i++) {
+        signature.bits[i] = UINT64_MAX;
+    }
+    return signature;
+}
+
+static inline bool component_signature_intersects(const ComponentSignature* signatureA, const ComponentSignature* signatureB) {
+    for (size_t i = 0; i < COMPONENT_SIGNATURE_WORD_COUNT; i++) {
+        if ((signatureA->bits[i] & signatureB->bits[i]) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if 'signature' has every component in 'mask'
+static inline bool component_signature_matches(const ComponentSignature* signature, const ComponentSignature* mask) {
+    for (size_t i = 0; i < COMPONENT_SIGNATURE_WORD_COUNT; i++) {
+        if ((signature->bits[i] & mask->bits[i]) != mask->bits[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // --- Component Manager --- //
+typedef void (*ComponentDestructorFunc) (void*); // Releases anything the component owns, not the component itself
+
 void component_manager_initialize();
 void component_manager_finalize();
+// Registers a new component type and returns its index, engine components are registered on initialize
+ComponentDataIndex component_manager_register_component_type(const char* name, size_t size, size_t alignment, ComponentDestructorFunc destructor);
+size_t component_manager_get_component_type_count();
+size_t component_manager_get_component_type_size(ComponentDataIndex index);
 void* component_manager_get_component(Entity entity, ComponentDataIndex index);
 void* component_manager_get_component_unsafe(Entity entity, ComponentDataIndex index); // No check, will probably consolidate later...
-void component_manager_set_component(Entity entity, ComponentDataIndex index, void* component);
+// Same as get but marks the component as changed, use when modifying a component outside of the system that owns it
+void* component_manager_get_component_for_write(Entity entity, ComponentDataIndex index);
+// Copies the created component into its archetype and frees 'component', returns the stored component.
+// Stored component pointers stay valid until a component is added to or removed from any entity of the same archetype.
+void* component_manager_set_component(Entity entity, ComponentDataIndex index, void* component);
+// Same as set but leaves the passed in component to the caller
+void* component_manager_copy_component(Entity entity, ComponentDataIndex index, const void* component);
 void component_manager_remove_component(Entity entity, ComponentDataIndex index);
 void component_manager_remove_all_components(Entity entity);
 bool component_manager_has_component(Entity entity, ComponentDataIndex index);
-void component_manager_set_component_signature(Entity entity, ComponentType componentTypeSignature);
-ComponentType component_manager_get_component_signature(Entity entity);
+ComponentSignature component_manager_get_component_signature(Entity entity);
+
+// --- Change Tracking --- //
+// Components remember the change tick they were last set or written at.  The tick is advanced on the main thread
+// between system waves, so something that last looked at tick 'n' only has to look at components with a tick above 'n'.
+// Ticks of carried over components are kept when an entity moves archetypes.
+void component_manager_mark_component_changed(Entity entity, ComponentDataIndex index);
+uint32_t component_manager_get_component_change_tick(Entity entity, ComponentDataIndex index); // 0 if the entity doesn't have the component
+uint32_t component_manager_get_change_tick();
+uint32_t component_manager_advance_change_tick(); // Returns the new tick
 
 const char* component_get_component_data_index_string(ComponentDataIndex index);
+
+// --- Component Block --- //
+// Copy of all of an entity's components packed in index order, used to clone entities in a single archetype move
+// instead of one per component.  Components are copied as is, anything they point to is shared.
+size_t component_manager_get_component_block_size(const ComponentSignature* signature);
+void* component_block_get_component(void* block, const ComponentSignature* signature, ComponentDataIndex index);
+// Copies the entity's components into 'block' and returns their signature
+ComponentSignature component_manager_copy_component_block(Entity entity, void* block);
+// Adds every component in the block to an entity that doesn't have any components yet
+void component_manager_set_component_block(Entity entity, const ComponentSignature* signature, const void* block);
+
+// --- Component Query --- //
+// Entities with the same set of components share an archetype and are stored together in chunks, a query hands back
+// the chunks of every archetype with the queried components so systems loop over contiguous component arrays.
+#define COMPONENT_ARCHETYPE_CHUNK_CAPACITY 128
+
+typedef struct ComponentArchetype ComponentArchetype;
+typedef struct ComponentQuery ComponentQuery;
+
+typedef struct ComponentQueryChunk {
+    const ComponentArchetype* archetype;
+    char* data;
+    const Entity* entities;
+    size_t count;
+} ComponentQueryChunk;
+
+// Queries are kept up to date as archetypes are created and live until finalize, create them once up front
+ComponentQuery* component_manager_query(ComponentSignature signature);
+// Chunks are only valid until the next structural change, one caller per query at a time
+const ComponentQueryChunk* component_query_get_chunks(ComponentQuery* query, size_t* chunkCount);
+// Array of the chunk's components of a type, indexed the same as the chunk's entities
+void* component_query_chunk_get_components(const ComponentQueryChunk* chunk, ComponentDataIndex index);
+// Change tick of each of the chunk's components of a type
+const uint32_t* component_query_chunk_get_change_ticks(const ComponentQueryChunk* chunk, ComponentDataIndex index);
+// True if any component of a type in the chunk may have changed after 'sinceTick', lets unchanged chunks be skipped
+bool component_query_chunk_has_changed(const ComponentQueryChunk* chunk, ComponentDataIndex index, uint32_t sinceTick);
@@ -6,7 +6,7 @@
 
 NodeComponent* node_component_create() {
     NodeComponent* nodeComponent = RBE_MEM_ALLOCATE(NodeComponent);
-    nodeComponent->name[0] = '\0';
+    nodeComponent->name = RBE_STRING_ID_NONE;
     nodeComponent->type = NodeBaseType_INVALID;
     return nodeComponent;
 }
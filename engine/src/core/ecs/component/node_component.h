@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../../utils/rbe_string_intern.h"
+
 #define RBE_NODE_NODE_STRING "Node"
 #define RBE_NODE_NODE2D_STRING "Node2D"
 #define RBE_NODE_SPRITE_STRING "Sprite"
@@ -31,7 +33,7 @@ typedef enum NodeBaseInheritanceType {
 } NodeBaseInheritanceType;
 
 typedef struct NodeComponent {
-    char name[32];
+    StringId name; // Interned
     NodeBaseType type;
 } NodeComponent;
 
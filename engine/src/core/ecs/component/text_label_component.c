@@ -1,6 +1,7 @@
 #include "text_label_component.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "../../memory/rbe_mem.h"
 
@@ -9,5 +10,15 @@ TextLabelComponent* text_label_component_create() {
     textLabelComponent->font = NULL;
     textLabelComponent->color = rbe_color_get_white();
     textLabelComponent->text[0] = '\0';
+    font_text_mesh_initialize(&textLabelComponent->textMesh);
     return textLabelComponent;
 }
+
+void text_label_component_set_text(TextLabelComponent* textLabelComponent, const char* text) {
+    if (strcmp(textLabelComponent->text, text) == 0) {
+        return;
+    }
+    strncpy(textLabelComponent->text, text, TEXT_LABEL_BUFFER_SIZE - 1);
+    textLabelComponent->text[TEXT_LABEL_BUFFER_SIZE - 1] = '\0';
+    textLabelComponent->textMesh.isDirty = true;
+}
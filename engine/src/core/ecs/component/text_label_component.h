@@ -9,6 +9,9 @@ typedef struct TextLabelComponent {
     Font* font;
     Color color;
     char text[TEXT_LABEL_BUFFER_SIZE];
+    FontTextMesh textMesh; // Cached glyph layout of 'text'
 } TextLabelComponent;
 
 TextLabelComponent* text_label_component_create();
+// Text should only be changed through here so the cached text mesh is rebuilt
+void text_label_component_set_text(TextLabelComponent* textLabelComponent, const char* text);
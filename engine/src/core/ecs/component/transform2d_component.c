@@ -19,6 +19,7 @@ TransformModel2D transform2d_component_create_blank_global_transform2d() {
         .rotation = 0.0f,
         .scaleSign = { .x = 1.0f, .y = 1.0f }
     };
+    rbe_math_affine2d_identity(&transform2D.model);
     return transform2D;
 }
 
@@ -30,32 +31,14 @@ Transform2DComponent* transform2d_component_create() {
     transform2DComponent->isZIndexRelativeToParent = true;
     transform2DComponent->ignoreCamera = false;
     transform2DComponent->isGlobalTransformDirty = true; // Starts dirty to calculate on first pull
+    transform2DComponent->globalBounds = (Rect2) { 0.0f, 0.0f, 0.0f, 0.0f };
+    transform2DComponent->boundsLocalRect = (Rect2) { 0.0f, 0.0f, 0.0f, 0.0f };
+    transform2DComponent->isGlobalBoundsDirty = true;
     return transform2DComponent;
 }
 
-void transform2d_component_get_local_model_matrix(mat4 model, Transform2DComponent* transform2DComponent) {
-    glm_mat4_identity(model);
-    // 1. Translation
-    glm_translate(model, (vec3) {
-        transform2DComponent->localTransform.position.x, transform2DComponent->localTransform.position.y, 0.0f
-    });
-    // 2. Rotation
-    float rotation = transform2DComponent->localTransform.rotation;
-    glm_make_rad(&rotation);
-    glm_rotate(model, rotation, (vec3) {
-        0.0f, 0.0f, 1.0f
-    });
-    // 3. Scaling
-    glm_scale(model, (vec3) {
-        transform2DComponent->localTransform.scale.x, transform2DComponent->localTransform.scale.y, 1.0f
-    });
-}
-
-float transform2d_component_get_rotation_deg_from_model(mat4 model) {
-    versor quat;
-    glm_mat4_quat(model, quat);
-    const float angleRadians = glm_quat_angle(quat);
-    return glm_deg(angleRadians);
+void transform2d_component_get_local_model(Affine2D* model, const Transform2DComponent* transform2DComponent) {
+    rbe_math_affine2d_from_trs(model, &transform2DComponent->localTransform.position, transform2DComponent->localTransform.rotation, &transform2DComponent->localTransform.scale);
 }
 
 void transform2d_component_print(Transform2DComponent* transform2DComponent) {
@@ -14,9 +14,12 @@ typedef struct Transform2DComponent {
     bool isZIndexRelativeToParent;
     bool ignoreCamera;
     bool isGlobalTransformDirty;
+    // World space bounds of 'boundsLocalRect', cached until the global transform or local rect changes
+    Rect2 globalBounds;
+    Rect2 boundsLocalRect;
+    bool isGlobalBoundsDirty;
 } Transform2DComponent;
 
 Transform2DComponent* transform2d_component_create();
-void transform2d_component_get_local_model_matrix(mat4 model, Transform2DComponent* transform2DComponent);
-float transform2d_component_get_rotation_deg_from_model(mat4 model);
+void transform2d_component_get_local_model(Affine2D* model, const Transform2DComponent* transform2DComponent);
 void transform2d_component_print(Transform2DComponent* transform2DComponent);
@@ -0,0 +1,159 @@
+#include "ecs_command_buffer.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "system/ec_system.h"
+#include "../scene/scene_manager.h"
+#include "../memory/rbe_mem.h"
+#include "../thread/rbe_pthread.h"
+#include "../utils/logger.h"
+#include "../utils/rbe_assert.h"
+
+#define ECS_COMMAND_BUFFER_INITIAL_CAPACITY 1024
+#define ECS_COMMAND_BUFFER_MAX_THREADS 64
+
+typedef enum EcsCommandType {
+    EcsCommandType_CREATE_ENTITY = 0,
+    EcsCommandType_DESTROY_ENTITY = 1,
+    EcsCommandType_SET_COMPONENT = 2,
+    EcsCommandType_REMOVE_COMPONENT = 3,
+} EcsCommandType;
+
+// Commands are packed back to back, set component commands are followed by the component's data
+typedef struct EcsCommand {
+    EcsCommandType type;
+    Entity entity;
+    ComponentDataIndex componentIndex;
+    size_t size; // Including the component data, padded so the next command stays aligned
+} EcsCommand;
+
+typedef struct EcsCommandBuffer {
+    char* data;
+    size_t size;
+    size_t capacity;
+} EcsCommandBuffer;
+
+// Buffers are created the first time a thread records and kept until finalize
+static EcsCommandBuffer* threadCommandBuffers[ECS_COMMAND_BUFFER_MAX_THREADS];
+static size_t threadCommandBufferCount = 0;
+static pthread_mutex_t threadCommandBuffersMutex;
+static RBE_THREAD_LOCAL EcsCommandBuffer* currentThreadCommandBuffer = NULL;
+// Bumped on every initialize, thread buffers from an earlier initialize were freed by finalize and are replaced
+static uint32_t commandBufferGeneration = 0;
+static RBE_THREAD_LOCAL uint32_t currentThreadCommandBufferGeneration = 0;
+
+EcsCommand* ecs_command_buffer_push_command(EcsCommandType type, Entity entity, ComponentDataIndex componentIndex, size_t dataSize);
+
+void rbe_ecs_command_buffer_initialize() {
+    pthread_mutex_init(&threadCommandBuffersMutex, NULL);
+    threadCommandBufferCount = 0;
+    commandBufferGeneration++;
+}
+
+void rbe_ecs_command_buffer_finalize() {
+    for (size_t i = 0; i < threadCommandBufferCount; i++) {
+        if (threadCommandBuffers[i]->size > 0) {
+            rbe_logger_warn("Dropping '%zu' bytes of ecs commands that were never played back!", threadCommandBuffers[i]->size);
+        }
+        RBE_MEM_FREE(threadCommandBuffers[i]->data);
+        RBE_MEM_FREE(threadCommandBuffers[i]);
+        threadCommandBuffers[i] = NULL;
+    }
+    threadCommandBufferCount = 0;
+    currentThreadCommandBuffer = NULL;
+    pthread_mutex_destroy(&threadCommandBuffersMutex);
+}
+
+Entity rbe_ecs_command_buffer_create_entity() {
+    const Entity entity = rbe_ec_system_create_entity();
+    ecs_command_buffer_push_command(EcsCommandType_CREATE_ENTITY, entity, 0, 0);
+    return entity;
+}
+
+void rbe_ecs_command_buffer_destroy_entity(Entity entity) {
+    ecs_command_buffer_push_command(EcsCommandType_DESTROY_ENTITY, entity, 0, 0);
+}
+
+void rbe_ecs_command_buffer_set_component(Entity entity, ComponentDataIndex index, void* component) {
+    const size_t componentSize = component_manager_get_component_type_size(index);
+    EcsCommand* command = ecs_command_buffer_push_command(EcsCommandType_SET_COMPONENT, entity, index, componentSize);
+    memcpy(command + 1, component, componentSize);
+    RBE_MEM_FREE(component);
+}
+
+void rbe_ecs_command_buffer_remove_component(Entity entity, ComponentDataIndex index) {
+    ecs_command_buffer_push_command(EcsCommandType_REMOVE_COMPONENT, entity, index, 0);
+}
+
+void rbe_ecs_command_buffer_playback() {
+    for (size_t bufferIndex = 0; bufferIndex < threadCommandBufferCount; bufferIndex++) {
+        EcsCommandBuffer* commandBuffer = threadCommandBuffers[bufferIndex];
+        size_t offset = 0;
+        while (offset < commandBuffer->size) {
+            const EcsCommand* command = (EcsCommand*) &commandBuffer->data[offset];
+            offset += command->size;
+            // Commands for an entity destroyed earlier in the frame are dropped
+            if (!rbe_ec_system_is_entity_alive(command->entity)) {
+                continue;
+            }
+            switch (command->type) {
+            case EcsCommandType_CREATE_ENTITY:
+                break;
+            case EcsCommandType_DESTROY_ENTITY:
+                if (rbe_scene_manager_has_entity_tree_node(command->entity)) {
+                    rbe_queue_destroy_tree_node_entity_all(command->entity);
+                } else {
+                    rbe_ec_system_remove_entity_from_all_systems(command->entity);
+                    component_manager_remove_all_components(command->entity);
+                    rbe_ec_system_destroy_entity(command->entity);
+                }
+                break;
+            case EcsCommandType_SET_COMPONENT:
+                component_manager_copy_component(command->entity, command->componentIndex, command + 1);
+                break;
+            case EcsCommandType_REMOVE_COMPONENT:
+                component_manager_remove_component(command->entity, command->componentIndex);
+                break;
+            }
+            // Systems are updated once per run of commands for the same entity
+            const bool isLastForEntity = offset >= commandBuffer->size || ((EcsCommand*) &commandBuffer->data[offset])->entity != command->entity;
+            if (isLastForEntity && (command->type == EcsCommandType_SET_COMPONENT || command->type == EcsCommandType_REMOVE_COMPONENT)) {
+                rbe_ec_system_update_entity_signature_with_systems(command->entity);
+            }
+        }
+        commandBuffer->size = 0;
+    }
+}
+
+EcsCommand* ecs_command_buffer_push_command(EcsCommandType type, Entity entity, ComponentDataIndex componentIndex, size_t dataSize) {
+    if (currentThreadCommandBuffer == NULL || currentThreadCommandBufferGeneration != commandBufferGeneration) {
+        pthread_mutex_lock(&threadCommandBuffersMutex);
+        RBE_ASSERT_FMT(threadCommandBufferCount < ECS_COMMAND_BUFFER_MAX_THREADS, "Reached max ecs command buffer threads '%d'!", ECS_COMMAND_BUFFER_MAX_THREADS);
+        currentThreadCommandBuffer = RBE_MEM_ALLOCATE(EcsCommandBuffer);
+        currentThreadCommandBuffer->data = NULL;
+        currentThreadCommandBuffer->size = 0;
+        currentThreadCommandBuffer->capacity = 0;
+        threadCommandBuffers[threadCommandBufferCount++] = currentThreadCommandBuffer;
+        currentThreadCommandBufferGeneration = commandBufferGeneration;
+        pthread_mutex_unlock(&threadCommandBuffersMutex);
+    }
+    EcsCommandBuffer* commandBuffer = currentThreadCommandBuffer;
+    const size_t alignment = _Alignof(max_align_t);
+    const size_t commandSize = (sizeof(EcsCommand) + dataSize + alignment - 1) & ~(alignment - 1);
+    if (commandBuffer->size + commandSize > commandBuffer->capacity) {
+        size_t newCapacity = commandBuffer->capacity == 0 ? ECS_COMMAND_BUFFER_INITIAL_CAPACITY : commandBuffer->capacity * 2;
+        while (newCapacity < commandBuffer->size + commandSize) {
+            newCapacity *= 2;
+        }
+        commandBuffer->data = RBE_MEM_REALLOCATE(commandBuffer->data, newCapacity);
+        commandBuffer->capacity = newCapacity;
+    }
+    EcsCommand* command = (EcsCommand*) &commandBuffer->data[commandBuffer->size];
+    command->type = type;
+    command->entity = entity;
+    command->componentIndex = componentIndex;
+    command->size = commandSize;
+    commandBuffer->size += commandSize;
+    return command;
+}
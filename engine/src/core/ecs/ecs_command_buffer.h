@@ -0,0 +1,18 @@
+#pragma once
+
+#include "component/component.h"
+
+// Records structural changes (creating and destroying entities, setting and removing components) instead of making them
+// right away so systems and scripts running on worker threads don't touch the component store.  Each thread records into
+// its own buffer, 'rbe_update' plays all of them back on the main thread before processing the scene queues.
+void rbe_ecs_command_buffer_initialize();
+void rbe_ecs_command_buffer_finalize();
+// The handle is reserved right away, the entity has no components until the buffer is played back
+Entity rbe_ecs_command_buffer_create_entity();
+// Entities in the scene tree are queued for deletion along with their children
+void rbe_ecs_command_buffer_destroy_entity(Entity entity);
+// Copies the component and frees it, same as 'component_manager_set_component'
+void rbe_ecs_command_buffer_set_component(Entity entity, ComponentDataIndex index, void* component);
+void rbe_ecs_command_buffer_remove_component(Entity entity, ComponentDataIndex index);
+// Main thread only, no other thread may be recording
+void rbe_ecs_command_buffer_playback();
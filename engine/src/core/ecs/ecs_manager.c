@@ -2,6 +2,7 @@
 
 #include <string.h>
 
+#include "ecs_command_buffer.h"
 #include "component/component.h"
 #include "component/transform2d_component.h"
 #include "component/text_label_component.h"
@@ -23,6 +24,7 @@
 void rbe_ecs_manager_initialize() {
     component_manager_initialize();
     rbe_ec_system_initialize();
+    rbe_ecs_command_buffer_initialize();
     // Initialize and register ec systems
     rbe_ec_system_register(sprite_rendering_ec_system_create());
     rbe_ec_system_register(animated_sprite_rendering_ec_system_create());
@@ -37,8 +39,8 @@ void rbe_ecs_manager_enable_fps_display_entity(bool enabled) {
     static Entity currentFpsEntity = NULL_ENTITY;
     // Create temp entity
     if (!isEnabled && enabled) {
-        SceneTreeNode* node = rbe_scene_tree_create_tree_node(rbe_ec_system_create_entity(), NULL);
-        currentFpsEntity = node->entity;
+        currentFpsEntity = rbe_ec_system_create_entity();
+        rbe_scene_tree_create_tree_node(currentFpsEntity, NULL_ENTITY);
         // Transform 2D
         Transform2DComponent* transform2DComponent = transform2d_component_create();
         transform2DComponent->localTransform.position.x = 20.0f;
@@ -48,7 +50,7 @@ void rbe_ecs_manager_enable_fps_display_entity(bool enabled) {
         // Text Label Component
         TextLabelComponent* textLabelComponent = text_label_component_create();
         textLabelComponent->font = rbe_asset_manager_get_font("verdana-32");
-        strcpy(textLabelComponent->text, "FPS: ");
+        text_label_component_set_text(textLabelComponent, "FPS: ");
         component_manager_set_component(currentFpsEntity, ComponentDataIndex_TEXT_LABEL, textLabelComponent);
         // Script Component
         ScriptComponent* scriptComponent = script_component_create();
@@ -58,7 +60,7 @@ void rbe_ecs_manager_enable_fps_display_entity(bool enabled) {
         component_manager_set_component(currentFpsEntity, ComponentDataIndex_SCRIPT, scriptComponent);
         // Update systems
         rbe_ec_system_update_entity_signature_with_systems(currentFpsEntity);
-        rbe_scene_manager_queue_entity_for_creation(node);
+        rbe_scene_manager_queue_entity_for_creation(currentFpsEntity);
     } else if (isEnabled && !enabled) {
         RBE_ASSERT(currentFpsEntity != NULL_ENTITY);
         rbe_scene_manager_queue_entity_for_deletion(currentFpsEntity);
@@ -68,6 +70,7 @@ void rbe_ecs_manager_enable_fps_display_entity(bool enabled) {
 }
 
 void rbe_ecs_manager_finalize() {
+    rbe_ecs_command_buffer_finalize();
     rbe_ec_system_finalize();
     component_manager_finalize();
 }
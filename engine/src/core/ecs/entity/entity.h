@@ -2,7 +2,25 @@
 
 #include <stdint.h>
 
-#define MAX_ENTITIES 100
+// Entities are handles made up of an index and a generation.  The index addresses per entity data and is recycled
+// once an entity is destroyed, the generation is bumped on every recycle so stale handles can be detected.
+#define ENTITY_INDEX_BITS 20
+#define ENTITY_GENERATION_BITS 11 // Keeps handles positive when passed around as python ints
+#define ENTITY_INDEX_MASK ((1u << ENTITY_INDEX_BITS) - 1)
+#define ENTITY_GENERATION_MASK ((1u << ENTITY_GENERATION_BITS) - 1)
+#define MAX_ENTITIES (1u << ENTITY_INDEX_BITS)
 #define NULL_ENTITY 0
 
 typedef uint32_t Entity;
+
+static inline uint32_t entity_get_index(Entity entity) {
+    return entity & ENTITY_INDEX_MASK;
+}
+
+static inline uint32_t entity_get_generation(Entity entity) {
+    return (entity >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+static inline Entity entity_create_handle(uint32_t index, uint32_t generation) {
+    return (Entity) (((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK));
+}
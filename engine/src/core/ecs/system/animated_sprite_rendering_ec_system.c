@@ -16,27 +16,56 @@
 
 EntitySystem* animatedSpriteRenderingSystem = NULL;
 
+// Frames are stepped and culled per query chunk, draw calls go to the task's buffer
+typedef struct AnimatedSpriteRenderingChunkContext {
+    Rect2 cameraViewRect;
+    Rect2 defaultCameraViewRect;
+    int currentTickTime;
+} AnimatedSpriteRenderingChunkContext;
+static RBERenderCommandBuffer animatedSpriteCommandBuffers[ENTITY_SYSTEM_MAX_TASKS];
+
 void animated_sprite_rendering_system_render();
+void animated_sprite_rendering_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context);
 
 EntitySystem* animated_sprite_rendering_ec_system_create() {
     animatedSpriteRenderingSystem = rbe_ec_system_create();
     animatedSpriteRenderingSystem->name = rbe_strdup("Animated Sprite Rendering");
     animatedSpriteRenderingSystem->render_func = animated_sprite_rendering_system_render;
-    animatedSpriteRenderingSystem->component_signature = ComponentType_TRANSFORM_2D | ComponentType_ANIMATED_SPRITE;
+    animatedSpriteRenderingSystem->component_signature = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_ANIMATED_SPRITE);
+    // Culling writes the global transform and bounds caches kept in the transform component
+    animatedSpriteRenderingSystem->read_components = component_signature_create(ComponentType_NONE);
+    animatedSpriteRenderingSystem->write_components = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_ANIMATED_SPRITE);
+    animatedSpriteRenderingSystem->is_main_thread_only = false;
     return animatedSpriteRenderingSystem;
 }
 
 void animated_sprite_rendering_system_render() {
-    const RBECamera2D* camera2D = rbe_camera_manager_get_current_camera();
-    const RBECamera2D* defaultCamera = rbe_camera_manager_get_default_camera();
-    const int currentTickTime = (int) SDL_GetTicks();
-    for (size_t i = 0; i < animatedSpriteRenderingSystem->entity_count; i++) {
-        const Entity entity = animatedSpriteRenderingSystem->entities[i];
-        Transform2DComponent* spriteTransformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
-        AnimatedSpriteComponent* animatedSpriteComponent = (AnimatedSpriteComponent*) component_manager_get_component(entity, ComponentDataIndex_ANIMATED_SPRITE);
+    const AnimatedSpriteRenderingChunkContext context = {
+        .cameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_current_camera()),
+        .defaultCameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_default_camera()),
+        .currentTickTime = (int) SDL_GetTicks()
+    };
+    const size_t taskCount = rbe_ec_system_parallel_for_query_chunks(animatedSpriteRenderingSystem, animated_sprite_rendering_system_render_chunk, (void*) &context);
+    for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++) {
+        rbe_renderer_submit_command_buffer(&animatedSpriteCommandBuffers[taskIndex]);
+    }
+}
+
+void animated_sprite_rendering_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context) {
+    const AnimatedSpriteRenderingChunkContext* chunkContext = (AnimatedSpriteRenderingChunkContext*) context;
+    RBERenderCommandBuffer* commandBuffer = &animatedSpriteCommandBuffers[taskIndex];
+    Transform2DComponent* transforms = (Transform2DComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_TRANSFORM_2D);
+    AnimatedSpriteComponent* animatedSprites = (AnimatedSpriteComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_ANIMATED_SPRITE);
+    for (size_t i = 0; i < chunk->count; i++) {
+        const Entity entity = chunk->entities[i];
+        if (!rbe_ec_system_has_entity(entity, system)) {
+            continue;
+        }
+        Transform2DComponent* spriteTransformComp = &transforms[i];
+        AnimatedSpriteComponent* animatedSpriteComponent = &animatedSprites[i];
         AnimationFrame currentFrame = animatedSpriteComponent->currentAnimation.animationFrames[animatedSpriteComponent->currentAnimation.currentFrame];
         if (animatedSpriteComponent->isPlaying) {
-            const int newIndex = ((currentTickTime - (int) animatedSpriteComponent->startAnimationTickTime) / animatedSpriteComponent->currentAnimation.speed) % animatedSpriteComponent->currentAnimation.frameCount;
+            const int newIndex = ((chunkContext->currentTickTime - (int) animatedSpriteComponent->startAnimationTickTime) / animatedSpriteComponent->currentAnimation.speed) % animatedSpriteComponent->currentAnimation.frameCount;
             if (newIndex != animatedSpriteComponent->currentAnimation.currentFrame) {
                 // Index changed
                 currentFrame = animatedSpriteComponent->currentAnimation.animationFrames[newIndex];
@@ -49,26 +78,27 @@ void animated_sprite_rendering_system_render() {
                 animatedSpriteComponent->currentAnimation.currentFrame = newIndex;
             }
         }
-        const RBECamera2D* renderCamera = spriteTransformComp->ignoreCamera ? defaultCamera : camera2D;
-        TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, spriteTransformComp);
-        spriteTransformComp->isGlobalTransformDirty = true; // TODO: Make global transform const
-        glm_translate(globalTransform->model, (vec3) {
-            (renderCamera->offset.x - (renderCamera->viewport.x * globalTransform->scaleSign.x) - animatedSpriteComponent->origin.x) * renderCamera->zoom.x,
-            (renderCamera->offset.y - (renderCamera->viewport.y * globalTransform->scaleSign.y) - animatedSpriteComponent->origin.y) * renderCamera->zoom.y,
-            0.0f
-        });
-        const Size2D destinationSize = {
-            currentFrame.drawSource.w * renderCamera->zoom.x,
-            currentFrame.drawSource.h * renderCamera->zoom.y
-        };
-        rbe_renderer_queue_sprite_draw_call(
+        // Culled after advancing the animation so frames keep playing off screen
+        const Rect2 localRect = { -animatedSpriteComponent->origin.x, -animatedSpriteComponent->origin.y, currentFrame.drawSource.w, currentFrame.drawSource.h };
+        const Rect2* viewRect = spriteTransformComp->ignoreCamera ? &chunkContext->defaultCameraViewRect : &chunkContext->cameraViewRect;
+        if (!rbe_math_does_rect2_intersect(rbe_scene_manager_get_scene_node_global_bounds(entity, spriteTransformComp, &localRect), viewRect)) {
+            continue;
+        }
+        const TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, spriteTransformComp);
+        const Size2D destinationSize = { currentFrame.drawSource.w, currentFrame.drawSource.h };
+        rbe_renderer_command_buffer_queue_sprite_draw_call(
+            commandBuffer,
             currentFrame.texture,
             currentFrame.drawSource,
             destinationSize,
+            animatedSpriteComponent->origin,
             animatedSpriteComponent->modulate,
             animatedSpriteComponent->flipX,
             animatedSpriteComponent->flipY,
-            globalTransform
+            globalTransform,
+            spriteTransformComp->ignoreCamera,
+            rbe_scene_manager_get_scene_node_global_z_index(entity, spriteTransformComp),
+            RenderLayer_DEFAULT
         );
     }
 }
@@ -15,14 +15,26 @@ EntitySystem* collisionSystem = NULL;
 Texture* collisionOutlineTexture = NULL;
 Color collisionDrawColor = { .r=1.0f, .g=1.0f, .b=1.0f, .a=1.0f };
 Rect2 colliderDrawSource = { .x=0.0f, .y=0.0f, .w=1.0f, .h=1.0f };
+Vector2 colliderDrawOrigin = { .x=0.0f, .y=0.0f };
+
+typedef struct CollisionRenderChunkContext {
+    Rect2 cameraViewRect;
+    Rect2 defaultCameraViewRect;
+} CollisionRenderChunkContext;
+static RBERenderCommandBuffer collisionCommandBuffers[ENTITY_SYSTEM_MAX_TASKS];
 
 void collision_system_render();
+void collision_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context);
 
 EntitySystem* collision_ec_system_create() {
     RBE_ASSERT(collisionSystem == NULL);
     collisionSystem = rbe_ec_system_create();
     collisionSystem->name = rbe_strdup("Collision");
-    collisionSystem->component_signature = ComponentType_TRANSFORM_2D | ComponentType_COLLIDER_2D;
+    collisionSystem->component_signature = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_COLLIDER_2D);
+    // Culling writes the global transform and bounds caches kept in the transform component
+    collisionSystem->read_components = component_signature_create(ComponentType_COLLIDER_2D);
+    collisionSystem->write_components = component_signature_create(ComponentType_TRANSFORM_2D);
+    collisionSystem->is_main_thread_only = false;
 
     RBEGameProperties* gameProps = rbe_game_props_get();
     RBE_ASSERT(rbe_game_props_get() != NULL);
@@ -43,32 +55,47 @@ EntitySystem* collision_ec_system_get() {
 }
 
 void collision_system_render() {
-    const RBECamera2D* camera2D = rbe_camera_manager_get_current_camera();
-    const RBECamera2D* defaultCamera = rbe_camera_manager_get_default_camera();
-    for (size_t i = 0; i < collisionSystem->entity_count; i++) {
-        const Entity entity = collisionSystem->entities[i];
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
-        const Collider2DComponent* colliderComp = (Collider2DComponent*) component_manager_get_component(entity, ComponentDataIndex_COLLIDER_2D);
-        const RBECamera2D* renderCamera = transformComp->ignoreCamera ? defaultCamera : camera2D;
-        TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, transformComp);
-        transformComp->isGlobalTransformDirty = true; // TODO: Make global transform const
-        const Size2D colliderDrawSize = {
-            colliderComp->extents.w * renderCamera->zoom.x,
-            colliderComp->extents.h * renderCamera->zoom.y
-        };
-        glm_translate(globalTransform->model, (vec3) {
-            (renderCamera->offset.x - (renderCamera->viewport.x * globalTransform->scaleSign.x)) * renderCamera->zoom.x,
-            (renderCamera->offset.y - (renderCamera->viewport.y * globalTransform->scaleSign.y)) * renderCamera->zoom.y,
-            0.0f
-        });
-        rbe_renderer_queue_sprite_draw_call(
+    const CollisionRenderChunkContext context = {
+        .cameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_current_camera()),
+        .defaultCameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_default_camera())
+    };
+    const size_t taskCount = rbe_ec_system_parallel_for_query_chunks(collisionSystem, collision_system_render_chunk, (void*) &context);
+    for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++) {
+        rbe_renderer_submit_command_buffer(&collisionCommandBuffers[taskIndex]);
+    }
+}
+
+void collision_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context) {
+    const CollisionRenderChunkContext* chunkContext = (CollisionRenderChunkContext*) context;
+    RBERenderCommandBuffer* commandBuffer = &collisionCommandBuffers[taskIndex];
+    Transform2DComponent* transforms = (Transform2DComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_TRANSFORM_2D);
+    const Collider2DComponent* colliders = (Collider2DComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_COLLIDER_2D);
+    for (size_t i = 0; i < chunk->count; i++) {
+        const Entity entity = chunk->entities[i];
+        if (!rbe_ec_system_has_entity(entity, system)) {
+            continue;
+        }
+        Transform2DComponent* transformComp = &transforms[i];
+        const Collider2DComponent* colliderComp = &colliders[i];
+        const Rect2 localRect = { 0.0f, 0.0f, colliderComp->extents.w, colliderComp->extents.h };
+        const Rect2* viewRect = transformComp->ignoreCamera ? &chunkContext->defaultCameraViewRect : &chunkContext->cameraViewRect;
+        if (!rbe_math_does_rect2_intersect(rbe_scene_manager_get_scene_node_global_bounds(entity, transformComp, &localRect), viewRect)) {
+            continue;
+        }
+        const TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, transformComp);
+        rbe_renderer_command_buffer_queue_sprite_draw_call(
+            commandBuffer,
             collisionOutlineTexture,
             colliderDrawSource,
-            colliderDrawSize,
+            colliderComp->extents,
+            colliderDrawOrigin,
             colliderComp->color,
             false,
             false,
-            globalTransform
+            globalTransform,
+            transformComp->ignoreCamera,
+            rbe_scene_manager_get_scene_node_global_z_index(entity, transformComp),
+            RenderLayer_DEBUG
         );
     }
 }
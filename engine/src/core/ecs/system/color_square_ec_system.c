@@ -15,15 +15,27 @@
 EntitySystem* colorSquareSystem = NULL;
 Texture* colorSquareTexture = NULL;
 Rect2 colorSquareDrawSource = { 0.0f, 0.0f, 1.0f, 1.0f };
+Vector2 colorSquareOrigin = { 0.0f, 0.0f };
+
+typedef struct ColorSquareRenderChunkContext {
+    Rect2 cameraViewRect;
+    Rect2 defaultCameraViewRect;
+} ColorSquareRenderChunkContext;
+static RBERenderCommandBuffer colorSquareCommandBuffers[ENTITY_SYSTEM_MAX_TASKS];
 
 void color_square_system_render();
+void color_square_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context);
 
 EntitySystem* color_square_ec_system_create() {
     RBE_ASSERT(colorSquareSystem == NULL);
     colorSquareSystem = rbe_ec_system_create();
     colorSquareSystem->name = rbe_strdup("Color Square");
     colorSquareSystem->render_func = color_square_system_render;
-    colorSquareSystem->component_signature = ComponentType_TRANSFORM_2D | ComponentType_COLOR_SQUARE;
+    colorSquareSystem->component_signature = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_COLOR_SQUARE);
+    // Culling writes the global transform and bounds caches kept in the transform component
+    colorSquareSystem->read_components = component_signature_create(ComponentType_COLOR_SQUARE);
+    colorSquareSystem->write_components = component_signature_create(ComponentType_TRANSFORM_2D);
+    colorSquareSystem->is_main_thread_only = false;
 
     RBE_ASSERT_FMT(colorSquareTexture == NULL, "Color Square Texture isn't NULL!");
     colorSquareTexture = rbe_texture_create_solid_colored_texture(1, 1, 255);
@@ -31,35 +43,47 @@ EntitySystem* color_square_ec_system_create() {
 }
 
 void color_square_system_render() {
-    const RBECamera2D* camera2D = rbe_camera_manager_get_current_camera();
-    const RBECamera2D* defaultCamera = rbe_camera_manager_get_default_camera();
-
-    for (size_t i = 0; i < colorSquareSystem->entity_count; i++) {
-        const Entity entity = colorSquareSystem->entities[i];
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
-        const ColorSquareComponent* colorSquareComponent = (ColorSquareComponent *) component_manager_get_component(entity, ComponentDataIndex_COLOR_SQUARE);
-        const RBECamera2D* renderCamera = transformComp->ignoreCamera ? defaultCamera : camera2D;
-        TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, transformComp);
-        transformComp->isGlobalTransformDirty = true; // TODO: Make global transform const
-        const Size2D destinationSize = {
-            colorSquareComponent->size.w * renderCamera->zoom.x,
-            colorSquareComponent->size.h * renderCamera->zoom.y
-        };
-
-        glm_translate(globalTransform->model, (vec3) {
-            (renderCamera->offset.x - (renderCamera->viewport.x * globalTransform->scaleSign.x)) * renderCamera->zoom.x,
-            (renderCamera->offset.y - (renderCamera->viewport.y * globalTransform->scaleSign.y)) * renderCamera->zoom.y,
-            0.0f
-        });
+    const ColorSquareRenderChunkContext context = {
+        .cameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_current_camera()),
+        .defaultCameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_default_camera())
+    };
+    const size_t taskCount = rbe_ec_system_parallel_for_query_chunks(colorSquareSystem, color_square_system_render_chunk, (void*) &context);
+    for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++) {
+        rbe_renderer_submit_command_buffer(&colorSquareCommandBuffers[taskIndex]);
+    }
+}
 
-        rbe_renderer_queue_sprite_draw_call(
+void color_square_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context) {
+    const ColorSquareRenderChunkContext* chunkContext = (ColorSquareRenderChunkContext*) context;
+    RBERenderCommandBuffer* commandBuffer = &colorSquareCommandBuffers[taskIndex];
+    Transform2DComponent* transforms = (Transform2DComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_TRANSFORM_2D);
+    const ColorSquareComponent* colorSquares = (ColorSquareComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_COLOR_SQUARE);
+    for (size_t i = 0; i < chunk->count; i++) {
+        const Entity entity = chunk->entities[i];
+        if (!rbe_ec_system_has_entity(entity, system)) {
+            continue;
+        }
+        Transform2DComponent* transformComp = &transforms[i];
+        const ColorSquareComponent* colorSquareComponent = &colorSquares[i];
+        const Rect2 localRect = { 0.0f, 0.0f, colorSquareComponent->size.w, colorSquareComponent->size.h };
+        const Rect2* viewRect = transformComp->ignoreCamera ? &chunkContext->defaultCameraViewRect : &chunkContext->cameraViewRect;
+        if (!rbe_math_does_rect2_intersect(rbe_scene_manager_get_scene_node_global_bounds(entity, transformComp, &localRect), viewRect)) {
+            continue;
+        }
+        const TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, transformComp);
+        rbe_renderer_command_buffer_queue_sprite_draw_call(
+            commandBuffer,
             colorSquareTexture,
             colorSquareDrawSource,
-            destinationSize,
+            colorSquareComponent->size,
+            colorSquareOrigin,
             colorSquareComponent->color,
             false,
             false,
-            globalTransform
+            globalTransform,
+            transformComp->ignoreCamera,
+            rbe_scene_manager_get_scene_node_global_z_index(entity, transformComp),
+            RenderLayer_DEFAULT
         );
     }
 }
@@ -1,11 +1,17 @@
 #include "ec_system.h"
 
+#include <string.h>
+
 #include "../../memory/rbe_mem.h"
+#include "../../thread/rbe_thread_pool.h"
 #include "../../utils/logger.h"
 #include "../../utils/rbe_assert.h"
 
 //--- EC System Manager ---//
+#define MAX_ENTITY_SYSTEMS 16
 #define MAX_ENTITY_SYSTEMS_PER_HOOK 6
+#define ENTITY_SYSTEM_INITIAL_CAPACITY 16
+#define ENTITY_SYSTEM_INVALID_INDEX UINT32_MAX
 
 typedef struct EntitySystemData {
     size_t entity_systems_count;
@@ -15,7 +21,7 @@ typedef struct EntitySystemData {
     size_t process_systems_count;
     size_t physics_process_systems_count;
     size_t network_callback_systems_count;
-    EntitySystem* entity_systems[MAX_COMPONENTS];
+    EntitySystem* entity_systems[MAX_ENTITY_SYSTEMS];
     EntitySystem* on_entity_start_systems[MAX_ENTITY_SYSTEMS_PER_HOOK];
     EntitySystem* on_entity_end_systems[MAX_ENTITY_SYSTEMS_PER_HOOK];
     EntitySystem* render_systems[MAX_ENTITY_SYSTEMS_PER_HOOK];
@@ -24,14 +30,62 @@ typedef struct EntitySystemData {
     EntitySystem* network_callback_systems[MAX_ENTITY_SYSTEMS_PER_HOOK];
 } EntitySystemData;
 
+//--- System Scheduler ---//
+// Systems of a hook are grouped into waves, systems within a wave don't conflict and run at the same time.
+// A system is placed in the wave after the last earlier registered system it conflicts with.
+typedef enum EntitySystemHook {
+    EntitySystemHook_RENDER = 0,
+    EntitySystemHook_PROCESS = 1,
+    EntitySystemHook_PHYSICS_PROCESS = 2,
+    EntitySystemHook_COUNT = 3,
+} EntitySystemHook;
+
+typedef struct EntitySystemSchedule {
+    EntitySystem* systems[MAX_ENTITY_SYSTEMS_PER_HOOK]; // Ordered by wave
+    size_t waveEnds[MAX_ENTITY_SYSTEMS_PER_HOOK];
+    size_t waveCount;
+    bool isDirty;
+} EntitySystemSchedule;
+
+typedef struct EntitySystemJob {
+    EntitySystem* system;
+    EntitySystemHook hook;
+    float deltaTime;
+} EntitySystemJob;
+
+static EntitySystemSchedule systemSchedules[EntitySystemHook_COUNT];
+static ThreadPool* systemThreadPool = NULL;
+
+void ec_system_run_hook(EntitySystemHook hook, EntitySystem** systems, size_t systemCount, float deltaTime);
+
 void rbe_ec_system_insert_entity_into_system(Entity entity, EntitySystem* system);
 void rbe_ec_system_remove_entity_from_system(Entity entity, EntitySystem* system);
 
 EntitySystemData entitySystemData;
-Entity entityIndex = 1; // 0 is NULL_ENTITY
+
+//--- Entity Allocator ---//
+// Freed indices are only recycled once this many are queued so generations don't wrap around quickly
+#define ENTITY_MINIMUM_FREE_INDICES 1024
+
+typedef struct EntityAllocator {
+    uint16_t* generations;
+    size_t indexCount; // Indices handed out so far, index 0 is reserved for NULL_ENTITY
+    size_t indexCapacity;
+    // Ring buffer of freed indices
+    uint32_t* freeIndices;
+    size_t freeIndicesHead;
+    size_t freeIndicesCount;
+    size_t freeIndicesCapacity;
+    pthread_mutex_t mutex; // Command buffers reserve entities from worker threads
+} EntityAllocator;
+
+static EntityAllocator entityAllocator;
+
+void entity_allocator_initialize();
+void entity_allocator_finalize();
 
 void rbe_ec_system_initialize() {
-    for (size_t i = 0; i < MAX_COMPONENTS; i++) {
+    for (size_t i = 0; i < MAX_ENTITY_SYSTEMS; i++) {
         entitySystemData.entity_systems[i] = NULL;
     }
     for (size_t i = 0; i < MAX_ENTITY_SYSTEMS_PER_HOOK; i++) {
@@ -49,6 +103,14 @@ void rbe_ec_system_initialize() {
     entitySystemData.process_systems_count = 0;
     entitySystemData.physics_process_systems_count = 0;
     entitySystemData.network_callback_systems_count = 0;
+    for (size_t i = 0; i < EntitySystemHook_COUNT; i++) {
+        systemSchedules[i].waveCount = 0;
+        systemSchedules[i].isDirty = true;
+    }
+    // Main thread works too, so one less worker than cores
+    const unsigned int procCount = pcthread_get_num_procs();
+    systemThreadPool = tpool_create(procCount > 1 ? procCount - 1 : 1);
+    entity_allocator_initialize();
 }
 
 void rbe_ec_system_finalize() {
@@ -56,12 +118,19 @@ void rbe_ec_system_finalize() {
         rbe_ec_system_destroy(entitySystemData.entity_systems[i]);
         entitySystemData.entity_systems[i] = NULL;
     }
+    tpool_destroy(systemThreadPool);
+    systemThreadPool = NULL;
+    entity_allocator_finalize();
 }
 
 EntitySystem* rbe_ec_system_create() {
     EntitySystem* newSystem = RBE_MEM_ALLOCATE(EntitySystem);
     newSystem->name = NULL;
     newSystem->entity_count = 0;
+    newSystem->entity_capacity = ENTITY_SYSTEM_INITIAL_CAPACITY;
+    newSystem->entities = RBE_MEM_ALLOCATE_SIZE(ENTITY_SYSTEM_INITIAL_CAPACITY * sizeof(Entity));
+    newSystem->entity_sparse_indices = NULL;
+    newSystem->entity_sparse_capacity = 0;
     newSystem->on_entity_registered_func = NULL;
     newSystem->on_entity_start_func = NULL;
     newSystem->on_entity_end_func = NULL;
@@ -70,17 +139,28 @@ EntitySystem* rbe_ec_system_create() {
     newSystem->process_func = NULL;
     newSystem->physics_process_func = NULL;
     newSystem->network_callback_func = NULL;
-    newSystem->component_signature = ComponentType_NONE;
+    newSystem->component_signature = component_signature_create(ComponentType_NONE);
+    newSystem->read_components = component_signature_create(ComponentType_NONE);
+    newSystem->write_components = component_signature_create(ComponentType_NONE);
+    newSystem->is_main_thread_only = true;
+    newSystem->component_query = NULL;
+    newSystem->last_change_tick = 0;
     return newSystem;
 }
 
 void rbe_ec_system_destroy(EntitySystem* entitySystem) {
+    RBE_MEM_FREE(entitySystem->entities);
+    if (entitySystem->entity_sparse_indices != NULL) {
+        RBE_MEM_FREE(entitySystem->entity_sparse_indices);
+    }
     RBE_MEM_FREE(entitySystem);
 }
 
 void rbe_ec_system_register(EntitySystem* system) {
     RBE_ASSERT_FMT(system != NULL, "Passed in system is NULL!");
+    RBE_ASSERT_FMT(entitySystemData.entity_systems_count < MAX_ENTITY_SYSTEMS, "Reached max entity systems '%d'!", MAX_ENTITY_SYSTEMS);
     entitySystemData.entity_systems[entitySystemData.entity_systems_count++] = system;
+    system->component_query = component_manager_query(system->component_signature);
     if (system->on_entity_start_func != NULL) {
         entitySystemData.on_entity_start_systems[entitySystemData.on_entity_start_systems_count++] = system;
     }
@@ -89,12 +169,15 @@ void rbe_ec_system_register(EntitySystem* system) {
     }
     if (system->render_func != NULL) {
         entitySystemData.render_systems[entitySystemData.render_systems_count++] = system;
+        systemSchedules[EntitySystemHook_RENDER].isDirty = true;
     }
     if (system->process_func != NULL) {
         entitySystemData.process_systems[entitySystemData.process_systems_count++] = system;
+        systemSchedules[EntitySystemHook_PROCESS].isDirty = true;
     }
     if (system->physics_process_func != NULL) {
         entitySystemData.physics_process_systems[entitySystemData.physics_process_systems_count++] = system;
+        systemSchedules[EntitySystemHook_PHYSICS_PROCESS].isDirty = true;
     }
     if (system->network_callback_func != NULL) {
         entitySystemData.network_callback_systems[entitySystemData.network_callback_systems_count++] = system;
@@ -102,9 +185,9 @@ void rbe_ec_system_register(EntitySystem* system) {
 }
 
 void rbe_ec_system_update_entity_signature_with_systems(Entity entity) {
-    ComponentType entityComponentSignature = component_manager_get_component_signature(entity);
+    const ComponentSignature entityComponentSignature = component_manager_get_component_signature(entity);
     for (size_t i = 0; i < entitySystemData.entity_systems_count; i++) {
-        if ((entityComponentSignature & entitySystemData.entity_systems[i]->component_signature) == entitySystemData.entity_systems[i]->component_signature) {
+        if (component_signature_matches(&entityComponentSignature, &entitySystemData.entity_systems[i]->component_signature)) {
             rbe_ec_system_insert_entity_into_system(entity, entitySystemData.entity_systems[i]);
         } else {
             rbe_ec_system_remove_entity_from_system(entity, entitySystemData.entity_systems[i]);
@@ -113,39 +196,33 @@ void rbe_ec_system_update_entity_signature_with_systems(Entity entity) {
 }
 
 void rbe_ec_system_entity_start(Entity entity) {
-    ComponentType entityComponentSignature = component_manager_get_component_signature(entity);
+    const ComponentSignature entityComponentSignature = component_manager_get_component_signature(entity);
     for (size_t i = 0; i < entitySystemData.on_entity_start_systems_count; i++) {
-        if ((entityComponentSignature & entitySystemData.on_entity_start_systems[i]->component_signature) == entitySystemData.on_entity_start_systems[i]->component_signature) {
+        if (component_signature_matches(&entityComponentSignature, &entitySystemData.on_entity_start_systems[i]->component_signature)) {
             entitySystemData.on_entity_start_systems[i]->on_entity_start_func(entity);
         }
     }
 }
 
 void rbe_ec_system_entity_end(Entity entity) {
-    ComponentType entityComponentSignature = component_manager_get_component_signature(entity);
+    const ComponentSignature entityComponentSignature = component_manager_get_component_signature(entity);
     for (size_t i = 0; i < entitySystemData.on_entity_end_systems_count; i++) {
-        if ((entityComponentSignature & entitySystemData.on_entity_end_systems[i]->component_signature) == entitySystemData.on_entity_end_systems[i]->component_signature) {
+        if (component_signature_matches(&entityComponentSignature, &entitySystemData.on_entity_end_systems[i]->component_signature)) {
             entitySystemData.on_entity_end_systems[i]->on_entity_end_func(entity);
         }
     }
 }
 
 void rbe_ec_system_render_systems() {
-    for (size_t i = 0; i < entitySystemData.render_systems_count; i++) {
-        entitySystemData.render_systems[i]->render_func();
-    }
+    ec_system_run_hook(EntitySystemHook_RENDER, entitySystemData.render_systems, entitySystemData.render_systems_count, 0.0f);
 }
 
 void rbe_ec_system_process_systems(float deltaTime) {
-    for (size_t i = 0; i < entitySystemData.process_systems_count; i++) {
-        entitySystemData.process_systems[i]->process_func(deltaTime);
-    }
+    ec_system_run_hook(EntitySystemHook_PROCESS, entitySystemData.process_systems, entitySystemData.process_systems_count, deltaTime);
 }
 
 void rbe_ec_system_physics_process_systems(float deltaTime) {
-    for (size_t i = 0; i < entitySystemData.physics_process_systems_count; i++) {
-        entitySystemData.physics_process_systems[i]->physics_process_func(deltaTime);
-    }
+    ec_system_run_hook(EntitySystemHook_PHYSICS_PROCESS, entitySystemData.physics_process_systems, entitySystemData.physics_process_systems_count, deltaTime);
 }
 
 void rbe_ec_system_network_callback(const char* message) {
@@ -154,28 +231,228 @@ void rbe_ec_system_network_callback(const char* message) {
     }
 }
 
+// --- System Scheduling --- //
+bool ec_system_do_systems_conflict(const EntitySystem* systemA, const EntitySystem* systemB) {
+    return component_signature_intersects(&systemA->write_components, &systemB->write_components)
+           || component_signature_intersects(&systemA->write_components, &systemB->read_components)
+           || component_signature_intersects(&systemA->read_components, &systemB->write_components);
+}
+
+void ec_system_build_schedule(EntitySystemSchedule* schedule, EntitySystem** systems, size_t systemCount) {
+    size_t systemWaves[MAX_ENTITY_SYSTEMS_PER_HOOK];
+    schedule->waveCount = 0;
+    for (size_t i = 0; i < systemCount; i++) {
+        systemWaves[i] = 0;
+        for (size_t j = 0; j < i; j++) {
+            if (systemWaves[j] >= systemWaves[i] && ec_system_do_systems_conflict(systems[i], systems[j])) {
+                systemWaves[i] = systemWaves[j] + 1;
+            }
+        }
+        if (systemWaves[i] + 1 > schedule->waveCount) {
+            schedule->waveCount = systemWaves[i] + 1;
+        }
+    }
+    // Order systems by wave, keeping registration order within a wave
+    size_t scheduledCount = 0;
+    for (size_t wave = 0; wave < schedule->waveCount; wave++) {
+        for (size_t i = 0; i < systemCount; i++) {
+            if (systemWaves[i] == wave) {
+                schedule->systems[scheduledCount++] = systems[i];
+            }
+        }
+        schedule->waveEnds[wave] = scheduledCount;
+    }
+    schedule->isDirty = false;
+}
+
+void ec_system_run_job(void* arg) {
+    const EntitySystemJob* job = (EntitySystemJob*) arg;
+    switch (job->hook) {
+    case EntitySystemHook_RENDER:
+        job->system->render_func();
+        break;
+    case EntitySystemHook_PROCESS:
+        job->system->process_func(job->deltaTime);
+        break;
+    case EntitySystemHook_PHYSICS_PROCESS:
+        job->system->physics_process_func(job->deltaTime);
+        break;
+    case EntitySystemHook_COUNT:
+    default:
+        break;
+    }
+}
+
+void ec_system_run_hook(EntitySystemHook hook, EntitySystem** systems, size_t systemCount, float deltaTime) {
+    EntitySystemSchedule* schedule = &systemSchedules[hook];
+    if (schedule->isDirty) {
+        ec_system_build_schedule(schedule, systems, systemCount);
+    }
+    EntitySystemJob jobs[MAX_ENTITY_SYSTEMS_PER_HOOK];
+    size_t waveStart = 0;
+    for (size_t wave = 0; wave < schedule->waveCount; wave++) {
+        const size_t waveEnd = schedule->waveEnds[wave];
+        // Worker threads take what they can, main thread only systems run while they work
+        bool hasWorkerJobs = false;
+        for (size_t i = waveStart; i < waveEnd; i++) {
+            jobs[i] = (EntitySystemJob) { .system = schedule->systems[i], .hook = hook, .deltaTime = deltaTime };
+            if (waveEnd - waveStart > 1 && !schedule->systems[i]->is_main_thread_only) {
+                tpool_add_work(systemThreadPool, ec_system_run_job, &jobs[i]);
+                hasWorkerJobs = true;
+            }
+        }
+        for (size_t i = waveStart; i < waveEnd; i++) {
+            if (waveEnd - waveStart == 1 || schedule->systems[i]->is_main_thread_only) {
+                ec_system_run_job(&jobs[i]);
+            }
+        }
+        if (hasWorkerJobs) {
+            tpool_wait(systemThreadPool);
+        }
+        // Anything written from here on is newer than what the wave's systems have seen
+        const uint32_t changeTick = component_manager_get_change_tick();
+        for (size_t i = waveStart; i < waveEnd; i++) {
+            schedule->systems[i]->last_change_tick = changeTick;
+        }
+        component_manager_advance_change_tick();
+        waveStart = waveEnd;
+    }
+}
+
+// --- Parallel For --- //
+typedef struct EntitySystemParallelFor {
+    EntitySystem* system;
+    const ComponentQueryChunk* chunks;
+    EntitySystemQueryChunkFunc func;
+    void* context;
+} EntitySystemParallelFor;
+
+void ec_system_run_task(size_t start, size_t end, size_t taskIndex, void* context) {
+    const EntitySystemParallelFor* parallelFor = (EntitySystemParallelFor*) context;
+    for (size_t i = start; i < end; i++) {
+        parallelFor->func(parallelFor->system, &parallelFor->chunks[i], taskIndex, parallelFor->context);
+    }
+}
+
+size_t rbe_ec_system_parallel_for_query_chunks(EntitySystem* system, EntitySystemQueryChunkFunc func, void* context) {
+    size_t chunkCount = 0;
+    const ComponentQueryChunk* chunks = component_query_get_chunks(system->component_query, &chunkCount);
+    const size_t chunksPerTask = (chunkCount + ENTITY_SYSTEM_MAX_TASKS - 1) / ENTITY_SYSTEM_MAX_TASKS;
+    EntitySystemParallelFor parallelFor = { .system = system, .chunks = chunks, .func = func, .context = context };
+    return tpool_parallel_for(systemThreadPool, chunkCount, chunksPerTask, ec_system_run_task, &parallelFor);
+}
+
 // --- Entity Management --- //
 Entity rbe_ec_system_create_entity() {
-    // TODO: Create entity pool
-    Entity newEntity = entityIndex;
-    rbe_logger_info("New entity created with id = '%d'", newEntity);
-    entityIndex++;
+    pthread_mutex_lock(&entityAllocator.mutex);
+    uint32_t index;
+    if (entityAllocator.freeIndicesCount > ENTITY_MINIMUM_FREE_INDICES) {
+        index = entityAllocator.freeIndices[entityAllocator.freeIndicesHead];
+        entityAllocator.freeIndicesHead = (entityAllocator.freeIndicesHead + 1) % entityAllocator.freeIndicesCapacity;
+        entityAllocator.freeIndicesCount--;
+    } else {
+        RBE_ASSERT_FMT(entityAllocator.indexCount < MAX_ENTITIES, "Reached max entities '%u'!", MAX_ENTITIES);
+        if (entityAllocator.indexCount >= entityAllocator.indexCapacity) {
+            entityAllocator.indexCapacity *= 2;
+            entityAllocator.generations = RBE_MEM_REALLOCATE(entityAllocator.generations, entityAllocator.indexCapacity * sizeof(uint16_t));
+        }
+        index = (uint32_t) entityAllocator.indexCount++;
+        entityAllocator.generations[index] = 0;
+    }
+    const Entity newEntity = entity_create_handle(index, entityAllocator.generations[index]);
+    pthread_mutex_unlock(&entityAllocator.mutex);
+    rbe_logger_debug("New entity created with id = '%u'", newEntity);
     return newEntity;
 }
 
+void rbe_ec_system_destroy_entity(Entity entity) {
+    if (!rbe_ec_system_is_entity_alive(entity)) {
+        rbe_logger_warn("Tried to destroy stale or invalid entity '%u'!", entity);
+        return;
+    }
+    pthread_mutex_lock(&entityAllocator.mutex);
+    const uint32_t index = entity_get_index(entity);
+    entityAllocator.generations[index] = (uint16_t) ((entityAllocator.generations[index] + 1) & ENTITY_GENERATION_MASK);
+    if (entityAllocator.freeIndicesCount >= entityAllocator.freeIndicesCapacity) {
+        // Unwrap the ring buffer into the larger allocation
+        const size_t newCapacity = entityAllocator.freeIndicesCapacity * 2;
+        uint32_t* newFreeIndices = RBE_MEM_ALLOCATE_SIZE(newCapacity * sizeof(uint32_t));
+        for (size_t i = 0; i < entityAllocator.freeIndicesCount; i++) {
+            newFreeIndices[i] = entityAllocator.freeIndices[(entityAllocator.freeIndicesHead + i) % entityAllocator.freeIndicesCapacity];
+        }
+        RBE_MEM_FREE(entityAllocator.freeIndices);
+        entityAllocator.freeIndices = newFreeIndices;
+        entityAllocator.freeIndicesHead = 0;
+        entityAllocator.freeIndicesCapacity = newCapacity;
+    }
+    const size_t tail = (entityAllocator.freeIndicesHead + entityAllocator.freeIndicesCount) % entityAllocator.freeIndicesCapacity;
+    entityAllocator.freeIndices[tail] = index;
+    entityAllocator.freeIndicesCount++;
+    pthread_mutex_unlock(&entityAllocator.mutex);
+}
+
+bool rbe_ec_system_is_entity_alive(Entity entity) {
+    const uint32_t index = entity_get_index(entity);
+    pthread_mutex_lock(&entityAllocator.mutex);
+    const bool isAlive = index != NULL_ENTITY && index < entityAllocator.indexCount && entityAllocator.generations[index] == entity_get_generation(entity);
+    pthread_mutex_unlock(&entityAllocator.mutex);
+    return isAlive;
+}
+
+void entity_allocator_initialize() {
+    entityAllocator.indexCapacity = ENTITY_MINIMUM_FREE_INDICES;
+    entityAllocator.generations = RBE_MEM_ALLOCATE_SIZE(entityAllocator.indexCapacity * sizeof(uint16_t));
+    entityAllocator.indexCount = 1; // 0 is NULL_ENTITY
+    entityAllocator.freeIndicesCapacity = ENTITY_MINIMUM_FREE_INDICES * 2;
+    entityAllocator.freeIndices = RBE_MEM_ALLOCATE_SIZE(entityAllocator.freeIndicesCapacity * sizeof(uint32_t));
+    entityAllocator.freeIndicesHead = 0;
+    entityAllocator.freeIndicesCount = 0;
+    pthread_mutex_init(&entityAllocator.mutex, NULL);
+}
+
+void entity_allocator_finalize() {
+    pthread_mutex_destroy(&entityAllocator.mutex);
+    RBE_MEM_FREE(entityAllocator.generations);
+    RBE_MEM_FREE(entityAllocator.freeIndices);
+    memset(&entityAllocator, 0, sizeof(EntityAllocator));
+}
+
 // --- Internal Functions --- //
 bool rbe_ec_system_has_entity(Entity entity, EntitySystem* system) {
-    for (size_t i = 0; i < system->entity_count; i++) {
-        if (entity == system->entities[i]) {
-            return true;
-        }
+    const uint32_t entityIndex = entity_get_index(entity);
+    if (entityIndex >= system->entity_sparse_capacity) {
+        return false;
     }
-    return false;
+    const uint32_t denseIndex = system->entity_sparse_indices[entityIndex];
+    return denseIndex != ENTITY_SYSTEM_INVALID_INDEX && system->entities[denseIndex] == entity;
 }
 
 void rbe_ec_system_insert_entity_into_system(Entity entity, EntitySystem* system) {
     if (!rbe_ec_system_has_entity(entity, system)) {
+        if (system->entity_count >= system->entity_capacity) {
+            system->entity_capacity *= 2;
+            system->entities = RBE_MEM_REALLOCATE(system->entities, system->entity_capacity * sizeof(Entity));
+        }
+        const uint32_t entityIndex = entity_get_index(entity);
+        if (entityIndex >= system->entity_sparse_capacity) {
+            size_t newSparseCapacity = system->entity_sparse_capacity == 0 ? ENTITY_SYSTEM_INITIAL_CAPACITY : system->entity_sparse_capacity;
+            while (entityIndex >= newSparseCapacity) {
+                newSparseCapacity *= 2;
+            }
+            system->entity_sparse_indices = RBE_MEM_REALLOCATE(system->entity_sparse_indices, newSparseCapacity * sizeof(uint32_t));
+            for (size_t i = system->entity_sparse_capacity; i < newSparseCapacity; i++) {
+                system->entity_sparse_indices[i] = ENTITY_SYSTEM_INVALID_INDEX;
+            }
+            system->entity_sparse_capacity = newSparseCapacity;
+        }
+        system->entity_sparse_indices[entityIndex] = (uint32_t) system->entity_count;
         system->entities[system->entity_count++] = entity;
+        // New entities count as changed so systems only looking at changed components pick them up
+        for (size_t i = 0; i < component_manager_get_component_type_count(); i++) {
+            if (component_signature_has(&system->component_signature, (ComponentDataIndex) i)) {
+                component_manager_mark_component_changed(entity, (ComponentDataIndex) i);
+            }
+        }
         if (system->on_entity_registered_func != NULL) {
             system->on_entity_registered_func(entity);
         }
@@ -185,31 +462,18 @@ void rbe_ec_system_insert_entity_into_system(Entity entity, EntitySystem* system
 }
 
 void rbe_ec_system_remove_entity_from_system(Entity entity, EntitySystem* system) {
-    for (size_t i = 0; i < system->entity_count; i++) {
-        if (entity == system->entities[i]) {
-            // Entity found
-            if (i + 1 < MAX_ENTITIES) {
-                system->entities[i] = NULL_ENTITY;
-            }
-            if (system->on_entity_unregistered_func != NULL) {
-                system->on_entity_unregistered_func(entity);
-            }
-
-            // Condense array
-            for (size_t newIndex = i; i < system->entity_count; i++) {
-                if (system->entities[i] == NULL_ENTITY) {
-                    // Early exit if 2 consecutive nulls
-                    if (system->entities[i + 1] == NULL_ENTITY) {
-                        break;
-                    }
-                    system->entities[i] = system->entities[i + 1];
-                    system->entities[i + 1] = NULL_ENTITY;
-                }
-            }
-
-            system->entity_count--;
-            break;
-        }
+    if (!rbe_ec_system_has_entity(entity, system)) {
+        return;
+    }
+    // Swap last entity into the removed entity's slot
+    const uint32_t entityIndex = entity_get_index(entity);
+    const uint32_t denseIndex = system->entity_sparse_indices[entityIndex];
+    const Entity lastEntity = system->entities[--system->entity_count];
+    system->entities[denseIndex] = lastEntity;
+    system->entity_sparse_indices[entity_get_index(lastEntity)] = denseIndex;
+    system->entity_sparse_indices[entityIndex] = ENTITY_SYSTEM_INVALID_INDEX;
+    if (system->on_entity_unregistered_func != NULL) {
+        system->on_entity_unregistered_func(entity);
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "../component/component.h"
 
@@ -13,6 +14,9 @@ typedef void (*ProcessFunc) (float);
 typedef void (*PhysicsProcessFunc) (float);
 typedef void (*NetworkCallbackFunc) (const char*);
 
+// Query chunks are split into at most this many parallel for tasks
+#define ENTITY_SYSTEM_MAX_TASKS 64
+
 typedef struct EntitySystem {
     char* name;
     OnEntityRegisteredFunc on_entity_registered_func;
@@ -23,9 +27,21 @@ typedef struct EntitySystem {
     ProcessFunc process_func;
     PhysicsProcessFunc physics_process_func;
     NetworkCallbackFunc network_callback_func;
-    ComponentType component_signature;
+    ComponentSignature component_signature; // Precomputed mask of the components an entity needs to be in the system
+    // Components accessed by the system's process, physics process and render hooks, systems that don't conflict run
+    // at the same time.  Updating a cache stored in a component (e.g. global transforms) counts as a write.
+    ComponentSignature read_components;
+    ComponentSignature write_components;
+    bool is_main_thread_only; // Defaults to true, required for systems that touch python or OpenGL
+    ComponentQuery* component_query; // Archetype chunks with the system's components, created on register
+    // Change tick the system last ran at, components with a newer tick have changed since.  Updated after each run.
+    uint32_t last_change_tick;
+    // Sparse set of entities, 'entities' is densely packed and 'entity_sparse_indices' maps entity index to dense index
     size_t entity_count;
-    Entity entities[MAX_ENTITIES];
+    size_t entity_capacity;
+    Entity* entities;
+    uint32_t* entity_sparse_indices;
+    size_t entity_sparse_capacity;
 } EntitySystem;
 
 void rbe_ec_system_initialize();
@@ -45,5 +61,14 @@ void rbe_ec_system_physics_process_systems(float deltaTime);
 
 void rbe_ec_system_network_callback(const char* message);
 
+// Runs 'func' on every chunk of the system's component query across the system thread pool and waits for all of them.
+// Chunks are grouped into tasks the same way for a given chunk count, so outputs indexed by task can be merged in order
+// afterwards.  Returns the task count.  Chunks hold every entity with the components, including ones that haven't been
+// added to the system yet, check 'rbe_ec_system_has_entity' when that matters.
+typedef void (*EntitySystemQueryChunkFunc)(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context);
+size_t rbe_ec_system_parallel_for_query_chunks(EntitySystem* system, EntitySystemQueryChunkFunc func, void* context);
+
 // Entity System Management
 Entity rbe_ec_system_create_entity();
+void rbe_ec_system_destroy_entity(Entity entity);
+bool rbe_ec_system_is_entity_alive(Entity entity);
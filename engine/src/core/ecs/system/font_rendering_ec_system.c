@@ -13,34 +13,83 @@
 
 EntitySystem* fontRenderingSystem = NULL;
 
+typedef struct FontRenderingChunkContext {
+    Rect2 cameraViewRect;
+    Rect2 defaultCameraViewRect;
+} FontRenderingChunkContext;
+static RBERenderCommandBuffer fontCommandBuffers[ENTITY_SYSTEM_MAX_TASKS];
+
 void font_rendering_system_render();
+void font_rendering_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context);
 
 EntitySystem* font_rendering_ec_system_create() {
     RBE_ASSERT(fontRenderingSystem == NULL);
     fontRenderingSystem = rbe_ec_system_create();
     fontRenderingSystem->name = rbe_strdup("Font Rendering");
     fontRenderingSystem->render_func = font_rendering_system_render;
-    fontRenderingSystem->component_signature = ComponentType_TRANSFORM_2D | ComponentType_TEXT_LABEL;
+    fontRenderingSystem->component_signature = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_TEXT_LABEL);
+    // Resolving the global transform writes the cache kept in the transform component
+    fontRenderingSystem->read_components = component_signature_create(ComponentType_NONE);
+    fontRenderingSystem->write_components = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_TEXT_LABEL);
+    fontRenderingSystem->is_main_thread_only = false;
     return fontRenderingSystem;
 }
 
 void font_rendering_system_render() {
-    const RBECamera2D* camera2D = rbe_camera_manager_get_current_camera();
-    const RBECamera2D* defaultCamera = rbe_camera_manager_get_default_camera();
-    for (size_t i = 0; i < fontRenderingSystem->entity_count; i++) {
-        const Entity entity = fontRenderingSystem->entities[i];
-        Transform2DComponent* fontTransformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
-        TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component(entity, ComponentDataIndex_TEXT_LABEL);
-        const RBECamera2D* renderCamera = fontTransformComp->ignoreCamera ? defaultCamera : camera2D;
+    const FontRenderingChunkContext context = {
+        .cameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_current_camera()),
+        .defaultCameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_default_camera())
+    };
+    const size_t taskCount = rbe_ec_system_parallel_for_query_chunks(fontRenderingSystem, font_rendering_system_render_chunk, (void*) &context);
+    for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++) {
+        rbe_renderer_submit_command_buffer(&fontCommandBuffers[taskIndex]);
+    }
+}
+
+void font_rendering_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context) {
+    const FontRenderingChunkContext* chunkContext = (FontRenderingChunkContext*) context;
+    RBERenderCommandBuffer* commandBuffer = &fontCommandBuffers[taskIndex];
+    Transform2DComponent* transforms = (Transform2DComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_TRANSFORM_2D);
+    TextLabelComponent* textLabels = (TextLabelComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_TEXT_LABEL);
+    // Meshes only need rebuilding for labels that were written since the last render, or that were left dirty by a
+    // write that didn't mark the change
+    const bool hasTextLabelsChanged = component_query_chunk_has_changed(chunk, ComponentDataIndex_TEXT_LABEL, system->last_change_tick);
+    const uint32_t* textLabelChangeTicks = component_query_chunk_get_change_ticks(chunk, ComponentDataIndex_TEXT_LABEL);
+    for (size_t i = 0; i < chunk->count; i++) {
+        const Entity entity = chunk->entities[i];
+        if (!rbe_ec_system_has_entity(entity, system)) {
+            continue;
+        }
+        Transform2DComponent* fontTransformComp = &transforms[i];
+        TextLabelComponent* textLabelComponent = &textLabels[i];
         const TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, fontTransformComp);
+        const float scale = fontTransformComp->localTransform.scale.x * globalTransform->scale.x;
+        FontTextMesh* textMesh = &textLabelComponent->textMesh;
+        if (textMesh->isDirty || (hasTextLabelsChanged && textLabelChangeTicks[i] > system->last_change_tick)) {
+            font_text_mesh_update(textMesh, textLabelComponent->font, textLabelComponent->text);
+        }
+        // Text ignores rotation so its bounds come straight from the global position
+        const Rect2 textBounds = {
+            globalTransform->position.x + textMesh->bounds.x * scale,
+            globalTransform->position.y + textMesh->bounds.y * scale,
+            textMesh->bounds.w * scale,
+            textMesh->bounds.h * scale
+        };
+        const Rect2* viewRect = fontTransformComp->ignoreCamera ? &chunkContext->defaultCameraViewRect : &chunkContext->cameraViewRect;
+        if (!rbe_math_does_rect2_intersect(&textBounds, viewRect)) {
+            continue;
+        }
 
-        rbe_renderer_queue_font_draw_call(
-            textLabelComponent->font,
-            textLabelComponent->text,
-            (globalTransform->position.x - renderCamera->viewport.x + renderCamera->offset.x) * renderCamera->zoom.x,
-            (globalTransform->position.y - renderCamera->viewport.y + renderCamera->offset.y) * renderCamera->zoom.y,
-            fontTransformComp->localTransform.scale.x * globalTransform->scale.x * renderCamera->zoom.x,
-            textLabelComponent->color
+        rbe_renderer_command_buffer_queue_font_draw_call(
+            commandBuffer,
+            textMesh,
+            globalTransform->position.x,
+            globalTransform->position.y,
+            scale,
+            textLabelComponent->color,
+            fontTransformComp->ignoreCamera,
+            rbe_scene_manager_get_scene_node_global_z_index(entity, fontTransformComp),
+            RenderLayer_DEFAULT
         );
     }
 }
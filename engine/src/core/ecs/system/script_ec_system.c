@@ -34,7 +34,10 @@ EntitySystem* script_ec_system_create() {
     scriptSystem->process_func = script_system_instance_update;
     scriptSystem->physics_process_func = script_system_instance_physics_update;
     scriptSystem->network_callback_func = script_system_network_callback;
-    scriptSystem->component_signature = ComponentType_SCRIPT;
+    scriptSystem->component_signature = component_signature_create(ComponentType_SCRIPT);
+    // Scripts can access any component from python
+    scriptSystem->read_components = component_signature_create_full();
+    scriptSystem->write_components = component_signature_create_full();
     // Python Context
     scriptContexts[ScriptContextType_PYTHON] = rbe_py_create_script_context();
     scriptContextsCount++;
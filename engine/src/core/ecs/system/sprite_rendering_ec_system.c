@@ -14,46 +14,72 @@
 
 EntitySystem* spriteRenderingSystem = NULL;
 
+// Each task records into its own command buffer, submitted in task order to keep draw order stable
+typedef struct SpriteRenderingChunkContext {
+    Rect2 cameraViewRect;
+    Rect2 defaultCameraViewRect;
+} SpriteRenderingChunkContext;
+static RBERenderCommandBuffer spriteCommandBuffers[ENTITY_SYSTEM_MAX_TASKS];
+
 void sprite_rendering_system_render();
+void sprite_rendering_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context);
 
 EntitySystem* sprite_rendering_ec_system_create() {
     RBE_ASSERT(spriteRenderingSystem == NULL);
     spriteRenderingSystem = rbe_ec_system_create();
     spriteRenderingSystem->name = rbe_strdup("Sprite Rendering");
     spriteRenderingSystem->render_func = sprite_rendering_system_render;
-    spriteRenderingSystem->component_signature = ComponentType_TRANSFORM_2D | ComponentType_SPRITE;
+    spriteRenderingSystem->component_signature = component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_SPRITE);
+    // Culling writes the global transform and bounds caches kept in the transform component
+    spriteRenderingSystem->read_components = component_signature_create(ComponentType_SPRITE);
+    spriteRenderingSystem->write_components = component_signature_create(ComponentType_TRANSFORM_2D);
+    spriteRenderingSystem->is_main_thread_only = false;
     return spriteRenderingSystem;
 }
 
 void sprite_rendering_system_render() {
-    const RBECamera2D* camera2D = rbe_camera_manager_get_current_camera();
-    const RBECamera2D* defaultCamera = rbe_camera_manager_get_default_camera();
-
-    for (size_t i = 0; i < spriteRenderingSystem->entity_count; i++) {
-        const Entity entity = spriteRenderingSystem->entities[i];
-        Transform2DComponent* spriteTransformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
-        const SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component(entity, ComponentDataIndex_SPRITE);
-        const RBECamera2D* renderCamera = spriteTransformComp->ignoreCamera ? defaultCamera : camera2D;
-        TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, spriteTransformComp);
-        spriteTransformComp->isGlobalTransformDirty = true; // TODO: Make global transform const
-        const Size2D destinationSize = {
-            spriteComponent->drawSource.w * renderCamera->zoom.x,
-            spriteComponent->drawSource.h * renderCamera->zoom.y
-        };
-        glm_translate(globalTransform->model, (vec3) {
-            (renderCamera->offset.x - (renderCamera->viewport.x * globalTransform->scaleSign.x) - spriteComponent->origin.x) * renderCamera->zoom.x,
-            (renderCamera->offset.y - (renderCamera->viewport.y * globalTransform->scaleSign.y) - spriteComponent->origin.y) * renderCamera->zoom.y,
-            0.0f
-        });
-
-        rbe_renderer_queue_sprite_draw_call(
+    const SpriteRenderingChunkContext context = {
+        .cameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_current_camera()),
+        .defaultCameraViewRect = rbe_camera2d_get_world_view_rect(rbe_camera_manager_get_default_camera())
+    };
+    const size_t taskCount = rbe_ec_system_parallel_for_query_chunks(spriteRenderingSystem, sprite_rendering_system_render_chunk, (void*) &context);
+    for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++) {
+        rbe_renderer_submit_command_buffer(&spriteCommandBuffers[taskIndex]);
+    }
+}
+
+void sprite_rendering_system_render_chunk(EntitySystem* system, const ComponentQueryChunk* chunk, size_t taskIndex, void* context) {
+    const SpriteRenderingChunkContext* chunkContext = (SpriteRenderingChunkContext*) context;
+    RBERenderCommandBuffer* commandBuffer = &spriteCommandBuffers[taskIndex];
+    Transform2DComponent* transforms = (Transform2DComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_TRANSFORM_2D);
+    const SpriteComponent* sprites = (SpriteComponent*) component_query_chunk_get_components(chunk, ComponentDataIndex_SPRITE);
+    for (size_t i = 0; i < chunk->count; i++) {
+        const Entity entity = chunk->entities[i];
+        if (!rbe_ec_system_has_entity(entity, system)) {
+            continue;
+        }
+        Transform2DComponent* spriteTransformComp = &transforms[i];
+        const SpriteComponent* spriteComponent = &sprites[i];
+        const Rect2 localRect = { -spriteComponent->origin.x, -spriteComponent->origin.y, spriteComponent->drawSource.w, spriteComponent->drawSource.h };
+        const Rect2* viewRect = spriteTransformComp->ignoreCamera ? &chunkContext->defaultCameraViewRect : &chunkContext->cameraViewRect;
+        if (!rbe_math_does_rect2_intersect(rbe_scene_manager_get_scene_node_global_bounds(entity, spriteTransformComp, &localRect), viewRect)) {
+            continue;
+        }
+        const TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, spriteTransformComp);
+        const Size2D destinationSize = { spriteComponent->drawSource.w, spriteComponent->drawSource.h };
+        rbe_renderer_command_buffer_queue_sprite_draw_call(
+            commandBuffer,
             spriteComponent->texture,
             spriteComponent->drawSource,
             destinationSize,
+            spriteComponent->origin,
             spriteComponent->modulate,
             spriteComponent->flipX,
             spriteComponent->flipY,
-            globalTransform
+            globalTransform,
+            spriteTransformComp->ignoreCamera,
+            rbe_scene_manager_get_scene_node_global_z_index(entity, spriteTransformComp),
+            RenderLayer_DEFAULT
         );
     }
 }
@@ -1,5 +1,7 @@
 #include "rbe_math.h"
 
+#include <float.h>
+
 // --- Color --- //
 Color rbe_color_get_normalized_color_default_alpha(unsigned int r, unsigned int g, unsigned int b) {
     Color color = {
@@ -26,6 +28,97 @@ Color rbe_color_get_white() {
     return white;
 }
 
+// --- Rect2 --- //
+bool rbe_math_does_rect2_intersect(const Rect2* rectA, const Rect2* rectB) {
+    return rectA->x < rectB->x + rectB->w && rectA->x + rectA->w > rectB->x
+           && rectA->y < rectB->y + rectB->h && rectA->y + rectA->h > rectB->y;
+}
+
+Rect2 rbe_math_get_transformed_rect2_bounds(const Affine2D* model, const Rect2* localRect) {
+    const float cornersX[4] = { localRect->x, localRect->x + localRect->w, localRect->x, localRect->x + localRect->w };
+    const float cornersY[4] = { localRect->y, localRect->y, localRect->y + localRect->h, localRect->y + localRect->h };
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int i = 0; i < 4; i++) {
+        const float x = model->linear[0] * cornersX[i] + model->linear[2] * cornersY[i] + model->translation[0];
+        const float y = model->linear[1] * cornersX[i] + model->linear[3] * cornersY[i] + model->translation[1];
+        minX = fminf(minX, x);
+        minY = fminf(minY, y);
+        maxX = fmaxf(maxX, x);
+        maxY = fmaxf(maxY, y);
+    }
+    const Rect2 bounds = { minX, minY, maxX - minX, maxY - minY };
+    return bounds;
+}
+
+// --- Affine2D --- //
+void rbe_math_affine2d_identity(Affine2D* affine) {
+    glm_vec4_copy((vec4) { 1.0f, 0.0f, 0.0f, 1.0f }, affine->linear);
+    glm_vec2_zero(affine->translation);
+}
+
+void rbe_math_affine2d_from_trs(Affine2D* affine, const Vector2* position, float rotation, const Vector2* scale) {
+    const float rotationRadians = glm_rad(rotation);
+    const float cosRotation = cosf(rotationRadians);
+    const float sinRotation = sinf(rotationRadians);
+    affine->linear[0] = cosRotation * scale->x;
+    affine->linear[1] = sinRotation * scale->x;
+    affine->linear[2] = -sinRotation * scale->y;
+    affine->linear[3] = cosRotation * scale->y;
+    affine->translation[0] = position->x;
+    affine->translation[1] = position->y;
+}
+
+void rbe_math_affine2d_mul(const Affine2D* parent, const Affine2D* child, Affine2D* dest) {
+    const float* p = parent->linear;
+    const float* c = child->linear;
+    // Both result columns at once, each is the parent's x axis and y axis weighted by the child's column
+    vec4 parentX = { p[0], p[1], p[0], p[1] };
+    vec4 parentY = { p[2], p[3], p[2], p[3] };
+    vec4 childX = { c[0], c[0], c[2], c[2] };
+    vec4 childY = { c[1], c[1], c[3], c[3] };
+    const float translationX = p[0] * child->translation[0] + p[2] * child->translation[1] + parent->translation[0];
+    const float translationY = p[1] * child->translation[0] + p[3] * child->translation[1] + parent->translation[1];
+    vec4 linear;
+    glm_vec4_mul(parentX, childX, linear);
+    glm_vec4_muladd(parentY, childY, linear);
+    glm_vec4_copy(linear, dest->linear);
+    dest->translation[0] = translationX;
+    dest->translation[1] = translationY;
+}
+
+bool rbe_math_affine2d_inverse(const Affine2D* affine, Affine2D* dest) {
+    const float* l = affine->linear;
+    const float determinant = l[0] * l[3] - l[1] * l[2];
+    if (fabsf(determinant) <= FLT_EPSILON) {
+        return false;
+    }
+    const float translationX = affine->translation[0];
+    const float translationY = affine->translation[1];
+    vec4 linear = { l[3], -l[1], -l[2], l[0] };
+    glm_vec4_scale(linear, 1.0f / determinant, dest->linear);
+    dest->translation[0] = -(dest->linear[0] * translationX + dest->linear[2] * translationY);
+    dest->translation[1] = -(dest->linear[1] * translationX + dest->linear[3] * translationY);
+    return true;
+}
+
+Vector2 rbe_math_affine2d_transform_point(const Affine2D* affine, Vector2 point) {
+    const Vector2 transformedPoint = {
+        .x = affine->linear[0] * point.x + affine->linear[2] * point.y + affine->translation[0],
+        .y = affine->linear[1] * point.x + affine->linear[3] * point.y + affine->translation[1]
+    };
+    return transformedPoint;
+}
+
+void rbe_math_affine2d_to_mat4(const Affine2D* affine, mat4 dest) {
+    glm_mat4_identity(dest);
+    dest[0][0] = affine->linear[0];
+    dest[0][1] = affine->linear[1];
+    dest[1][0] = affine->linear[2];
+    dest[1][1] = affine->linear[3];
+    dest[3][0] = affine->translation[0];
+    dest[3][1] = affine->translation[1];
+}
+
 // --- Misc --- //
 float rbe_math_map_to_range(float input, float inputLow, float inputHigh, float outputLow, float outputHigh) {
     return (((input - inputLow) / (inputHigh - inputLow)) * (outputHigh - outputLow) + outputLow);
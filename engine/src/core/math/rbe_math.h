@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdbool.h>
+
 #include <cglm/cglm.h>
 
 #define RBE_PI 3.14159265358979323846f
@@ -25,6 +27,13 @@ typedef struct Rect2 {
     float h;
 } Rect2;
 
+// --- Affine2D --- //
+// 2D affine transform, the linear part is a column major 2x2 matrix so it's composed with vec4 math
+typedef struct Affine2D {
+    vec4 linear; // x axis in 0 and 1, y axis in 2 and 3
+    vec2 translation;
+} Affine2D;
+
 //--- Transform2D ---//
 typedef struct Transform2D {
     Vector2 position;
@@ -36,8 +45,8 @@ typedef struct TransformModel2D {
     Vector2 position;
     Vector2 scale;
     float rotation; // degrees
-    Vector2 scaleSign;
-    mat4 model;
+    Vector2 scaleSign; // Reflections can't be told apart from rotations by the affine alone
+    Affine2D model;
 } TransformModel2D;
 
 // --- Vector3 --- //
@@ -59,6 +68,23 @@ Color rbe_color_get_normalized_color_default_alpha(unsigned int r, unsigned int
 Color rbe_color_get_normalized_color(unsigned int r, unsigned int g, unsigned int b, unsigned int a);
 Color rbe_color_get_white();
 
+// --- Rect2 --- //
+bool rbe_math_does_rect2_intersect(const Rect2* rectA, const Rect2* rectB);
+// Axis aligned bounds of 'localRect' after it's transformed by 'model'
+Rect2 rbe_math_get_transformed_rect2_bounds(const Affine2D* model, const Rect2* localRect);
+
+// --- Affine2D --- //
+void rbe_math_affine2d_identity(Affine2D* affine);
+// Translation, rotation (degrees) then scale, same order as the local transform
+void rbe_math_affine2d_from_trs(Affine2D* affine, const Vector2* position, float rotation, const Vector2* scale);
+// dest = parent * child, dest can be either of them
+void rbe_math_affine2d_mul(const Affine2D* parent, const Affine2D* child, Affine2D* dest);
+// Returns false and leaves dest untouched if the affine can't be inverted
+bool rbe_math_affine2d_inverse(const Affine2D* affine, Affine2D* dest);
+Vector2 rbe_math_affine2d_transform_point(const Affine2D* affine, Vector2 point);
+// Only used when handing a transform to the gpu
+void rbe_math_affine2d_to_mat4(const Affine2D* affine, mat4 dest);
+
 // --- Misc --- //
 float rbe_math_map_to_range(float input, float inputLow, float inputHigh, float outputLow, float outputHigh);
 float rbe_math_map_to_unit(float input, float inputLow, float inputHigh);
@@ -18,6 +18,14 @@ void* rbe_mem_allocate_c(int blocks, size_t size) {
     return memory;
 }
 
+void* rbe_mem_reallocate(void* memory, size_t size) {
+    void* reallocatedMemory = realloc(memory, size);
+    if (reallocatedMemory == NULL) {
+        rbe_logger_error("Out of memory or realloc failed!, size = %d", size);
+    }
+    return reallocatedMemory;
+}
+
 void rbe_mem_free(void* memory) {
     free(memory);
     memory = NULL;
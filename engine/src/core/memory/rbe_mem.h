@@ -15,11 +15,15 @@ rbe_mem_allocate(Size)
 #define RBE_MEM_ALLOCATE_SIZE_ZERO(Blocks, Size)             \
 rbe_mem_allocate_c(Blocks, Size)
 
+#define RBE_MEM_REALLOCATE(Memory, Size)             \
+rbe_mem_reallocate(Memory, Size)
+
 #define RBE_MEM_FREE(Memory)             \
 rbe_mem_free(Memory)
 
 void* rbe_mem_allocate(size_t size);
 void* rbe_mem_allocate_c(int blocks, size_t size);
+void* rbe_mem_reallocate(void* memory, size_t size);
 void rbe_mem_free(void* memory);
 
 #ifdef __cplusplus
@@ -1,5 +1,8 @@
 #include "font.h"
 
+#include <math.h>
+#include <string.h>
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -7,6 +10,19 @@
 #include "../memory/rbe_mem.h"
 #include "../utils/logger.h"
 
+#define FONT_CHARACTER_COUNT 128
+#define FONT_ATLAS_WIDTH 512
+// Gap between glyphs so linear filtering doesn't sample neighbouring glyphs
+#define FONT_ATLAS_PADDING 1
+
+typedef struct GlyphBitmap {
+    unsigned char* buffer;
+    int width;
+    int height;
+    int atlasX;
+    int atlasY;
+} GlyphBitmap;
+
 Font* font_create_font(const char* fileName, int size) {
     FT_Face face;
     Font* font = RBE_MEM_ALLOCATE(Font);
@@ -17,58 +33,136 @@ Font* font_create_font(const char* fileName, int size) {
     } else {
         // Set size to load glyphs, width set to 0 to dynamically adjust
         FT_Set_Pixel_Sizes(face, 0, size);
-        // Disable byte alignment restriction
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        // Load first 128 characters of ASCII set
-        for (unsigned char c = 0; c < 128; c++) { // 'c++' ;-)
+        // Load first 128 characters of ASCII set, copying the glyph bitmaps so they can be laid out in the atlas after
+        GlyphBitmap glyphs[FONT_CHARACTER_COUNT];
+        memset(glyphs, 0, sizeof(glyphs));
+        int widestGlyphWidth = 0;
+        for (unsigned char c = 0; c < FONT_CHARACTER_COUNT; c++) {
             // Load character glyph
             if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
                 rbe_logger_error("Freetype failed to load Glyph!");
                 continue;
             }
-            // Generate texture
-            GLuint textTexture;
-            glGenTextures(1, &textTexture);
-            glBindTexture(GL_TEXTURE_2D, textTexture);
-            glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RED,
-                face->glyph->bitmap.width,
-                face->glyph->bitmap.rows,
-                0,
-                GL_RED,
-                GL_UNSIGNED_BYTE,
-                face->glyph->bitmap.buffer
-            );
-            // Texture wrap and filter options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            // Create character struct
+            const FT_Bitmap* bitmap = &face->glyph->bitmap;
+            GlyphBitmap* glyph = &glyphs[c];
+            glyph->width = (int) bitmap->width;
+            glyph->height = (int) bitmap->rows;
+            if (glyph->width > 0 && glyph->height > 0) {
+                glyph->buffer = (unsigned char*) RBE_MEM_ALLOCATE_SIZE((size_t) (glyph->width * glyph->height));
+                for (int row = 0; row < glyph->height; row++) {
+                    memcpy(&glyph->buffer[row * glyph->width], &bitmap->buffer[row * bitmap->pitch], (size_t) glyph->width);
+                }
+            }
+            widestGlyphWidth = glyph->width > widestGlyphWidth ? glyph->width : widestGlyphWidth;
+            // Create character struct, texture coordinates are filled in once the atlas size is known
             Character character = {
-                .textureId = textTexture,
-                .size = { (float) face->glyph->bitmap.width, (float) face->glyph->bitmap.rows },
+                .size = { (float) glyph->width, (float) glyph->height },
                 .bearing = { (float) face->glyph->bitmap_left, (float) face->glyph->bitmap_top },
                 .advance = (GLuint) face->glyph->advance.x
             };
             font->characters[c] = character;
         }
+
+        // Lay glyphs out in rows, the atlas is widened for large font sizes so every glyph fits in a row
+        const int atlasWidth = widestGlyphWidth + FONT_ATLAS_PADDING > FONT_ATLAS_WIDTH ? widestGlyphWidth + FONT_ATLAS_PADDING : FONT_ATLAS_WIDTH;
+        int penX = 0;
+        int penY = 0;
+        int rowHeight = 0;
+        for (int c = 0; c < FONT_CHARACTER_COUNT; c++) {
+            GlyphBitmap* glyph = &glyphs[c];
+            if (penX + glyph->width + FONT_ATLAS_PADDING > atlasWidth) {
+                penX = 0;
+                penY += rowHeight + FONT_ATLAS_PADDING;
+                rowHeight = 0;
+            }
+            glyph->atlasX = penX;
+            glyph->atlasY = penY;
+            penX += glyph->width + FONT_ATLAS_PADDING;
+            rowHeight = glyph->height > rowHeight ? glyph->height : rowHeight;
+        }
+        const int atlasHeight = penY + rowHeight + FONT_ATLAS_PADDING;
+
+        // Copy glyphs into atlas
+        unsigned char* atlasData = (unsigned char*) RBE_MEM_ALLOCATE_SIZE_ZERO(atlasWidth * atlasHeight, sizeof(unsigned char));
+        for (int c = 0; c < FONT_CHARACTER_COUNT; c++) {
+            GlyphBitmap* glyph = &glyphs[c];
+            for (int row = 0; row < glyph->height; row++) {
+                memcpy(&atlasData[(glyph->atlasY + row) * atlasWidth + glyph->atlasX], &glyph->buffer[row * glyph->width], (size_t) glyph->width);
+            }
+            Character* character = &font->characters[c];
+            character->uvMin = (Vector2) {
+                (float) glyph->atlasX / (float) atlasWidth, (float) glyph->atlasY / (float) atlasHeight
+            };
+            character->uvMax = (Vector2) {
+                (float) (glyph->atlasX + glyph->width) / (float) atlasWidth, (float) (glyph->atlasY + glyph->height) / (float) atlasHeight
+            };
+            if (glyph->buffer != NULL) {
+                RBE_MEM_FREE(glyph->buffer);
+            }
+        }
+
+        // Generate texture
+        // Disable byte alignment restriction
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glGenTextures(1, &font->textureId);
+        glBindTexture(GL_TEXTURE_2D, font->textureId);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, atlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, atlasData);
+        // Texture wrap and filter options
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glBindTexture(GL_TEXTURE_2D, 0);
+        RBE_MEM_FREE(atlasData);
 
-        // configure VAO & VBO texture quads
-        glGenVertexArrays(1, &font->VAO);
-        glGenBuffers(1, &font->VBO);
-        glBindVertexArray(font->VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, font->VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), NULL);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
         font->isValid = true;
     }
     FT_Done_Face(face);
     return font;
 }
+
+void font_text_mesh_initialize(FontTextMesh* textMesh) {
+    textMesh->vertexCount = 0;
+    textMesh->bounds = (Rect2) { 0.0f, 0.0f, 0.0f, 0.0f };
+    textMesh->font = NULL;
+    textMesh->isDirty = true;
+}
+
+void font_text_mesh_update(FontTextMesh* textMesh, const Font* font, const char* text) {
+    if (!textMesh->isDirty && textMesh->font == font) {
+        return;
+    }
+    float x = 0.0f;
+    float minY = 0.0f;
+    float maxY = 0.0f;
+    size_t glyphCount = 0;
+    for (const char* c = text; *c != '\0' && glyphCount < FONT_TEXT_MESH_MAX_GLYPHS; c++) {
+        const unsigned char characterIndex = (unsigned char) *c;
+        if (characterIndex >= FONT_CHARACTER_COUNT) {
+            continue;
+        }
+        const Character* ch = &font->characters[characterIndex];
+        const float xPos = x + ch->bearing.x;
+        const float yPos = ch->size.y - ch->bearing.y; // Bottom of the glyph, y points down like sprites
+        const float w = ch->size.x;
+        const float h = ch->size.y;
+        const GLfloat glyphVerts[FONT_TEXT_MESH_VERTICES_PER_GLYPH][4] = {
+            {xPos,     yPos - h, ch->uvMin.x, ch->uvMin.y},
+            {xPos,     yPos,     ch->uvMin.x, ch->uvMax.y},
+            {xPos + w, yPos,     ch->uvMax.x, ch->uvMax.y},
+
+            {xPos,     yPos - h, ch->uvMin.x, ch->uvMin.y},
+            {xPos + w, yPos,     ch->uvMax.x, ch->uvMax.y},
+            {xPos + w, yPos - h, ch->uvMax.x, ch->uvMin.y}
+        };
+        memcpy(textMesh->vertices[glyphCount * FONT_TEXT_MESH_VERTICES_PER_GLYPH], glyphVerts, sizeof(glyphVerts));
+        glyphCount++;
+        minY = fminf(minY, yPos - h);
+        maxY = fmaxf(maxY, yPos);
+        x += (float) (ch->advance >> 6); // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+    }
+    textMesh->vertexCount = glyphCount * FONT_TEXT_MESH_VERTICES_PER_GLYPH;
+    textMesh->bounds = (Rect2) { 0.0f, minY, x, maxY - minY };
+    textMesh->font = font;
+    textMesh->isDirty = false;
+}
@@ -7,18 +7,35 @@
 #include "../math/rbe_math.h"
 
 typedef struct Character {
-    GLuint textureId;
     Vector2 size;
     Vector2 bearing;
     unsigned int advance;
+    // Texture coordinates of the glyph within the font's atlas texture
+    Vector2 uvMin;
+    Vector2 uvMax;
 } Character;
 
 typedef struct Font {
     bool isValid;
-    GLuint VAO;
-    GLuint VBO;
+    GLuint textureId; // Glyph atlas
     int size;
     Character characters[128]; // First 128 of ASCII set
 } Font;
 
+#define FONT_TEXT_MESH_MAX_GLYPHS 64
+#define FONT_TEXT_MESH_VERTICES_PER_GLYPH 6
+
+// Glyph quads for a line of text laid out at scale 1, starting at the origin with the baseline at y = 0.
+// Layout is cached until the mesh is flagged dirty or drawn with another font.
+typedef struct FontTextMesh {
+    GLfloat vertices[FONT_TEXT_MESH_MAX_GLYPHS * FONT_TEXT_MESH_VERTICES_PER_GLYPH][4]; // (pos, tex)
+    size_t vertexCount;
+    Rect2 bounds;
+    const Font* font;
+    bool isDirty;
+} FontTextMesh;
+
 Font* font_create_font(const char* fileName, int size);
+void font_text_mesh_initialize(FontTextMesh* textMesh);
+// Lays out the text again only if it's dirty or the font changed
+void font_text_mesh_update(FontTextMesh* textMesh, const Font* font, const char* text);
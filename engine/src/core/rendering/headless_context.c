@@ -0,0 +1,219 @@
+#include "headless_context.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glad/glad.h>
+
+#include "../memory/rbe_mem.h"
+#include "../utils/logger.h"
+#include "../utils/rbe_assert.h"
+
+#ifdef RBE_HEADLESS_RENDERING
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#define HEADLESS_DUMP_DIRECTORY_CAPACITY 128
+
+typedef struct HeadlessContext {
+    EGLDisplay display;
+    EGLContext context;
+    GLuint framebuffer;
+    GLuint colorRenderbuffer;
+    GLuint depthStencilRenderbuffer;
+    int width;
+    int height;
+    unsigned int frameCount;
+    bool logChecksums;
+    char dumpDirectory[HEADLESS_DUMP_DIRECTORY_CAPACITY];
+    unsigned char* pixels; // Only allocated when frames are captured
+} HeadlessContext;
+
+static HeadlessContext headlessContext;
+
+EGLDisplay headless_context_get_display();
+bool headless_context_create_framebuffer(int width, int height);
+uint64_t headless_context_get_pixels_checksum(const unsigned char* pixels, size_t size);
+void headless_context_write_ppm(const char* filePath, const unsigned char* pixels, int width, int height);
+
+bool rbe_headless_context_initialize(int width, int height, RBEHeadlessFrameCapture frameCapture) {
+    RBE_ASSERT(headlessContext.display == EGL_NO_DISPLAY);
+    headlessContext.display = headless_context_get_display();
+    if (headlessContext.display == EGL_NO_DISPLAY) {
+        rbe_logger_error("Failed to get an egl display!");
+        return false;
+    }
+    EGLint majorVersion, minorVersion;
+    if (!eglInitialize(headlessContext.display, &majorVersion, &minorVersion)) {
+        rbe_logger_error("Failed to initialize egl!");
+        return false;
+    }
+    rbe_logger_debug("Initialized egl v%d.%d", majorVersion, minorVersion);
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        rbe_logger_error("Failed to bind the egl OpenGL api!");
+        return false;
+    }
+
+    // Same OpenGL version as the windowed context, nothing is drawn to the default framebuffer so no config is needed
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    headlessContext.context = eglCreateContext(headlessContext.display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+    if (headlessContext.context == EGL_NO_CONTEXT) {
+        rbe_logger_error("Failed to create egl context, error = '0x%x'!", eglGetError());
+        return false;
+    }
+    if (!eglMakeCurrent(headlessContext.display, EGL_NO_SURFACE, EGL_NO_SURFACE, headlessContext.context)) {
+        rbe_logger_error("Failed to make egl context current, error = '0x%x'!", eglGetError());
+        return false;
+    }
+
+    // Initialize Glad
+    if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress)) {
+        rbe_logger_error("Couldn't initialize glad!");
+        return false;
+    }
+
+    if (!headless_context_create_framebuffer(width, height)) {
+        rbe_logger_error("Failed to create headless framebuffer!");
+        return false;
+    }
+
+    headlessContext.frameCount = 0;
+    headlessContext.logChecksums = frameCapture.logChecksums;
+    memset(headlessContext.dumpDirectory, 0, HEADLESS_DUMP_DIRECTORY_CAPACITY);
+    if (frameCapture.dumpDirectory != NULL) {
+        strncpy(headlessContext.dumpDirectory, frameCapture.dumpDirectory, HEADLESS_DUMP_DIRECTORY_CAPACITY - 1);
+    }
+    if (headlessContext.logChecksums || headlessContext.dumpDirectory[0] != '\0') {
+        headlessContext.pixels = (unsigned char*) RBE_MEM_ALLOCATE_SIZE((size_t) width * (size_t) height * 4);
+    }
+    rbe_logger_info("Headless rendering into a '%dx%d' framebuffer with renderer '%s'", width, height, glGetString(GL_RENDERER));
+    return true;
+}
+
+void rbe_headless_context_finalize() {
+    if (headlessContext.framebuffer != 0) {
+        glDeleteFramebuffers(1, &headlessContext.framebuffer);
+        glDeleteRenderbuffers(1, &headlessContext.colorRenderbuffer);
+        glDeleteRenderbuffers(1, &headlessContext.depthStencilRenderbuffer);
+    }
+    if (headlessContext.pixels != NULL) {
+        RBE_MEM_FREE(headlessContext.pixels);
+    }
+    if (headlessContext.display != EGL_NO_DISPLAY) {
+        eglMakeCurrent(headlessContext.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (headlessContext.context != EGL_NO_CONTEXT) {
+            eglDestroyContext(headlessContext.display, headlessContext.context);
+        }
+        eglTerminate(headlessContext.display);
+    }
+    memset(&headlessContext, 0, sizeof(HeadlessContext));
+}
+
+void rbe_headless_context_end_frame() {
+    const unsigned int frameIndex = headlessContext.frameCount++;
+    if (headlessContext.pixels == NULL) {
+        // Nothing waits on the gpu without captures, flush so queued frames don't pile up
+        glFlush();
+        return;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, headlessContext.width, headlessContext.height, GL_RGBA, GL_UNSIGNED_BYTE, headlessContext.pixels);
+    if (headlessContext.logChecksums) {
+        const size_t size = (size_t) headlessContext.width * (size_t) headlessContext.height * 4;
+        rbe_logger_info("frame '%u' checksum = '%016llx'", frameIndex, (unsigned long long) headless_context_get_pixels_checksum(headlessContext.pixels, size));
+    }
+    if (headlessContext.dumpDirectory[0] != '\0') {
+        char filePath[HEADLESS_DUMP_DIRECTORY_CAPACITY + 32];
+        snprintf(filePath, sizeof(filePath), "%s/frame_%06u.ppm", headlessContext.dumpDirectory, frameIndex);
+        headless_context_write_ppm(filePath, headlessContext.pixels, headlessContext.width, headlessContext.height);
+    }
+}
+
+unsigned int rbe_headless_context_get_frame_count() {
+    return headlessContext.frameCount;
+}
+
+// Prefers mesa's surfaceless platform which works without any display server
+EGLDisplay headless_context_get_display() {
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions != NULL && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") != NULL) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay != NULL) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            if (display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool headless_context_create_framebuffer(int width, int height) {
+    headlessContext.width = width;
+    headlessContext.height = height;
+    glGenFramebuffers(1, &headlessContext.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, headlessContext.framebuffer);
+    // Color
+    glGenRenderbuffers(1, &headlessContext.colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, headlessContext.colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, headlessContext.colorRenderbuffer);
+    // Depth and stencil, matches the windowed context's attributes
+    glGenRenderbuffers(1, &headlessContext.depthStencilRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, headlessContext.depthStencilRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, headlessContext.depthStencilRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // Stays bound for the lifetime of the context so the renderer draws into it like the default framebuffer
+    glViewport(0, 0, width, height);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+// FNV-1a
+uint64_t headless_context_get_pixels_checksum(const unsigned char* pixels, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= pixels[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Pixels are read bottom up, ppm rows go top down
+void headless_context_write_ppm(const char* filePath, const unsigned char* pixels, int width, int height) {
+    FILE* file = fopen(filePath, "wb");
+    if (file == NULL) {
+        rbe_logger_error("Failed to open '%s' to write frame!", filePath);
+        return;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int y = height - 1; y >= 0; y--) {
+        const unsigned char* row = &pixels[(size_t) y * (size_t) width * 4];
+        for (int x = 0; x < width; x++) {
+            fwrite(&row[x * 4], 1, 3, file);
+        }
+    }
+    fclose(file);
+}
+
+#else
+bool rbe_headless_context_initialize(int width, int height, RBEHeadlessFrameCapture frameCapture) {
+    rbe_logger_error("Headless rendering isn't available, build with 'RBE_HEADLESS_RENDERING' enabled!");
+    return false;
+}
+
+void rbe_headless_context_finalize() {}
+
+void rbe_headless_context_end_frame() {}
+
+unsigned int rbe_headless_context_get_frame_count() {
+    return 0;
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Offscreen OpenGL context that renders into a framebuffer object without a window or display server.
+// Requires building with RBE_HEADLESS_RENDERING as it creates a surfaceless EGL context.
+typedef struct RBEHeadlessFrameCapture {
+    bool logChecksums; // Logs a checksum of every frame's pixels
+    const char* dumpDirectory; // Writes every frame as a ppm image when not empty
+} RBEHeadlessFrameCapture;
+
+bool rbe_headless_context_initialize(int width, int height, RBEHeadlessFrameCapture frameCapture);
+void rbe_headless_context_finalize();
+// Called in place of a buffer swap once a frame is rendered
+void rbe_headless_context_end_frame();
+unsigned int rbe_headless_context_get_frame_count();
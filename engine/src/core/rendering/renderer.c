@@ -1,15 +1,21 @@
 #include "renderer.h"
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <cglm/cglm.h>
 
 #include "render_context.h"
 #include "shader.h"
 #include "shader_source.h"
+#include "stream_buffer.h"
 #include "../game_properties.h"
-#include "../data_structures/rbe_static_array.h"
+#include "../camera/camera.h"
+#include "../camera/camera_manager.h"
 #include "../memory/rbe_mem.h"
+#include "../thread/rbe_pthread.h"
 #include "../utils/rbe_assert.h"
 
 typedef struct TextureCoordinates {
@@ -21,207 +27,439 @@ typedef struct TextureCoordinates {
 
 void sprite_renderer_initialize();
 void sprite_renderer_finalize();
-void sprite_renderer_draw_sprite(const Texture* texture, const Rect2* sourceRect, const Size2D* destSize, const Color *color, bool flipX, bool flipY, TransformModel2D* globalTransform);
 void font_renderer_initialize();
-void font_renderer_draw_text(const Font* font, const char* text, float x, float y, float scale, const Color* color);
 void font_renderer_finalize();
+void renderer_queue_initialize();
+void renderer_queue_finalize();
 
 TextureCoordinates renderer_get_texture_coordinates(const Texture* texture, const Rect2* drawSource, bool flipX, bool flipY);
 void renderer_print_opengl_errors();
 
 static GLuint spriteQuadVAO;
-static GLuint spriteQuadVBO;
+static GLuint fontVAO;
 
 static Shader* spriteShader = NULL;
 static Shader* fontShader = NULL;
 
+// Camera data shared by all shaders through the 'Camera' uniform block, laid out with std140
+#define CAMERA_UNIFORM_BLOCK_BINDING 0
+
+// Index into the 'views' array of the camera uniform block
+typedef enum CameraViewIndex {
+    CameraViewIndex_CURRENT = 0,
+    CameraViewIndex_DEFAULT = 1, // Used by draws that ignore the camera
+    CameraViewIndex_COUNT = 2,
+} CameraViewIndex;
+
+typedef struct CameraUniformBlock {
+    mat4 projection;
+    mat4 views[CameraViewIndex_COUNT];
+} CameraUniformBlock;
+
+static GLuint cameraUniformBuffer;
+
+void renderer_camera_uniform_buffer_initialize();
+void renderer_camera_uniform_buffer_finalize();
+void renderer_camera_uniform_buffer_update_views();
+void renderer_camera_get_view_matrix(const RBECamera2D* camera2D, mat4 view);
+
 // --- Renderer --- //
 void rbe_renderer_initialize() {
     glEnable(GL_CULL_FACE);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     rbe_render_context_initialize();
+    rbe_stream_buffer_initialize();
+    renderer_camera_uniform_buffer_initialize();
     sprite_renderer_initialize();
     font_renderer_initialize();
+    renderer_queue_initialize();
 }
 
 void rbe_renderer_finalize() {
     font_renderer_finalize();
     sprite_renderer_finalize();
+    renderer_camera_uniform_buffer_finalize();
+    rbe_stream_buffer_finalize();
     rbe_render_context_finalize();
+    renderer_queue_finalize();
+}
+
+void renderer_camera_uniform_buffer_initialize() {
+    CameraUniformBlock cameraBlock;
+    RBEGameProperties* gameProperties = rbe_game_props_get();
+    glm_ortho(0.0f, (float) gameProperties->resolutionWidth, (float) gameProperties->resolutionHeight, 0.0f, -1.0f, 1.0f, cameraBlock.projection);
+    for (int i = 0; i < CameraViewIndex_COUNT; i++) {
+        glm_mat4_identity(cameraBlock.views[i]);
+    }
+    glGenBuffers(1, &cameraUniformBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniformBlock), &cameraBlock, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORM_BLOCK_BINDING, cameraUniformBuffer);
+}
+
+void renderer_camera_uniform_buffer_finalize() {
+    glDeleteBuffers(1, &cameraUniformBuffer);
+    cameraUniformBuffer = 0;
+}
+
+// Uploaded once per frame, the projection doesn't change after initialization
+void renderer_camera_uniform_buffer_update_views() {
+    mat4 views[CameraViewIndex_COUNT];
+    renderer_camera_get_view_matrix(rbe_camera_manager_get_current_camera(), views[CameraViewIndex_CURRENT]);
+    renderer_camera_get_view_matrix(rbe_camera_manager_get_default_camera(), views[CameraViewIndex_DEFAULT]);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUniformBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(CameraUniformBlock, views), sizeof(views), views);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Moves world space into the camera's viewport then zooms
+void renderer_camera_get_view_matrix(const RBECamera2D* camera2D, mat4 view) {
+    glm_mat4_identity(view);
+    glm_scale(view, (vec3) {
+        camera2D->zoom.x, camera2D->zoom.y, 1.0f
+    });
+    glm_translate(view, (vec3) {
+        camera2D->offset.x - camera2D->viewport.x, camera2D->offset.y - camera2D->viewport.y, 0.0f
+    });
 }
 
-// --- Sprite Batching --- //
+// --- Render Queue --- //
 typedef struct SpriteBatchItem {
     Texture* texture;
     Rect2 sourceRect;
     Size2D destSize;
+    Vector2 origin;
     Color color;
     bool flipX;
     bool flipY;
-    TransformModel2D* globalTransform;
+    CameraViewIndex viewIndex;
+    Affine2D model; // Copied on submission as the global transform can change before the queue is flushed
 } SpriteBatchItem;
 
 typedef struct FontBatchItem {
-    Font* font;
-    const char* text;
+    const FontTextMesh* textMesh;
     float x;
     float y;
     float scale;
     Color color;
-    Transform2DComponent* transform2DComponent;
+    CameraViewIndex viewIndex;
 } FontBatchItem;
 
-RBE_STATIC_ARRAY_CREATE(SpriteBatchItem, 100, sprite_batch_items);
-RBE_STATIC_ARRAY_CREATE(FontBatchItem, 100, font_batch_items);
+typedef enum RenderCommandType {
+    RenderCommandType_SPRITE = 0,
+    RenderCommandType_FONT = 1,
+} RenderCommandType;
+
+typedef struct RenderCommand {
+    RenderCommandType type;
+    union {
+        SpriteBatchItem sprite;
+        FontBatchItem font;
+    };
+} RenderCommand;
+
+// Sort key layout, from most to least significant bits:
+// | layer (4) | z index (16) | shader (4) | texture (16) | submission order (24) |
+// Submission order is also the index of the key's command in the queue.
+#define RENDER_SORT_KEY_ORDER_BITS 24
+#define RENDER_SORT_KEY_TEXTURE_BITS 16
+#define RENDER_SORT_KEY_SHADER_BITS 4
+#define RENDER_SORT_KEY_Z_INDEX_BITS 16
+#define RENDER_SORT_KEY_TEXTURE_SHIFT RENDER_SORT_KEY_ORDER_BITS
+#define RENDER_SORT_KEY_SHADER_SHIFT (RENDER_SORT_KEY_TEXTURE_SHIFT + RENDER_SORT_KEY_TEXTURE_BITS)
+#define RENDER_SORT_KEY_Z_INDEX_SHIFT (RENDER_SORT_KEY_SHADER_SHIFT + RENDER_SORT_KEY_SHADER_BITS)
+#define RENDER_SORT_KEY_LAYER_SHIFT (RENDER_SORT_KEY_Z_INDEX_SHIFT + RENDER_SORT_KEY_Z_INDEX_BITS)
+#define RENDER_SORT_KEY_MAX_COMMANDS (1u << RENDER_SORT_KEY_ORDER_BITS)
+#define RENDER_SORT_KEY_GET_ORDER(KEY) ((size_t) ((KEY) & (RENDER_SORT_KEY_MAX_COMMANDS - 1)))
+
+#define RENDER_QUEUE_INITIAL_CAPACITY 256
+
+// Sprites are drawn as instanced quads, each instance is a model matrix, texture rect, color, size with origin and view index
+#define SPRITE_BATCH_VERTICES_PER_SPRITE 6
+#define SPRITE_BATCH_INSTANCE_STRIDE 29
+// Keeps a batch's instance data within a single stream buffer allocation
+#define SPRITE_BATCH_MAX_SPRITES 16384
+
+#define FONT_BATCH_VERTEX_STRIDE 9
+
+void sprite_renderer_draw_sprite_batch(const uint64_t* sortKeys, size_t count);
+void font_renderer_draw_text_batch(const uint64_t* sortKeys, size_t count);
+
+// Sort keys in command buffers hold the index within the buffer, rebased onto the queue on submit
+static RBERenderCommandBuffer renderQueue;
+static uint64_t* renderSortKeysScratch = NULL;
+static size_t renderSortKeysScratchCapacity = 0;
+// Render systems can queue draw calls and submit command buffers from worker threads
+static pthread_mutex_t renderQueueMutex;
+
+RenderCommand* renderer_command_buffer_push_command(RBERenderCommandBuffer* commandBuffer, RenderLayer layer, int zIndex, RenderCommandType type, GLuint textureId);
+void renderer_command_buffer_reserve(RBERenderCommandBuffer* commandBuffer, size_t capacity);
+void renderer_radix_sort_keys(uint64_t* keys, uint64_t* scratch, size_t count);
+
+void rbe_renderer_queue_sprite_draw_call(Texture* texture, Rect2 sourceRect, Size2D destSize, Vector2 origin, Color color, bool flipX, bool flipY, const TransformModel2D* globalTransform, bool ignoreCamera, int zIndex, RenderLayer layer) {
+    pthread_mutex_lock(&renderQueueMutex);
+    rbe_renderer_command_buffer_queue_sprite_draw_call(&renderQueue, texture, sourceRect, destSize, origin, color, flipX, flipY, globalTransform, ignoreCamera, zIndex, layer);
+    pthread_mutex_unlock(&renderQueueMutex);
+}
+
+void rbe_renderer_queue_font_draw_call(const FontTextMesh* textMesh, float x, float y, float scale, Color color, bool ignoreCamera, int zIndex, RenderLayer layer) {
+    pthread_mutex_lock(&renderQueueMutex);
+    rbe_renderer_command_buffer_queue_font_draw_call(&renderQueue, textMesh, x, y, scale, color, ignoreCamera, zIndex, layer);
+    pthread_mutex_unlock(&renderQueueMutex);
+}
 
-void rbe_renderer_queue_sprite_draw_call(Texture* texture, Rect2 sourceRect, const Size2D destSize, Color color, bool flipX, bool flipY, TransformModel2D* globalTransform) {
+void rbe_renderer_command_buffer_queue_sprite_draw_call(RBERenderCommandBuffer* commandBuffer, Texture* texture, Rect2 sourceRect, Size2D destSize, Vector2 origin, Color color, bool flipX, bool flipY, const TransformModel2D* globalTransform, bool ignoreCamera, int zIndex, RenderLayer layer) {
     if (texture == NULL) {
         rbe_logger_error("NULL texture, not submitting draw call!");
         return;
     }
-    SpriteBatchItem item = { .texture = texture, .sourceRect = sourceRect, .destSize = destSize, .color = color, .flipX = flipX, .flipY = flipY, .globalTransform = globalTransform };
-    RBE_STATIC_ARRAY_ADD(sprite_batch_items, item);
+    RenderCommand* command = renderer_command_buffer_push_command(commandBuffer, layer, zIndex, RenderCommandType_SPRITE, texture->id);
+    SpriteBatchItem* item = &command->sprite;
+    item->texture = texture;
+    item->sourceRect = sourceRect;
+    item->destSize = destSize;
+    item->origin = origin;
+    item->color = color;
+    item->flipX = flipX;
+    item->flipY = flipY;
+    item->viewIndex = ignoreCamera ? CameraViewIndex_DEFAULT : CameraViewIndex_CURRENT;
+    item->model = globalTransform->model;
+}
+
+void rbe_renderer_command_buffer_queue_font_draw_call(RBERenderCommandBuffer* commandBuffer, const FontTextMesh* textMesh, float x, float y, float scale, Color color, bool ignoreCamera, int zIndex, RenderLayer layer) {
+    RBE_ASSERT_FMT(textMesh->font != NULL && !textMesh->isDirty, "Text mesh must be updated before being queued!");
+    RenderCommand* command = renderer_command_buffer_push_command(commandBuffer, layer, zIndex, RenderCommandType_FONT, textMesh->font->textureId);
+    command->font = (FontBatchItem) {
+        .textMesh = textMesh, .x = x, .y = y, .scale = scale, .color = color,
+        .viewIndex = ignoreCamera ? CameraViewIndex_DEFAULT : CameraViewIndex_CURRENT
+    };
+}
+
+void rbe_renderer_submit_command_buffer(RBERenderCommandBuffer* commandBuffer) {
+    if (commandBuffer->count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&renderQueueMutex);
+    RBE_ASSERT_FMT(renderQueue.count + commandBuffer->count <= RENDER_SORT_KEY_MAX_COMMANDS, "Render queue is full at '%zu' commands!", renderQueue.count);
+    renderer_command_buffer_reserve(&renderQueue, renderQueue.count + commandBuffer->count);
+    memcpy(&renderQueue.commands[renderQueue.count], commandBuffer->commands, commandBuffer->count * sizeof(RenderCommand));
+    for (size_t i = 0; i < commandBuffer->count; i++) {
+        renderQueue.sortKeys[renderQueue.count + i] = (commandBuffer->sortKeys[i] & ~(uint64_t) (RENDER_SORT_KEY_MAX_COMMANDS - 1)) | (uint64_t) (renderQueue.count + i);
+    }
+    renderQueue.count += commandBuffer->count;
+    pthread_mutex_unlock(&renderQueueMutex);
+    commandBuffer->count = 0;
+}
+
+void rbe_renderer_command_buffer_free(RBERenderCommandBuffer* commandBuffer) {
+    RBE_MEM_FREE(commandBuffer->commands);
+    RBE_MEM_FREE(commandBuffer->sortKeys);
+    *commandBuffer = (RBERenderCommandBuffer) { .commands = NULL, .sortKeys = NULL, .count = 0, .capacity = 0 };
+}
+
+void renderer_command_buffer_reserve(RBERenderCommandBuffer* commandBuffer, size_t capacity) {
+    if (capacity <= commandBuffer->capacity) {
+        return;
+    }
+    size_t newCapacity = commandBuffer->capacity == 0 ? RENDER_QUEUE_INITIAL_CAPACITY : commandBuffer->capacity;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+    commandBuffer->commands = (RenderCommand*) RBE_MEM_REALLOCATE(commandBuffer->commands, newCapacity * sizeof(RenderCommand));
+    commandBuffer->sortKeys = (uint64_t*) RBE_MEM_REALLOCATE(commandBuffer->sortKeys, newCapacity * sizeof(uint64_t));
+    commandBuffer->capacity = newCapacity;
+}
+
+RenderCommand* renderer_command_buffer_push_command(RBERenderCommandBuffer* commandBuffer, RenderLayer layer, int zIndex, RenderCommandType type, GLuint textureId) {
+    RBE_ASSERT_FMT(commandBuffer->count < RENDER_SORT_KEY_MAX_COMMANDS, "Render queue is full at '%zu' commands!", commandBuffer->count);
+    renderer_command_buffer_reserve(commandBuffer, commandBuffer->count + 1);
+    // Bias z index so negative values sort before positive ones
+    const int zIndexMin = -(1 << (RENDER_SORT_KEY_Z_INDEX_BITS - 1));
+    const int zIndexMax = (1 << (RENDER_SORT_KEY_Z_INDEX_BITS - 1)) - 1;
+    const int clampedZIndex = zIndex < zIndexMin ? zIndexMin : (zIndex > zIndexMax ? zIndexMax : zIndex);
+    const uint64_t biasedZIndex = (uint64_t) (clampedZIndex - zIndexMin);
+    const size_t order = commandBuffer->count++;
+    commandBuffer->sortKeys[order] = ((uint64_t) layer << RENDER_SORT_KEY_LAYER_SHIFT)
+                                     | (biasedZIndex << RENDER_SORT_KEY_Z_INDEX_SHIFT)
+                                     | ((uint64_t) type << RENDER_SORT_KEY_SHADER_SHIFT)
+                                     | ((uint64_t) (textureId & ((1u << RENDER_SORT_KEY_TEXTURE_BITS) - 1)) << RENDER_SORT_KEY_TEXTURE_SHIFT)
+                                     | (uint64_t) order;
+    RenderCommand* command = &commandBuffer->commands[order];
+    command->type = type;
+    return command;
 }
 
-void rbe_renderer_queue_font_draw_call(Font* font, const char* text, float x, float y, float scale, Color color) {
-    FontBatchItem item = { .font = font, .text = text, .x = x, .y = y, .scale = scale, .color = color };
-    RBE_STATIC_ARRAY_ADD(font_batch_items, item);
+void renderer_queue_initialize() {
+    pthread_mutex_init(&renderQueueMutex, NULL);
+}
+
+void renderer_queue_finalize() {
+    pthread_mutex_destroy(&renderQueueMutex);
+    rbe_renderer_command_buffer_free(&renderQueue);
+    RBE_MEM_FREE(renderSortKeysScratch);
+    renderSortKeysScratch = NULL;
+    renderSortKeysScratchCapacity = 0;
 }
 
 void rbe_renderer_flush_batches() {
-    // Sprite
-    for (size_t i = 0; i < sprite_batch_items_count; i++) {
-        sprite_renderer_draw_sprite(
-            sprite_batch_items[i].texture,
-            &sprite_batch_items[i].sourceRect,
-            &sprite_batch_items[i].destSize,
-            &sprite_batch_items[i].color,
-            sprite_batch_items[i].flipX,
-            sprite_batch_items[i].flipY,
-            sprite_batch_items[i].globalTransform
-        );
+    renderer_camera_uniform_buffer_update_views();
+    if (renderSortKeysScratchCapacity < renderQueue.capacity) {
+        renderSortKeysScratchCapacity = renderQueue.capacity;
+        renderSortKeysScratch = (uint64_t*) RBE_MEM_REALLOCATE(renderSortKeysScratch, renderSortKeysScratchCapacity * sizeof(uint64_t));
     }
-    RBE_STATIC_ARRAY_EMPTY(sprite_batch_items);
-    // Fonts
-    for (size_t i = 0; i < font_batch_items_count; i++) {
-        font_renderer_draw_text(
-            font_batch_items[i].font,
-            font_batch_items[i].text,
-            font_batch_items[i].x,
-            font_batch_items[i].y,
-            font_batch_items[i].scale,
-            &font_batch_items[i].color
-        );
+    renderer_radix_sort_keys(renderQueue.sortKeys, renderSortKeysScratch, renderQueue.count);
+    // Consecutive sorted commands with the same shader and texture are drawn together
+    size_t batchStart = 0;
+    while (batchStart < renderQueue.count) {
+        const RenderCommand* firstCommand = &renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(renderQueue.sortKeys[batchStart])];
+        size_t batchEnd = batchStart + 1;
+        while (batchEnd < renderQueue.count) {
+            const RenderCommand* command = &renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(renderQueue.sortKeys[batchEnd])];
+            if (command->type != firstCommand->type) {
+                break;
+            } else if (command->type == RenderCommandType_SPRITE
+                       && (batchEnd - batchStart >= SPRITE_BATCH_MAX_SPRITES || command->sprite.texture->id != firstCommand->sprite.texture->id)) {
+                break;
+            } else if (command->type == RenderCommandType_FONT && command->font.textMesh->font != firstCommand->font.textMesh->font) {
+                break;
+            }
+            batchEnd++;
+        }
+        switch (firstCommand->type) {
+        case RenderCommandType_SPRITE:
+            sprite_renderer_draw_sprite_batch(&renderQueue.sortKeys[batchStart], batchEnd - batchStart);
+            break;
+        case RenderCommandType_FONT:
+            font_renderer_draw_text_batch(&renderQueue.sortKeys[batchStart], batchEnd - batchStart);
+            break;
+        }
+        batchStart = batchEnd;
+    }
+    renderQueue.count = 0;
+
+    rbe_stream_buffer_end_frame();
+}
+
+// LSD radix sort on one byte at a time, skipping bytes that are the same for every key
+void renderer_radix_sort_keys(uint64_t* keys, uint64_t* scratch, size_t count) {
+    uint64_t* source = keys;
+    uint64_t* dest = scratch;
+    for (unsigned int shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256] = {0};
+        for (size_t i = 0; i < count; i++) {
+            offsets[(source[i] >> shift) & 0xFF]++;
+        }
+        if (count == 0 || offsets[(source[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+        size_t total = 0;
+        for (size_t bucket = 0; bucket < 256; bucket++) {
+            const size_t bucketCount = offsets[bucket];
+            offsets[bucket] = total;
+            total += bucketCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            dest[offsets[(source[i] >> shift) & 0xFF]++] = source[i];
+        }
+        uint64_t* temp = source;
+        source = dest;
+        dest = temp;
+    }
+    if (source != keys) {
+        memcpy(keys, source, count * sizeof(uint64_t));
     }
-    RBE_STATIC_ARRAY_EMPTY(font_batch_items);
 }
 
 // --- Sprite Renderer --- //
-void sprite_renderer_initialize() {
-    GLfloat vertices[] = {
-        //id          // positions       // texture coordinates // color
-        0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-        0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-
-        0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-        0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-        0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f
-    };
+void sprite_renderer_set_instance_attributes(GLint firstInstance);
 
-    // Initialize render data
+void sprite_renderer_initialize() {
+    // Initialize render data, the quad's corners come from the vertex id and instance data is streamed in per batch
     glGenVertexArrays(1, &spriteQuadVAO);
-    glGenBuffers(1, &spriteQuadVBO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, spriteQuadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
-
     glBindVertexArray(spriteQuadVAO);
-    // id attribute
-    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (void*) NULL);
-    glEnableVertexAttribArray(0);
-    // position attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-    // texture coords attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(2);
-    // color attribute
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(3);
-
+    glBindBuffer(GL_ARRAY_BUFFER, rbe_stream_buffer_get_id());
+    // Model columns take locations 0-3, followed by texture rect, color, size with origin and view index
+    for (GLuint location = 0; location < 8; location++) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    sprite_renderer_set_instance_attributes(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
     // compile shaders
     spriteShader = shader_compile_new_shader(OPENGL_SHADER_SOURCE_VERTEX_SPRITE, OPENGL_SHADER_SOURCE_FRAGMENT_SPRITE);
-    mat4 proj = {
-        {1.0f, 0.0f, 0.0f, 0.0f},
-        {0.0f, 1.0f, 0.0f, 0.0f},
-        {0.0f, 0.0f, 1.0f, 0.0f},
-        {0.0f, 0.0f, 0.0f, 1.0f}
-    };
-    RBEGameProperties* gameProperties = rbe_game_props_get();
-    glm_ortho(0.0f, (float) gameProperties->resolutionWidth, (float) gameProperties->resolutionHeight, 0.0f, -1.0f, 1.0f, proj);
+    shader_bind_uniform_block(spriteShader, "Camera", CAMERA_UNIFORM_BLOCK_BINDING);
     shader_use(spriteShader);
-    shader_set_mat4_float(spriteShader, "projection", &proj);
     shader_set_int(spriteShader, "sprite", 0);
 }
 
 void sprite_renderer_finalize() {}
 
-// TODO: Just need to pass in destination size instead of rect2
-void sprite_renderer_draw_sprite(const Texture* texture, const Rect2* sourceRect, const Size2D* destSize, const Color* color, bool flipX, bool flipY, TransformModel2D* globalTransform) {
+// There is no base instance in OpenGL 3.3 so attributes are pointed at the batch's instances in the stream buffer
+void sprite_renderer_set_instance_attributes(GLint firstInstance) {
+    const GLsizei stride = SPRITE_BATCH_INSTANCE_STRIDE * sizeof(GLfloat);
+    const size_t baseOffset = (size_t) firstInstance * stride;
+    // model attribute
+    for (GLuint column = 0; column < 4; column++) {
+        glVertexAttribPointer(column, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(baseOffset + column * 4 * sizeof(GLfloat)));
+    }
+    // texture rect attribute
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(baseOffset + 16 * sizeof(GLfloat)));
+    // color attribute
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(baseOffset + 20 * sizeof(GLfloat)));
+    // size and origin attribute
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(baseOffset + 24 * sizeof(GLfloat)));
+    // view index attribute
+    glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(baseOffset + 28 * sizeof(GLfloat)));
+}
+
+void sprite_renderer_draw_sprite_batch(const uint64_t* sortKeys, size_t count) {
+    RBE_ASSERT_FMT(count <= SPRITE_BATCH_MAX_SPRITES, "Sprite batch count '%zu' exceeds max '%d'!", count, SPRITE_BATCH_MAX_SPRITES);
     glDepthMask(false);
 
-    glm_scale(globalTransform->model, (vec3) {
-        destSize->w, destSize->h, 1.0f
-    });
+    GLint firstInstance = 0;
+    GLfloat* instances = (GLfloat*) rbe_stream_buffer_map_vertices(count, SPRITE_BATCH_INSTANCE_STRIDE * sizeof(GLfloat), &firstInstance);
+    for (size_t spriteIndex = 0; spriteIndex < count; spriteIndex++) {
+        const SpriteBatchItem* item = &renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(sortKeys[spriteIndex])].sprite;
+        const TextureCoordinates textureCoords = renderer_get_texture_coordinates(item->texture, &item->sourceRect, item->flipX, item->flipY);
+        GLfloat* instance = &instances[spriteIndex * SPRITE_BATCH_INSTANCE_STRIDE];
+        // Expanded to the 4x4 matrix the shader takes
+        mat4 model;
+        rbe_math_affine2d_to_mat4(&item->model, model);
+        memcpy(instance, model, 16 * sizeof(GLfloat));
+        instance[16] = textureCoords.sMin;
+        instance[17] = textureCoords.tMin;
+        instance[18] = textureCoords.sMax;
+        instance[19] = textureCoords.tMax;
+        instance[20] = item->color.r;
+        instance[21] = item->color.g;
+        instance[22] = item->color.b;
+        instance[23] = item->color.a;
+        instance[24] = item->destSize.w;
+        instance[25] = item->destSize.h;
+        instance[26] = item->origin.x;
+        instance[27] = item->origin.y;
+        instance[28] = (GLfloat) item->viewIndex;
+    }
 
-    glBindVertexArray(spriteQuadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, spriteQuadVBO);
+    rbe_stream_buffer_unmap();
 
     shader_use(spriteShader);
-    shader_set_mat4_float(spriteShader, "models[0]", &globalTransform->model);
-    const int VERTEX_ITEM_COUNT = 1;
-    const int NUMBER_OF_VERTICES = 6;
-    const float SPRITE_ID = 0.0f;
-    TextureCoordinates textureCoords = renderer_get_texture_coordinates(texture, sourceRect, flipX, flipY);
-
-    const float determinate = glm_mat4_det(globalTransform->model);
-    const int vertsStride = 9;
-    GLfloat verts[54]; // TODO: fix magic number
-    for (int i = 0; i < VERTEX_ITEM_COUNT * NUMBER_OF_VERTICES; i++) {
-        bool isSMin;
-        bool isTMin;
-        if (determinate >= 0.0f) {
-            isSMin = i == 0 || i == 2 || i == 3 ? true : false;
-            isTMin = i == 1 || i == 2 || i == 5 ? true : false;
-        } else {
-            isSMin = i == 1 || i == 2 || i == 5 ? true : false;
-            isTMin = i == 0 || i == 2 || i == 3 ? true : false;
-        }
-        const int row = i * vertsStride;
-        verts[row + 0] = SPRITE_ID;
-        verts[row + 1] = isSMin ? 0.0f : 1.0f;
-        verts[row + 2] = isTMin ? 0.0f : 1.0f;
-        verts[row + 3] = isSMin ? textureCoords.sMin : textureCoords.sMax;
-        verts[row + 4] = isTMin ? textureCoords.tMin : textureCoords.tMax;
-        verts[row + 5] = color->r;
-        verts[row + 6] = color->g;
-        verts[row + 7] = color->b;
-        verts[row + 8] = color->a;
-    }
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture->id);
+    glBindTexture(GL_TEXTURE_2D, renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(sortKeys[0])].sprite.texture->id);
 
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) sizeof(verts), verts, GL_DYNAMIC_DRAW);
-    glDrawArrays(GL_TRIANGLES, 0, VERTEX_ITEM_COUNT * NUMBER_OF_VERTICES);
+    glBindVertexArray(spriteQuadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, rbe_stream_buffer_get_id());
+    sprite_renderer_set_instance_attributes(firstInstance);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, SPRITE_BATCH_VERTICES_PER_SPRITE, (GLsizei) count);
 
     renderer_print_opengl_errors();
 
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     glDepthMask(true);
 }
@@ -231,59 +469,72 @@ void font_renderer_initialize() {
     if (FT_Init_FreeType(&rbe_render_context_get()->freeTypeLibrary)) {
         rbe_logger_error("Unable to initialize FreeType library!");
     }
-    mat4 proj = {
-        {1.0f, 0.0f, 0.0f, 0.0f},
-        {0.0f, 1.0f, 0.0f, 0.0f},
-        {0.0f, 0.0f, 1.0f, 0.0f},
-        {0.0f, 0.0f, 0.0f, 1.0f}
-    };
-    RBEGameProperties* gameProperties = rbe_game_props_get();
-    glm_ortho(0.0f, (float) gameProperties->resolutionWidth, (float) -gameProperties->resolutionHeight, 0.0f, -1.0f, 1.0f, proj);
     fontShader = shader_compile_new_shader(OPENGL_SHADER_SOURCE_VERTEX_FONT, OPENGL_SHADER_SOURCE_FRAGMENT_FONT);
-    shader_use(fontShader);
-    shader_set_mat4_float(fontShader, "projection", &proj);
+    shader_bind_uniform_block(fontShader, "Camera", CAMERA_UNIFORM_BLOCK_BINDING);
+
+    // configure VAO shared by all fonts, vertices are streamed in per batch
+    glGenVertexArrays(1, &fontVAO);
+    glBindVertexArray(fontVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, rbe_stream_buffer_get_id());
+    // vertex attribute (pos, tex)
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, FONT_BATCH_VERTEX_STRIDE * sizeof(GLfloat), NULL);
+    glEnableVertexAttribArray(0);
+    // color attribute
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, FONT_BATCH_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid*)(4 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+    // view index attribute
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, FONT_BATCH_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid*)(8 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 }
 
 void font_renderer_finalize() {
     FT_Done_FreeType(rbe_render_context_get()->freeTypeLibrary);
 }
 
-void font_renderer_draw_text(const Font* font, const char* text, float x, float y, float scale, const Color* color) {
-    Vector2 currentScale = { scale, scale };
+void font_renderer_draw_text_batch(const uint64_t* sortKeys, size_t count) {
+    // Reserve enough vertex memory for every glyph in the batch
+    size_t totalVertexCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        totalVertexCount += renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(sortKeys[i])].font.textMesh->vertexCount;
+    }
+    if (totalVertexCount == 0) {
+        return;
+    }
+    GLint firstVertex = 0;
+    GLfloat* fontVertices = (GLfloat*) rbe_stream_buffer_map_vertices(totalVertexCount, FONT_BATCH_VERTEX_STRIDE * sizeof(GLfloat), &firstVertex);
+
+    const Font* font = renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(sortKeys[0])].font.textMesh->font;
+    // Text meshes are already laid out, only placing them is left
+    GLfloat* vertex = fontVertices;
+    for (size_t itemIndex = 0; itemIndex < count; itemIndex++) {
+        const FontBatchItem* item = &renderQueue.commands[RENDER_SORT_KEY_GET_ORDER(sortKeys[itemIndex])].font;
+        const FontTextMesh* textMesh = item->textMesh;
+        const GLfloat viewIndex = (GLfloat) item->viewIndex;
+        for (size_t i = 0; i < textMesh->vertexCount; i++) {
+            const GLfloat* meshVertex = textMesh->vertices[i];
+            vertex[0] = item->x + meshVertex[0] * item->scale;
+            vertex[1] = item->y + meshVertex[1] * item->scale;
+            vertex[2] = meshVertex[2];
+            vertex[3] = meshVertex[3];
+            vertex[4] = item->color.r;
+            vertex[5] = item->color.g;
+            vertex[6] = item->color.b;
+            vertex[7] = item->color.a;
+            vertex[8] = viewIndex;
+            vertex += FONT_BATCH_VERTEX_STRIDE;
+        }
+    }
+    const GLsizei vertexCount = (GLsizei) totalVertexCount;
+
+    rbe_stream_buffer_unmap();
+
     shader_use(fontShader);
-    shader_set_vec4_float(fontShader, "textColor", color->r, color->g, color->b, color->a);
     glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(font->VAO);
-
-    // Iterate through all characters
-    char* c = (char*) &text[0];
-    const size_t textLength = strlen(text);
-    for (size_t i = 0; i < textLength; i++) {
-        Character ch = font->characters[(int) *c];
-        const float xPos = x + (ch.bearing.x * currentScale.x);
-        const float yPos = -y - (ch.size.y - ch.bearing.y) * currentScale.x; // Invert Y because othographic projection is flipped
-        const float w = ch.size.x * currentScale.x;
-        const float h = ch.size.y * currentScale.y;
-        // Update VBO for each characters
-        GLfloat verts[6][4] = {
-            {xPos,     yPos + h, 0.0f, 0.0f},
-            {xPos,     yPos,     0.0f, 1.0f},
-            {xPos + w, yPos,     1.0f, 1.0f},
-
-            {xPos,     yPos + h, 0.0f, 0.0f},
-            {xPos + w, yPos,     1.0f, 1.0f},
-            {xPos + w, yPos + h, 1.0f, 0.0f}
-        };
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.textureId);
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, font->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
-        // Render
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        x += (float) (ch.advance >> 6) * currentScale.x; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-        ++c;
-    }
+    glBindTexture(GL_TEXTURE_2D, font->textureId);
+    glBindVertexArray(fontVAO);
+    glDrawArrays(GL_TRIANGLES, firstVertex, vertexCount);
     // Unbind
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
@@ -292,23 +543,26 @@ void font_renderer_draw_text(const Font* font, const char* text, float x, float
 
 // --- Misc --- //
 TextureCoordinates renderer_get_texture_coordinates(const Texture* texture, const Rect2* drawSource, bool flipX, bool flipY) {
+    // Draw source is relative to the texture, offset it into the texture's atlas region
+    const GLfloat sourceX = (GLfloat) texture->atlasX + drawSource->x;
+    const GLfloat sourceY = (GLfloat) texture->atlasY + drawSource->y;
     // S
     GLfloat sMin, sMax;
     if (flipX) {
-        sMax = (drawSource->x + 0.5f) / (float) texture->width;
-        sMin = (drawSource->x + drawSource->w - 0.5f) / (float) texture->width;
+        sMax = (sourceX + 0.5f) / (float) texture->atlasWidth;
+        sMin = (sourceX + drawSource->w - 0.5f) / (float) texture->atlasWidth;
     } else {
-        sMin = (drawSource->x + 0.5f) / (float) texture->width;
-        sMax = (drawSource->x + drawSource->w - 0.5f) / (float) texture->width;
+        sMin = (sourceX + 0.5f) / (float) texture->atlasWidth;
+        sMax = (sourceX + drawSource->w - 0.5f) / (float) texture->atlasWidth;
     }
     // T
     GLfloat tMin, tMax;
     if (flipY) {
-        tMax = (drawSource->y + 0.5f) / (float) texture->height;
-        tMin = (drawSource->y + drawSource->h - 0.5f) / (float) texture->height;
+        tMax = (sourceY + 0.5f) / (float) texture->atlasHeight;
+        tMin = (sourceY + drawSource->h - 0.5f) / (float) texture->atlasHeight;
     } else {
-        tMin = (drawSource->y + 0.5f) / (float) texture->height;
-        tMax = (drawSource->y + drawSource->h - 0.5f) / (float) texture->height;
+        tMin = (sourceY + 0.5f) / (float) texture->atlasHeight;
+        tMax = (sourceY + drawSource->h - 0.5f) / (float) texture->atlasHeight;
     }
     TextureCoordinates textureCoords = { sMin, sMax, tMin, tMax };
     return textureCoords;
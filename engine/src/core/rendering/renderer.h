@@ -1,14 +1,39 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "texture.h"
 #include "font.h"
 #include "../math/rbe_math.h"
 #include "../ecs/component/transform2d_component.h"
 
+// Layers are drawn in order, z index only orders draws within the same layer
+typedef enum RenderLayer {
+    RenderLayer_DEFAULT = 0,
+    RenderLayer_DEBUG = 1,
+} RenderLayer;
+
+// Records draw calls without touching the render queue, lets worker threads fill their own buffer and submit them in
+// a set order afterwards.  Zero initialize before first use, storage is kept between submits.
+typedef struct RBERenderCommandBuffer {
+    struct RenderCommand* commands;
+    uint64_t* sortKeys;
+    size_t count;
+    size_t capacity;
+} RBERenderCommandBuffer;
+
 void rbe_renderer_initialize();
 void rbe_renderer_finalize();
-void rbe_renderer_queue_sprite_draw_call(Texture* texture, Rect2 sourceRect, Size2D destSize, Color color, bool flipX, bool flipY, TransformModel2D* globalTransform);
-void rbe_renderer_queue_font_draw_call(Font* font, const char* text, float x, float y, float scale, Color color);
+// Positions are in world space, the current camera's view is applied on the gpu unless 'ignoreCamera' is set
+void rbe_renderer_queue_sprite_draw_call(Texture* texture, Rect2 sourceRect, Size2D destSize, Vector2 origin, Color color, bool flipX, bool flipY, const TransformModel2D* globalTransform, bool ignoreCamera, int zIndex, RenderLayer layer);
+// Text mesh must be up to date and stay alive until batches are flushed
+void rbe_renderer_queue_font_draw_call(const FontTextMesh* textMesh, float x, float y, float scale, Color color, bool ignoreCamera, int zIndex, RenderLayer layer);
+void rbe_renderer_command_buffer_queue_sprite_draw_call(RBERenderCommandBuffer* commandBuffer, Texture* texture, Rect2 sourceRect, Size2D destSize, Vector2 origin, Color color, bool flipX, bool flipY, const TransformModel2D* globalTransform, bool ignoreCamera, int zIndex, RenderLayer layer);
+void rbe_renderer_command_buffer_queue_font_draw_call(RBERenderCommandBuffer* commandBuffer, const FontTextMesh* textMesh, float x, float y, float scale, Color color, bool ignoreCamera, int zIndex, RenderLayer layer);
+// Appends the buffer's draw calls to the render queue in recorded order and empties it
+void rbe_renderer_submit_command_buffer(RBERenderCommandBuffer* commandBuffer);
+void rbe_renderer_command_buffer_free(RBERenderCommandBuffer* commandBuffer);
+// Uploads the camera views and draws everything queued this frame
 void rbe_renderer_flush_batches();
@@ -1,10 +1,16 @@
 #include "shader.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include "../utils/logger.h"
 #include "../memory/rbe_mem.h"
 
+void shader_reflect_uniforms(Shader* shader);
+
+// Program currently in use, to skip redundant 'glUseProgram' calls
+static GLuint currentProgram = 0;
+
 Shader* shader_compile_new_shader(const char* vertexSource, const char* fragmentSource) {
     struct Shader* shader = RBE_MEM_ALLOCATE(Shader);
     GLuint vertex, fragment;
@@ -17,7 +23,7 @@ Shader* shader_compile_new_shader(const char* vertexSource, const char* fragment
     fragment = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragment, 1, &fragmentSource, NULL);
     glCompileShader(fragment);
-    shader_check_compile_errors(vertex, SHADER_FRAGMENT_TYPE);
+    shader_check_compile_errors(fragment, SHADER_FRAGMENT_TYPE);
     // attack and link shaders
     shader->id = glCreateProgram();
     glAttachShader(shader->id, vertex);
@@ -26,9 +32,33 @@ Shader* shader_compile_new_shader(const char* vertexSource, const char* fragment
     shader_check_compile_errors(shader->id, SHADER_PROGRAM_TYPE);
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+    shader_reflect_uniforms(shader);
     return shader;
 }
 
+void shader_reflect_uniforms(Shader* shader) {
+    GLint uniformCount = 0;
+    glGetProgramiv(shader->id, GL_ACTIVE_UNIFORMS, &uniformCount);
+    shader->uniformCount = 0;
+    shader->uniforms = uniformCount > 0 ? (ShaderUniform*) RBE_MEM_ALLOCATE_SIZE((size_t) uniformCount * sizeof(ShaderUniform)) : NULL;
+    for (GLint i = 0; i < uniformCount; i++) {
+        ShaderUniform* uniform = &shader->uniforms[shader->uniformCount];
+        GLsizei nameLength = 0;
+        glGetActiveUniform(shader->id, (GLuint) i, SHADER_UNIFORM_NAME_MAX, &nameLength, &uniform->size, &uniform->type, uniform->name);
+        uniform->location = glGetUniformLocation(shader->id, uniform->name);
+        // Uniforms within uniform blocks have no location
+        if (uniform->location < 0) {
+            continue;
+        }
+        // Strip array suffix so arrays are looked up by their name
+        char* arraySuffix = strstr(uniform->name, "[0]");
+        if (arraySuffix != NULL) {
+            *arraySuffix = '\0';
+        }
+        shader->uniformCount++;
+    }
+}
+
 void shader_check_compile_errors(unsigned int shaderId, const char* type) {
     int success;
     char infoLog[1024];
@@ -48,33 +78,55 @@ void shader_check_compile_errors(unsigned int shaderId, const char* type) {
 }
 
 void shader_use(Shader* shader) {
-    glUseProgram(shader->id);
+    if (shader->id != currentProgram) {
+        glUseProgram(shader->id);
+        currentProgram = shader->id;
+    }
+}
+
+GLint shader_get_uniform_location(Shader* shader, const char* name) {
+    for (size_t i = 0; i < shader->uniformCount; i++) {
+        if (strcmp(shader->uniforms[i].name, name) == 0) {
+            return shader->uniforms[i].location;
+        }
+    }
+    rbe_logger_warn("Uniform '%s' not found in shader program '%u'!", name, shader->id);
+    return -1;
+}
+
+void shader_bind_uniform_block(Shader* shader, const char* blockName, GLuint bindingPoint) {
+    const GLuint blockIndex = glGetUniformBlockIndex(shader->id, blockName);
+    if (blockIndex == GL_INVALID_INDEX) {
+        rbe_logger_warn("Uniform block '%s' not found in shader program '%u'!", blockName, shader->id);
+        return;
+    }
+    glUniformBlockBinding(shader->id, blockIndex, bindingPoint);
 }
 
 void shader_set_bool(Shader* shader, const char* name, bool value) {
-    glUniform1i(glGetUniformLocation(shader->id, name), (int)value);
+    glUniform1i(shader_get_uniform_location(shader, name), (int)value);
 }
 
 void shader_set_int(Shader* shader, const char* name, int value) {
-    glUniform1i(glGetUniformLocation(shader->id, name), value);
+    glUniform1i(shader_get_uniform_location(shader, name), value);
 }
 
 void shader_set_float(Shader* shader, const char* name, float value) {
-    glUniform1f(glGetUniformLocation(shader->id, name), value);
+    glUniform1f(shader_get_uniform_location(shader, name), value);
 }
 
 void shader_set_vec2_float(Shader* shader, const char* name, float v1, float v2) {
-    glUniform2f(glGetUniformLocation(shader->id, name), v1, v2);
+    glUniform2f(shader_get_uniform_location(shader, name), v1, v2);
 }
 
 void shader_set_vec3_float(Shader* shader, const char* name, float v1, float v2, float v3) {
-    glUniform3f(glGetUniformLocation(shader->id, name), v1, v2, v3);
+    glUniform3f(shader_get_uniform_location(shader, name), v1, v2, v3);
 }
 
 void shader_set_vec4_float(Shader* shader, const char* name, float v1, float v2, float v3, float v4) {
-    glUniform4f(glGetUniformLocation(shader->id, name), v1, v2, v3, v4);
+    glUniform4f(shader_get_uniform_location(shader, name), v1, v2, v3, v4);
 }
 
 void shader_set_mat4_float(Shader* shader, const char* name, mat4* value) {
-    glUniformMatrix4fv(glGetUniformLocation(shader->id, name), 1, GL_FALSE, (float*)value);
+    glUniformMatrix4fv(shader_get_uniform_location(shader, name), 1, GL_FALSE, (float*)value);
 }
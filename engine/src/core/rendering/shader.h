@@ -5,17 +5,31 @@
 #include <glad/glad.h>
 #include <cglm/cglm.h>
 
+#define SHADER_UNIFORM_NAME_MAX 64
+
 static const char* SHADER_VERTEX_TYPE = "VERTEX";
 static const char* SHADER_FRAGMENT_TYPE = "FRAGMENT";
 static const char* SHADER_PROGRAM_TYPE = "PROGRAM";
 
+// Active uniform reflected from a linked program, array uniforms are stored without the '[0]' suffix
+typedef struct ShaderUniform {
+    char name[SHADER_UNIFORM_NAME_MAX];
+    GLint location;
+    GLenum type;
+    GLint size;
+} ShaderUniform;
+
 typedef struct Shader {
     GLuint id;
+    ShaderUniform* uniforms;
+    size_t uniformCount;
 } Shader;
 
 Shader* shader_compile_new_shader(const char* vertexSource, const char* fragmentSource);
 void shader_check_compile_errors(unsigned int shaderId, const char* type);
 void shader_use(Shader* shader);
+GLint shader_get_uniform_location(Shader* shader, const char* name);
+void shader_bind_uniform_block(Shader* shader, const char* blockName, GLuint bindingPoint);
 void shader_set_bool(Shader* shader, const char* name, bool value);
 void shader_set_int(Shader* shader, const char* name, int value);
 void shader_set_float(Shader* shader, const char* name, float value);
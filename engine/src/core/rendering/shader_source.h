@@ -2,30 +2,35 @@
 
 static const char* OPENGL_SHADER_SOURCE_VERTEX_SPRITE =
     "#version 330 core\n"
-    "layout (location = 0) in float id;\n"
-    "layout (location = 1) in vec2 position;\n"
-    "layout (location = 2) in vec2 textureCoordinates;\n"
-    "layout (location = 3) in vec4 textureColor;\n"
+    "layout (location = 0) in mat4 model;\n"
+    "layout (location = 4) in vec4 textureRect; // (sMin, tMin, sMax, tMax)\n"
+    "layout (location = 5) in vec4 textureColor;\n"
+    "layout (location = 6) in vec4 sizeOrigin; // (w, h, origin x, origin y)\n"
+    "layout (location = 7) in float viewIndex;\n"
     "\n"
-    "out float spriteId;\n"
     "out vec2 texCoord;\n"
     "out vec4 spriteColor;\n"
     "\n"
-    "uniform mat4 models[100];\n"
-    "uniform mat4 projection;\n"
+    "layout (std140) uniform Camera {\n"
+    "    mat4 projection;\n"
+    "    mat4 views[2];\n"
+    "};\n"
+    "\n"
+    "// Quad corners for both windings, mirrored transforms use the second so faces aren't culled\n"
+    "const vec2 corners[6] = vec2[6](vec2(0.0f, 1.0f), vec2(1.0f, 0.0f), vec2(0.0f, 0.0f), vec2(0.0f, 1.0f), vec2(1.0f, 1.0f), vec2(1.0f, 0.0f));\n"
+    "const vec2 mirroredCorners[6] = vec2[6](vec2(1.0f, 0.0f), vec2(0.0f, 1.0f), vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(1.0f, 1.0f), vec2(0.0f, 1.0f));\n"
     "\n"
     "void main() {\n"
-    "    spriteId = id;\n"
-    "    int spriteIntId = int(id);\n"
-    "    texCoord = textureCoordinates;\n"
+    "    mat4 viewModel = views[int(viewIndex)] * model;\n"
+    "    vec2 corner = determinant(mat2(viewModel)) < 0.0f ? mirroredCorners[gl_VertexID] : corners[gl_VertexID];\n"
+    "    texCoord = mix(textureRect.xy, textureRect.zw, corner);\n"
     "    spriteColor = textureColor;\n"
-    "    gl_Position = projection * models[spriteIntId] * vec4(position, 0.0f, 1.0f);\n"
+    "    gl_Position = projection * viewModel * vec4(corner * sizeOrigin.xy - sizeOrigin.zw, 0.0f, 1.0f);\n"
     "}\n";
 
 static const char* OPENGL_SHADER_SOURCE_FRAGMENT_SPRITE =
     "#version 330 core\n"
     "\n"
-    "in float spriteId;\n"
     "in vec2 texCoord;\n"
     "in vec4 spriteColor;\n"
     "out vec4 color;\n"
@@ -39,23 +44,30 @@ static const char* OPENGL_SHADER_SOURCE_FRAGMENT_SPRITE =
 static const char* OPENGL_SHADER_SOURCE_VERTEX_FONT =
     "#version 330 core\n"
     "layout (location = 0) in vec4 vertex; // (pos, tex)\n"
+    "layout (location = 1) in vec4 color;\n"
+    "layout (location = 2) in float viewIndex;\n"
     "\n"
     "out vec2 texCoords;\n"
+    "out vec4 textColor;\n"
     "\n"
-    "uniform mat4 projection;\n"
+    "layout (std140) uniform Camera {\n"
+    "    mat4 projection;\n"
+    "    mat4 views[2];\n"
+    "};\n"
     "\n"
     "void main() {\n"
-    "    gl_Position = projection * vec4(vertex.xy, 0.0f, 1.0f);\n"
+    "    gl_Position = projection * views[int(viewIndex)] * vec4(vertex.xy, 0.0f, 1.0f);\n"
     "    texCoords = vertex.zw;\n"
+    "    textColor = color;\n"
     "}\n";
 
 static const char* OPENGL_SHADER_SOURCE_FRAGMENT_FONT =
     "#version 330 core\n"
     "in vec2 texCoords;\n"
+    "in vec4 textColor;\n"
     "out vec4 color;\n"
     "\n"
     "uniform sampler2D textValue;\n"
-    "uniform vec4 textColor;\n"
     "\n"
     "void main() {\n"
     "    vec4 sampled = vec4(1.0f, 1.0f, 1.0f, texture(textValue, texCoords).r);\n"
@@ -0,0 +1,144 @@
+#include "stream_buffer.h"
+
+#include "../utils/logger.h"
+#include "../utils/rbe_assert.h"
+
+#define STREAM_BUFFER_REGION_COUNT 3
+#define STREAM_BUFFER_REGION_SIZE (4 * 1024 * 1024)
+#define STREAM_BUFFER_SIZE (STREAM_BUFFER_REGION_COUNT * STREAM_BUFFER_REGION_SIZE)
+#define STREAM_BUFFER_FENCE_TIMEOUT_NANOSECONDS 1000000000
+
+typedef struct StreamBuffer {
+    GLuint id;
+    bool isPersistent;
+    // Persistent - each frame writes to its own region, guarded by a fence until the GPU is done reading it
+    unsigned char* persistentData;
+    GLsync regionFences[STREAM_BUFFER_REGION_COUNT];
+    size_t currentRegion;
+    bool isCurrentRegionFenced;
+    // Write position, relative to the current region when persistent or the whole buffer when orphaning
+    size_t head;
+    bool isMapped;
+} StreamBuffer;
+
+static StreamBuffer streamBuffer = {0};
+
+void stream_buffer_advance_region();
+void stream_buffer_wait_for_fence(GLsync* fence);
+
+void rbe_stream_buffer_initialize() {
+    RBE_ASSERT(streamBuffer.id == 0);
+    glGenBuffers(1, &streamBuffer.id);
+    glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.id);
+    streamBuffer.isPersistent = GLAD_GL_ARB_buffer_storage && glBufferStorage != NULL;
+    if (streamBuffer.isPersistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, NULL, flags);
+        streamBuffer.persistentData = (unsigned char*) glMapBufferRange(GL_ARRAY_BUFFER, 0, STREAM_BUFFER_SIZE, flags);
+        if (streamBuffer.persistentData == NULL) {
+            rbe_logger_warn("Failed to persistently map stream buffer, falling back to buffer orphaning!");
+            glDeleteBuffers(1, &streamBuffer.id);
+            glGenBuffers(1, &streamBuffer.id);
+            glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.id);
+            streamBuffer.isPersistent = false;
+        }
+    }
+    if (!streamBuffer.isPersistent) {
+        glBufferData(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    rbe_logger_debug("Stream buffer initialized, persistent = '%s'", streamBuffer.isPersistent ? "true" : "false");
+}
+
+void rbe_stream_buffer_finalize() {
+    for (size_t i = 0; i < STREAM_BUFFER_REGION_COUNT; i++) {
+        if (streamBuffer.regionFences[i] != NULL) {
+            glDeleteSync(streamBuffer.regionFences[i]);
+        }
+    }
+    if (streamBuffer.isPersistent) {
+        glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &streamBuffer.id);
+    streamBuffer = (StreamBuffer) {0};
+}
+
+GLuint rbe_stream_buffer_get_id() {
+    return streamBuffer.id;
+}
+
+void* rbe_stream_buffer_map_vertices(size_t vertexCount, size_t vertexStride, GLint* firstVertex) {
+    RBE_ASSERT(!streamBuffer.isMapped);
+    RBE_ASSERT(vertexStride > 0);
+    const size_t size = vertexCount * vertexStride;
+    RBE_ASSERT_FMT(size + vertexStride <= STREAM_BUFFER_REGION_SIZE, "Stream buffer allocation of '%zu' bytes is larger than region size '%d'!", size, STREAM_BUFFER_REGION_SIZE);
+    // Offset has to be a multiple of the stride so it can be addressed as a vertex index
+    const size_t regionSize = streamBuffer.isPersistent ? STREAM_BUFFER_REGION_SIZE : STREAM_BUFFER_SIZE;
+    const size_t regionStart = streamBuffer.isPersistent ? streamBuffer.currentRegion * STREAM_BUFFER_REGION_SIZE : 0;
+    size_t offset = ((regionStart + streamBuffer.head + vertexStride - 1) / vertexStride) * vertexStride;
+    if (offset + size > regionStart + regionSize) {
+        if (streamBuffer.isPersistent) {
+            // Out of space for this frame, move on to the next region
+            stream_buffer_advance_region();
+        } else {
+            // Orphan storage so the driver can hand out fresh memory without waiting on pending draws
+            glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.id);
+            glBufferData(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, NULL, GL_STREAM_DRAW);
+            streamBuffer.head = 0;
+        }
+        return rbe_stream_buffer_map_vertices(vertexCount, vertexStride, firstVertex);
+    }
+    streamBuffer.head = offset + size - regionStart;
+    *firstVertex = (GLint) (offset / vertexStride);
+    streamBuffer.isMapped = true;
+
+    if (streamBuffer.isPersistent) {
+        // The region's fence is waited on lazily, once it's actually written to again
+        stream_buffer_wait_for_fence(&streamBuffer.regionFences[streamBuffer.currentRegion]);
+        return streamBuffer.persistentData + offset;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.id);
+    return glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr) offset, (GLsizeiptr) size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void rbe_stream_buffer_unmap() {
+    RBE_ASSERT(streamBuffer.isMapped);
+    streamBuffer.isMapped = false;
+    if (!streamBuffer.isPersistent) {
+        glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+}
+
+void rbe_stream_buffer_end_frame() {
+    RBE_ASSERT(!streamBuffer.isMapped);
+    if (streamBuffer.isPersistent && streamBuffer.head > 0) {
+        stream_buffer_advance_region();
+    }
+}
+
+void stream_buffer_advance_region() {
+    RBE_ASSERT(streamBuffer.regionFences[streamBuffer.currentRegion] == NULL);
+    streamBuffer.regionFences[streamBuffer.currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    streamBuffer.currentRegion = (streamBuffer.currentRegion + 1) % STREAM_BUFFER_REGION_COUNT;
+    streamBuffer.head = 0;
+}
+
+void stream_buffer_wait_for_fence(GLsync* fence) {
+    if (*fence == NULL) {
+        return;
+    }
+    while (true) {
+        const GLenum result = glClientWaitSync(*fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_BUFFER_FENCE_TIMEOUT_NANOSECONDS);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            break;
+        } else if (result == GL_WAIT_FAILED) {
+            rbe_logger_error("Failed waiting on stream buffer fence!");
+            break;
+        }
+    }
+    glDeleteSync(*fence);
+    *fence = NULL;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <glad/glad.h>
+
+// Ring of GL buffer memory used for all dynamic vertex data drawn in a frame.
+// Uses persistently mapped storage fenced per frame when ARB_buffer_storage is available and buffer orphaning otherwise.
+void rbe_stream_buffer_initialize();
+void rbe_stream_buffer_finalize();
+GLuint rbe_stream_buffer_get_id();
+// Reserves memory for 'vertexCount' vertices of 'vertexStride' bytes.  Returns write only memory for the vertices and
+// sets 'firstVertex' to the index to pass to draw calls for the stream buffer with the same stride.
+void* rbe_stream_buffer_map_vertices(size_t vertexCount, size_t vertexStride, GLint* firstVertex);
+// Must be called once the mapped vertices are written and before drawing them
+void rbe_stream_buffer_unmap();
+// Called once all draws for a frame are submitted
+void rbe_stream_buffer_end_frame();
@@ -35,21 +35,19 @@ Texture* rbe_texture_create_default_texture() {
     return texture;
 }
 
-void rbe_texture_generate(Texture* texture);
-
 Texture* rbe_texture_create_texture(const char* filePath) {
+    Texture* texture = rbe_texture_load_texture_image(filePath);
+    rbe_texture_generate(texture);
+    return texture;
+}
+
+// Loads image data only, the GL texture is created later with 'rbe_texture_generate' or by the texture atlas
+Texture* rbe_texture_load_texture_image(const char* filePath) {
     Texture* texture = rbe_texture_create_default_texture();
     texture->fileName = filePath;
     stbi_set_flip_vertically_on_load(false);
-    unsigned char* imageData = stbi_load(filePath, &texture->width, &texture->height, &texture->nrChannels, 0);
-    RBE_ASSERT_FMT(imageData != NULL, "Failed to load texture image at file path '%s'", filePath);
-    const size_t imageDataSize = sizeof(Texture*);
-    texture->data = (unsigned char*) RBE_MEM_ALLOCATE_SIZE(imageDataSize);
-    memcpy(texture->data, imageData, imageDataSize);
-    texture->data = imageData;
-
-    rbe_texture_generate(texture);
-
+    texture->data = stbi_load(filePath, &texture->width, &texture->height, &texture->nrChannels, 0);
+    RBE_ASSERT_FMT(texture->data != NULL, "Failed to load texture image at file path '%s'", filePath);
     return texture;
 }
 
@@ -92,6 +90,11 @@ void rbe_texture_generate(Texture* texture) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture->filterMag);
     // Unbind texture
     glBindTexture(GL_TEXTURE_2D, 0);
+    // Not part of an atlas, so occupies the whole GL texture
+    texture->atlasX = 0;
+    texture->atlasY = 0;
+    texture->atlasWidth = texture->width;
+    texture->atlasHeight = texture->height;
 
     RBE_ASSERT_FMT(rbe_texture_is_texture_valid(texture), "Texture at file path '%s' is not valid!", texture->fileName);
 }
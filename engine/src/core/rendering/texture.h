@@ -17,7 +17,15 @@ typedef struct Texture {
     GLint filterMin;
     GLint filterMag;
     const char* fileName;
+    // atlas - region of the GL texture 'id' this texture occupies, the whole GL texture when not packed into an atlas
+    GLsizei atlasX;
+    GLsizei atlasY;
+    GLsizei atlasWidth;
+    GLsizei atlasHeight;
 } Texture;
 
+Texture* rbe_texture_create_default_texture();
 Texture* rbe_texture_create_texture(const char* filePath);
+Texture* rbe_texture_load_texture_image(const char* filePath);
 Texture* rbe_texture_create_solid_colored_texture(GLsizei width, GLsizei height, GLuint colorValue);
+void rbe_texture_generate(Texture* texture);
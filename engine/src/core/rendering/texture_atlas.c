@@ -0,0 +1,127 @@
+#include "texture_atlas.h"
+
+#include <string.h>
+
+#include <stb_image/stb_image.h>
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
+#include "../memory/rbe_mem.h"
+#include "../utils/logger.h"
+
+#define TEXTURE_ATLAS_MAX_PAGE_SIZE 2048
+// Gap between packed textures so neighbours don't bleed into each other when sampled
+#define TEXTURE_ATLAS_PADDING 1
+
+void texture_atlas_copy_image_to_page(const Texture* texture, unsigned char* pageData, GLsizei pageWidth, GLsizei x, GLsizei y);
+
+void rbe_texture_atlas_build(Texture** textures, size_t textureCount) {
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    const int pageSize = maxTextureSize < TEXTURE_ATLAS_MAX_PAGE_SIZE ? maxTextureSize : TEXTURE_ATLAS_MAX_PAGE_SIZE;
+
+    stbrp_rect* rects = (stbrp_rect*) RBE_MEM_ALLOCATE_SIZE_ZERO((int) textureCount + 1, sizeof(stbrp_rect));
+    int rectCount = 0;
+    for (size_t i = 0; i < textureCount; i++) {
+        Texture* texture = textures[i];
+        const int paddedWidth = texture->width + TEXTURE_ATLAS_PADDING;
+        const int paddedHeight = texture->height + TEXTURE_ATLAS_PADDING;
+        if (paddedWidth > pageSize || paddedHeight > pageSize) {
+            rbe_logger_debug("Texture '%s' is too large for an atlas page, generating separate texture", texture->fileName);
+            rbe_texture_generate(texture);
+            continue;
+        }
+        rects[rectCount++] = (stbrp_rect) {
+            .id = (int) i, .w = (stbrp_coord) paddedWidth, .h = (stbrp_coord) paddedHeight
+        };
+    }
+
+    stbrp_node* nodes = (stbrp_node*) RBE_MEM_ALLOCATE_SIZE(pageSize * sizeof(stbrp_node));
+    int pageCount = 0;
+    while (rectCount > 0) {
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize, pageSize, nodes, pageSize);
+        stbrp_pack_rects(&context, rects, rectCount);
+
+        // Shrink page to the packed area
+        GLsizei pageWidth = 0;
+        GLsizei pageHeight = 0;
+        for (int i = 0; i < rectCount; i++) {
+            if (rects[i].was_packed) {
+                const GLsizei right = rects[i].x + rects[i].w;
+                const GLsizei bottom = rects[i].y + rects[i].h;
+                pageWidth = right > pageWidth ? right : pageWidth;
+                pageHeight = bottom > pageHeight ? bottom : pageHeight;
+            }
+        }
+
+        Texture* page = rbe_texture_create_default_texture();
+        page->width = pageWidth;
+        page->height = pageHeight;
+        page->nrChannels = 4;
+        page->data = (unsigned char*) RBE_MEM_ALLOCATE_SIZE_ZERO(pageWidth * pageHeight, 4);
+        for (int i = 0; i < rectCount; i++) {
+            if (rects[i].was_packed) {
+                texture_atlas_copy_image_to_page(textures[rects[i].id], page->data, pageWidth, rects[i].x, rects[i].y);
+            }
+        }
+        rbe_texture_generate(page);
+        // Packed textures keep the GL texture, the page's pixels are only needed for the upload
+        const GLuint pageId = page->id;
+        RBE_MEM_FREE(page->data);
+        RBE_MEM_FREE(page);
+
+        // Point packed textures at their region of the page and keep unpacked ones for the next page
+        int remainingCount = 0;
+        int packedCount = 0;
+        for (int i = 0; i < rectCount; i++) {
+            if (rects[i].was_packed) {
+                Texture* texture = textures[rects[i].id];
+                texture->id = pageId;
+                texture->atlasX = rects[i].x;
+                texture->atlasY = rects[i].y;
+                texture->atlasWidth = pageWidth;
+                texture->atlasHeight = pageHeight;
+                stbi_image_free(texture->data);
+                texture->data = NULL;
+                packedCount++;
+            } else {
+                rects[remainingCount++] = rects[i];
+            }
+        }
+        rbe_logger_debug("Texture atlas page '%d' (%dx%d) packed '%d' textures", pageCount, pageWidth, pageHeight, packedCount);
+        rectCount = remainingCount;
+        pageCount++;
+    }
+
+    RBE_MEM_FREE(nodes);
+    RBE_MEM_FREE(rects);
+}
+
+void texture_atlas_copy_image_to_page(const Texture* texture, unsigned char* pageData, GLsizei pageWidth, GLsizei x, GLsizei y) {
+    const int channels = texture->nrChannels;
+    for (GLsizei row = 0; row < texture->height; row++) {
+        const unsigned char* src = &texture->data[(size_t) row * texture->width * channels];
+        unsigned char* dest = &pageData[((size_t) (y + row) * pageWidth + x) * 4];
+        if (channels == 4) {
+            memcpy(dest, src, (size_t) texture->width * 4);
+            continue;
+        }
+        for (GLsizei column = 0; column < texture->width; column++) {
+            const unsigned char* srcPixel = &src[column * channels];
+            unsigned char* destPixel = &dest[column * 4];
+            if (channels >= 3) {
+                destPixel[0] = srcPixel[0];
+                destPixel[1] = srcPixel[1];
+                destPixel[2] = srcPixel[2];
+                destPixel[3] = 255;
+            } else {
+                // Grey or grey + alpha
+                destPixel[0] = destPixel[1] = destPixel[2] = srcPixel[0];
+                destPixel[3] = channels == 2 ? srcPixel[1] : 255;
+            }
+        }
+    }
+}
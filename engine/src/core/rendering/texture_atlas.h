@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "texture.h"
+
+// Packs loaded texture images into shared atlas pages and generates the GL textures for them.
+// Textures too large to fit on a page get their own GL texture.
+void rbe_texture_atlas_build(Texture** textures, size_t textureCount);
@@ -0,0 +1,205 @@
+#include "prefab_registry.h"
+
+#include <string.h>
+
+#include "scene_manager.h"
+#include "../ecs/component/component.h"
+#include "../ecs/component/collider2d_component.h"
+#include "../ecs/component/script_component.h"
+#include "../ecs/system/ec_system.h"
+#include "../data_structures/rbe_hash_map_string.h"
+#include "../memory/rbe_mem.h"
+#include "../utils/logger.h"
+#include "../utils/rbe_assert.h"
+
+#define PREFAB_NO_PARENT UINT32_MAX
+
+// Nodes are stored parent first, so a node's parent is always cloned before it
+typedef struct PrefabNode {
+    uint32_t parentIndex;
+    Entity sourceEntity; // Entity the node was captured from, used to remap references between the prefab's nodes
+    ComponentSignature signature;
+    size_t blockOffset;
+} PrefabNode;
+
+typedef struct Prefab {
+    PrefabNode* nodes;
+    size_t nodeCount;
+    uint32_t* creationOrder; // Children before parents, same order scene loading queues nodes in
+    char* componentBlocks;
+    size_t componentBlocksSize;
+} Prefab;
+
+typedef struct PrefabCapture {
+    Prefab* prefab;
+    size_t nodeCapacity;
+    size_t blocksCapacity;
+    size_t creationCount;
+} PrefabCapture;
+
+static RBEStringHashMap* prefabMap = NULL;
+// Script paths captured by prefabs, instances point at these so they're kept until the registry is finalized
+static RBEStringHashMap* capturedStrings = NULL;
+static Prefab** prefabs = NULL;
+static size_t prefabCount = 0;
+// Scratch for instantiation, only grows
+static Entity* instanceEntities = NULL;
+static size_t instanceCapacity = 0;
+
+void prefab_free_contents(Prefab* prefab);
+uint32_t prefab_capture_node(PrefabCapture* capture, Entity entity, uint32_t parentIndex);
+const char* prefab_capture_string(const char* string);
+Entity prefab_remap_entity(const Prefab* prefab, Entity entity);
+
+void rbe_prefab_registry_initialize() {
+    RBE_ASSERT(prefabMap == NULL);
+    prefabMap = rbe_string_hash_map_create(16);
+    capturedStrings = rbe_string_hash_map_create(16);
+}
+
+void rbe_prefab_registry_finalize() {
+    RBE_ASSERT(prefabMap != NULL);
+    for (size_t i = 0; i < prefabCount; i++) {
+        prefab_free_contents(prefabs[i]);
+        RBE_MEM_FREE(prefabs[i]);
+    }
+    if (prefabs != NULL) {
+        RBE_MEM_FREE(prefabs);
+    }
+    if (instanceEntities != NULL) {
+        RBE_MEM_FREE(instanceEntities);
+    }
+    rbe_string_hash_map_destroy(prefabMap);
+    rbe_string_hash_map_destroy(capturedStrings);
+    prefabMap = NULL;
+    capturedStrings = NULL;
+    prefabs = NULL;
+    prefabCount = 0;
+    instanceEntities = NULL;
+    instanceCapacity = 0;
+}
+
+void rbe_prefab_registry_register(const char* name, Entity rootEntity) {
+    RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(rootEntity), "Entity '%u' isn't in the scene tree, can't register it as prefab '%s'!", rootEntity, name);
+    Prefab* prefab = NULL;
+    if (rbe_string_hash_map_has(prefabMap, name)) {
+        // Reuse the existing prefab so the registry keeps pointing at it
+        prefab = *(Prefab**) rbe_string_hash_map_get(prefabMap, name);
+        prefab_free_contents(prefab);
+    } else {
+        prefab = RBE_MEM_ALLOCATE(Prefab);
+        rbe_string_hash_map_add(prefabMap, name, &prefab, sizeof(Prefab*));
+        prefabs = RBE_MEM_REALLOCATE(prefabs, (prefabCount + 1) * sizeof(Prefab*));
+        prefabs[prefabCount++] = prefab;
+    }
+    memset(prefab, 0, sizeof(Prefab));
+    PrefabCapture capture = { .prefab = prefab };
+    prefab_capture_node(&capture, rootEntity, PREFAB_NO_PARENT);
+    rbe_logger_debug("Registered prefab '%s' with '%zu' nodes", name, prefab->nodeCount);
+}
+
+bool rbe_prefab_registry_has(const char* name) {
+    return rbe_string_hash_map_has(prefabMap, name);
+}
+
+Entity rbe_prefab_registry_instantiate(const char* name, Entity parent) {
+    RBE_ASSERT_FMT(rbe_string_hash_map_has(prefabMap, name), "Doesn't have prefab '%s'!", name);
+    RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(parent), "Parent entity '%u' isn't in the scene tree, can't instantiate prefab '%s'!", parent, name);
+    const Prefab* prefab = *(Prefab**) rbe_string_hash_map_get(prefabMap, name);
+    if (prefab->nodeCount > instanceCapacity) {
+        instanceCapacity = prefab->nodeCount;
+        instanceEntities = RBE_MEM_REALLOCATE(instanceEntities, instanceCapacity * sizeof(Entity));
+    }
+    // Entities are created up front so references between the prefab's nodes can be remapped while cloning
+    for (size_t i = 0; i < prefab->nodeCount; i++) {
+        instanceEntities[i] = rbe_ec_system_create_entity();
+    }
+    RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(parent), "Parent entity '%u' isn't in the scene tree, can't instantiate prefab '%s'!", parent, name);
+    for (size_t i = 0; i < prefab->nodeCount; i++) {
+        const PrefabNode* node = &prefab->nodes[i];
+        const Entity entity = instanceEntities[i];
+        component_manager_set_component_block(entity, &node->signature, prefab->componentBlocks + node->blockOffset);
+        if (component_signature_has(&node->signature, ComponentDataIndex_COLLIDER_2D)) {
+            Collider2DComponent* collider2DComponent = component_manager_get_component(entity, ComponentDataIndex_COLLIDER_2D);
+            for (size_t exceptionIndex = 0; exceptionIndex < collider2DComponent->collisionExceptionCount; exceptionIndex++) {
+                collider2DComponent->collisionExceptions[exceptionIndex] = prefab_remap_entity(prefab, collider2DComponent->collisionExceptions[exceptionIndex]);
+            }
+        }
+        rbe_scene_tree_create_tree_node(entity, node->parentIndex == PREFAB_NO_PARENT ? parent : instanceEntities[node->parentIndex]);
+        rbe_ec_system_update_entity_signature_with_systems(entity);
+    }
+    for (size_t i = 0; i < prefab->nodeCount; i++) {
+        rbe_scene_manager_queue_entity_for_creation(instanceEntities[prefab->creationOrder[i]]);
+    }
+    return instanceEntities[0];
+}
+
+void prefab_free_contents(Prefab* prefab) {
+    if (prefab->nodes != NULL) {
+        RBE_MEM_FREE(prefab->nodes);
+        RBE_MEM_FREE(prefab->creationOrder);
+    }
+    if (prefab->componentBlocks != NULL) {
+        RBE_MEM_FREE(prefab->componentBlocks);
+    }
+}
+
+uint32_t prefab_capture_node(PrefabCapture* capture, Entity entity, uint32_t parentIndex) {
+    Prefab* prefab = capture->prefab;
+    if (prefab->nodeCount >= capture->nodeCapacity) {
+        capture->nodeCapacity = capture->nodeCapacity == 0 ? 8 : capture->nodeCapacity * 2;
+        prefab->nodes = RBE_MEM_REALLOCATE(prefab->nodes, capture->nodeCapacity * sizeof(PrefabNode));
+        prefab->creationOrder = RBE_MEM_REALLOCATE(prefab->creationOrder, capture->nodeCapacity * sizeof(uint32_t));
+    }
+    const uint32_t nodeIndex = (uint32_t) prefab->nodeCount++;
+    PrefabNode* node = &prefab->nodes[nodeIndex];
+    node->parentIndex = parentIndex;
+    node->sourceEntity = entity;
+    node->signature = component_manager_get_component_signature(entity);
+    // Blocks are aligned for any component type
+    node->blockOffset = (prefab->componentBlocksSize + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+    const size_t blockSize = component_manager_get_component_block_size(&node->signature);
+    if (node->blockOffset + blockSize > capture->blocksCapacity) {
+        capture->blocksCapacity = capture->blocksCapacity == 0 ? 1024 : capture->blocksCapacity;
+        while (node->blockOffset + blockSize > capture->blocksCapacity) {
+            capture->blocksCapacity *= 2;
+        }
+        prefab->componentBlocks = RBE_MEM_REALLOCATE(prefab->componentBlocks, capture->blocksCapacity);
+    }
+    void* block = prefab->componentBlocks + node->blockOffset;
+    component_manager_copy_component_block(entity, block);
+    prefab->componentBlocksSize = node->blockOffset + blockSize;
+    if (component_signature_has(&node->signature, ComponentDataIndex_SCRIPT)) {
+        // Script paths may point at memory the source node doesn't keep around.  Instances copy these pointers, so they
+        // need to outlive the prefab being registered again
+        ScriptComponent* scriptComponent = component_block_get_component(block, &node->signature, ComponentDataIndex_SCRIPT);
+        scriptComponent->classPath = prefab_capture_string(scriptComponent->classPath);
+        scriptComponent->className = prefab_capture_string(scriptComponent->className);
+    }
+
+    for (Entity child = rbe_scene_manager_get_entity_tree_node(entity)->firstChild; child != NULL_ENTITY; child = rbe_scene_manager_get_entity_tree_node(child)->nextSibling) {
+        prefab_capture_node(capture, child, nodeIndex);
+    }
+    prefab->creationOrder[capture->creationCount++] = nodeIndex;
+    return nodeIndex;
+}
+
+const char* prefab_capture_string(const char* string) {
+    if (string == NULL) {
+        return NULL;
+    }
+    if (!rbe_string_hash_map_has(capturedStrings, string)) {
+        rbe_string_hash_map_add_string(capturedStrings, string, string);
+    }
+    return rbe_string_hash_map_get_string(capturedStrings, string);
+}
+
+// References to entities outside of the prefab are left as is
+Entity prefab_remap_entity(const Prefab* prefab, Entity entity) {
+    for (size_t i = 0; i < prefab->nodeCount; i++) {
+        if (prefab->nodes[i].sourceEntity == entity) {
+            return instanceEntities[i];
+        }
+    }
+    return entity;
+}
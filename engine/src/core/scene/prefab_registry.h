@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "../ecs/entity/entity.h"
+
+// Prefabs capture a node and its descendants once, instantiating them clones the captured component blocks and
+// hierarchy instead of building every node's components one at a time.
+void rbe_prefab_registry_initialize();
+void rbe_prefab_registry_finalize();
+// Captures the current components and hierarchy of a scene node, replaces a prefab with the same name
+void rbe_prefab_registry_register(const char* name, Entity rootEntity);
+bool rbe_prefab_registry_has(const char* name);
+// Clones the prefab as a child of 'parent' and queues its nodes for creation, returns the new root entity
+Entity rbe_prefab_registry_instantiate(const char* name, Entity parent);
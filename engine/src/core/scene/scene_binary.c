@@ -0,0 +1,453 @@
+#include "scene_binary.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "scene_manager.h"
+#include "../asset_manager.h"
+#include "../ecs/component/animated_sprite_component.h"
+#include "../ecs/component/collider2d_component.h"
+#include "../ecs/component/color_square_component.h"
+#include "../ecs/component/script_component.h"
+#include "../ecs/component/sprite_component.h"
+#include "../ecs/component/text_label_component.h"
+#include "../ecs/component/transform2d_component.h"
+#include "../ecs/system/ec_system.h"
+#include "../data_structures/rbe_hash_map_string.h"
+#include "../memory/rbe_mem.h"
+#include "../utils/rbe_file_system_utils.h"
+#include "../utils/logger.h"
+#include "../utils/rbe_assert.h"
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4996) // for fopen
+#endif
+
+#define SCENE_BINARY_MAGIC "RBES"
+// Bump when any of the record layouts change, files are raw structs so older ones can't be read
+#define SCENE_BINARY_VERSION 1
+
+typedef struct SceneBinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t componentCount;
+    uint32_t animationCount;
+    uint32_t animationFrameCount;
+    uint32_t stringTableSize;
+} SceneBinaryHeader;
+
+// Sections point into 'data', which is the whole blob
+struct SceneBinary {
+    char* data;
+    size_t size;
+    const SceneBinaryHeader* header;
+    const SceneBinaryNode* nodes;
+    const SceneBinaryComponent* components;
+    const SceneBinaryAnimation* animations;
+    const SceneBinaryAnimationFrame* animationFrames;
+    const char* strings;
+};
+
+struct SceneBinaryBuilder {
+    SceneBinaryNode* nodes;
+    size_t nodeCount;
+    size_t nodeCapacity;
+    SceneBinaryComponent* components;
+    size_t componentCount;
+    size_t componentCapacity;
+    SceneBinaryAnimation* animations;
+    size_t animationCount;
+    size_t animationCapacity;
+    SceneBinaryAnimationFrame* animationFrames;
+    size_t animationFrameCount;
+    size_t animationFrameCapacity;
+    char* strings;
+    size_t stringsSize;
+    size_t stringsCapacity;
+    RBEStringHashMap* stringOffsets; // Repeated strings (texture paths, script classes) are stored once
+};
+
+// Scratch for instantiation, only grows
+static Entity* instanceEntities = NULL;
+static uint32_t* instanceStack = NULL;
+static size_t instanceCapacity = 0;
+
+void* scene_binary_grow(void* array, size_t count, size_t* capacity, size_t elementSize);
+size_t scene_binary_get_expected_size(const SceneBinaryHeader* header);
+void scene_binary_set_sections(SceneBinary* sceneBinary);
+void scene_binary_add_component(const SceneBinary* sceneBinary, Entity entity, const SceneBinaryComponent* component);
+
+// --- Scene Binary Builder --- //
+SceneBinaryBuilder* rbe_scene_binary_builder_create() {
+    SceneBinaryBuilder* builder = RBE_MEM_ALLOCATE(SceneBinaryBuilder);
+    memset(builder, 0, sizeof(SceneBinaryBuilder));
+    builder->stringOffsets = rbe_string_hash_map_create(32);
+    // Offset 0 is the empty string
+    rbe_scene_binary_builder_add_string(builder, "");
+    return builder;
+}
+
+SceneBinaryString rbe_scene_binary_builder_add_string(SceneBinaryBuilder* builder, const char* string) {
+    RBE_ASSERT(string != NULL);
+    if (rbe_string_hash_map_has(builder->stringOffsets, string)) {
+        return (SceneBinaryString) rbe_string_hash_map_get_int(builder->stringOffsets, string);
+    }
+    const size_t stringSize = strlen(string) + 1;
+    if (builder->stringsSize + stringSize > builder->stringsCapacity) {
+        builder->stringsCapacity = builder->stringsCapacity == 0 ? 256 : builder->stringsCapacity;
+        while (builder->stringsSize + stringSize > builder->stringsCapacity) {
+            builder->stringsCapacity *= 2;
+        }
+        builder->strings = RBE_MEM_REALLOCATE(builder->strings, builder->stringsCapacity);
+    }
+    const SceneBinaryString offset = (SceneBinaryString) builder->stringsSize;
+    memcpy(builder->strings + offset, string, stringSize);
+    builder->stringsSize += stringSize;
+    rbe_string_hash_map_add_int(builder->stringOffsets, string, (int) offset);
+    return offset;
+}
+
+uint32_t rbe_scene_binary_builder_add_node(SceneBinaryBuilder* builder, uint32_t parentIndex, const char* name, NodeBaseType type) {
+    RBE_ASSERT_FMT(parentIndex == RBE_SCENE_BINARY_NO_PARENT || parentIndex < builder->nodeCount, "Node '%s' added before its parent!", name);
+    RBE_ASSERT_FMT(type != NodeBaseType_INVALID, "Node '%s' has an invalid node type!", name);
+    builder->nodes = scene_binary_grow(builder->nodes, builder->nodeCount, &builder->nodeCapacity, sizeof(SceneBinaryNode));
+    const uint32_t nodeIndex = (uint32_t) builder->nodeCount++;
+    builder->nodes[nodeIndex] = (SceneBinaryNode) {
+        .parentIndex = parentIndex,
+        .name = rbe_scene_binary_builder_add_string(builder, name),
+        .type = type,
+        .firstComponent = (uint32_t) builder->componentCount,
+        .componentCount = 0
+    };
+    return nodeIndex;
+}
+
+void rbe_scene_binary_builder_add_component(SceneBinaryBuilder* builder, const SceneBinaryComponent* component) {
+    RBE_ASSERT_FMT(builder->nodeCount > 0, "Component added before any node!");
+    RBE_ASSERT(component->type > ComponentDataIndex_NODE && component->type < MAX_COMPONENTS);
+    builder->components = scene_binary_grow(builder->components, builder->componentCount, &builder->componentCapacity, sizeof(SceneBinaryComponent));
+    SceneBinaryComponent* newComponent = &builder->components[builder->componentCount++];
+    *newComponent = *component;
+    if (newComponent->type == ComponentDataIndex_ANIMATED_SPRITE) {
+        newComponent->animatedSprite.firstAnimation = (uint32_t) builder->animationCount;
+        newComponent->animatedSprite.animationCount = 0;
+    }
+    builder->nodes[builder->nodeCount - 1].componentCount++;
+}
+
+void rbe_scene_binary_builder_add_animation(SceneBinaryBuilder* builder, const char* name, int speed, bool doesLoop) {
+    RBE_ASSERT_FMT(builder->componentCount > 0 && builder->components[builder->componentCount - 1].type == ComponentDataIndex_ANIMATED_SPRITE,
+                   "Animation '%s' needs to be added after an animated sprite component!", name);
+    // Names are copied into a fixed size buffer when instantiated
+    RBE_ASSERT_FMT(strlen(name) < sizeof(((Animation*) NULL)->name), "Animation name '%s' is too long!", name);
+    SceneBinaryAnimatedSprite* animatedSprite = &builder->components[builder->componentCount - 1].animatedSprite;
+    RBE_ASSERT_FMT(animatedSprite->animationCount < ANIMATED_SPRITE_COMPONENT_MAX_ANIMATIONS, "Too many animations, can't add '%s'!", name);
+    builder->animations = scene_binary_grow(builder->animations, builder->animationCount, &builder->animationCapacity, sizeof(SceneBinaryAnimation));
+    builder->animations[builder->animationCount++] = (SceneBinaryAnimation) {
+        .name = rbe_scene_binary_builder_add_string(builder, name),
+        .speed = speed,
+        .doesLoop = doesLoop,
+        .firstFrame = (uint32_t) builder->animationFrameCount,
+        .frameCount = 0
+    };
+    animatedSprite->animationCount++;
+}
+
+void rbe_scene_binary_builder_add_animation_frame(SceneBinaryBuilder* builder, const SceneBinaryAnimationFrame* animationFrame) {
+    RBE_ASSERT_FMT(builder->animationCount > 0, "Animation frame added before any animation!");
+    RBE_ASSERT_FMT(animationFrame->frame >= 0 && animationFrame->frame < RBE_MAX_ANIMATION_FRAMES, "Invalid animation frame '%d'!", animationFrame->frame);
+    builder->animationFrames = scene_binary_grow(builder->animationFrames, builder->animationFrameCount, &builder->animationFrameCapacity, sizeof(SceneBinaryAnimationFrame));
+    builder->animationFrames[builder->animationFrameCount++] = *animationFrame;
+    builder->animations[builder->animationCount - 1].frameCount++;
+}
+
+SceneBinary* rbe_scene_binary_builder_finish(SceneBinaryBuilder* builder) {
+    const SceneBinaryHeader header = {
+        .magic = { 'R', 'B', 'E', 'S' },
+        .version = SCENE_BINARY_VERSION,
+        .nodeCount = (uint32_t) builder->nodeCount,
+        .componentCount = (uint32_t) builder->componentCount,
+        .animationCount = (uint32_t) builder->animationCount,
+        .animationFrameCount = (uint32_t) builder->animationFrameCount,
+        .stringTableSize = (uint32_t) builder->stringsSize
+    };
+    SceneBinary* sceneBinary = RBE_MEM_ALLOCATE(SceneBinary);
+    sceneBinary->size = scene_binary_get_expected_size(&header);
+    sceneBinary->data = RBE_MEM_ALLOCATE_SIZE(sceneBinary->size);
+    // Sections are written back to back, every record is a multiple of 4 bytes so they stay aligned
+    char* writePtr = sceneBinary->data;
+#define SCENE_BINARY_WRITE_SECTION(SOURCE, SIZE) \
+    if ((SIZE) > 0) { memcpy(writePtr, (SOURCE), (SIZE)); } \
+    writePtr += (SIZE);
+    SCENE_BINARY_WRITE_SECTION(&header, sizeof(SceneBinaryHeader));
+    SCENE_BINARY_WRITE_SECTION(builder->nodes, builder->nodeCount * sizeof(SceneBinaryNode));
+    SCENE_BINARY_WRITE_SECTION(builder->components, builder->componentCount * sizeof(SceneBinaryComponent));
+    SCENE_BINARY_WRITE_SECTION(builder->animations, builder->animationCount * sizeof(SceneBinaryAnimation));
+    SCENE_BINARY_WRITE_SECTION(builder->animationFrames, builder->animationFrameCount * sizeof(SceneBinaryAnimationFrame));
+    SCENE_BINARY_WRITE_SECTION(builder->strings, builder->stringsSize);
+#undef SCENE_BINARY_WRITE_SECTION
+    RBE_ASSERT((size_t) (writePtr - sceneBinary->data) == sceneBinary->size);
+    scene_binary_set_sections(sceneBinary);
+
+    if (builder->nodes != NULL) {
+        RBE_MEM_FREE(builder->nodes);
+    }
+    if (builder->components != NULL) {
+        RBE_MEM_FREE(builder->components);
+    }
+    if (builder->animations != NULL) {
+        RBE_MEM_FREE(builder->animations);
+    }
+    if (builder->animationFrames != NULL) {
+        RBE_MEM_FREE(builder->animationFrames);
+    }
+    RBE_MEM_FREE(builder->strings);
+    rbe_string_hash_map_destroy(builder->stringOffsets);
+    RBE_MEM_FREE(builder);
+    return sceneBinary;
+}
+
+void* scene_binary_grow(void* array, size_t count, size_t* capacity, size_t elementSize) {
+    if (count < *capacity) {
+        return array;
+    }
+    *capacity = *capacity == 0 ? 16 : *capacity * 2;
+    return RBE_MEM_REALLOCATE(array, *capacity * elementSize);
+}
+
+// --- Scene Binary --- //
+void rbe_scene_binary_finalize() {
+    if (instanceEntities != NULL) {
+        RBE_MEM_FREE(instanceEntities);
+        RBE_MEM_FREE(instanceStack);
+    }
+    instanceEntities = NULL;
+    instanceStack = NULL;
+    instanceCapacity = 0;
+}
+
+void rbe_scene_binary_destroy(SceneBinary* sceneBinary) {
+    RBE_MEM_FREE(sceneBinary->data);
+    RBE_MEM_FREE(sceneBinary);
+}
+
+size_t rbe_scene_binary_get_node_count(const SceneBinary* sceneBinary) {
+    return sceneBinary->header->nodeCount;
+}
+
+const char* rbe_scene_binary_get_string(const SceneBinary* sceneBinary, SceneBinaryString string) {
+    RBE_ASSERT_FMT(string < sceneBinary->header->stringTableSize, "Invalid scene binary string offset '%u'!", string);
+    return sceneBinary->strings + string;
+}
+
+SceneBinary* rbe_scene_binary_load_file(const char* filePath) {
+    size_t fileSize = 0;
+    char* fileContents = rbe_fs_read_file_contents(filePath, &fileSize);
+    if (fileContents == NULL) {
+        rbe_logger_error("Failed to read scene binary file '%s'!", filePath);
+        return NULL;
+    }
+    const SceneBinaryHeader* header = (SceneBinaryHeader*) fileContents;
+    if (fileSize < sizeof(SceneBinaryHeader)
+            || memcmp(header->magic, SCENE_BINARY_MAGIC, sizeof(header->magic)) != 0
+            || header->version != SCENE_BINARY_VERSION
+            || scene_binary_get_expected_size(header) != fileSize) {
+        rbe_logger_error("'%s' isn't a compatible scene binary file!", filePath);
+        RBE_MEM_FREE(fileContents);
+        return NULL;
+    }
+    SceneBinary* sceneBinary = RBE_MEM_ALLOCATE(SceneBinary);
+    sceneBinary->data = fileContents;
+    sceneBinary->size = fileSize;
+    scene_binary_set_sections(sceneBinary);
+    // The string table must be terminated so strings can't be read past the end of the blob
+    if (header->stringTableSize == 0 || sceneBinary->strings[header->stringTableSize - 1] != '\0') {
+        rbe_logger_error("Scene binary file '%s' has an invalid string table!", filePath);
+        rbe_scene_binary_destroy(sceneBinary);
+        return NULL;
+    }
+    return sceneBinary;
+}
+
+bool rbe_scene_binary_save_file(const SceneBinary* sceneBinary, const char* filePath) {
+    FILE* file = fopen(filePath, "wb");
+    if (file == NULL) {
+        rbe_logger_error("Failed to open '%s' to write scene binary!", filePath);
+        return false;
+    }
+    const bool success = fwrite(sceneBinary->data, 1, sceneBinary->size, file) == sceneBinary->size;
+    fclose(file);
+    if (!success) {
+        rbe_logger_error("Failed to write scene binary to '%s'!", filePath);
+    }
+    return success;
+}
+
+Entity rbe_scene_binary_instantiate(const SceneBinary* sceneBinary, Entity parent) {
+    const size_t nodeCount = sceneBinary->header->nodeCount;
+    if (nodeCount == 0) {
+        return NULL_ENTITY;
+    }
+    if (nodeCount > instanceCapacity) {
+        instanceCapacity = nodeCount;
+        instanceEntities = RBE_MEM_REALLOCATE(instanceEntities, instanceCapacity * sizeof(Entity));
+        instanceStack = RBE_MEM_REALLOCATE(instanceStack, instanceCapacity * sizeof(uint32_t));
+    }
+    RBE_ASSERT_FMT(parent == NULL_ENTITY || rbe_scene_manager_has_entity_tree_node(parent), "Parent entity '%u' isn't in the scene tree!", parent);
+    for (size_t i = 0; i < nodeCount; i++) {
+        const SceneBinaryNode* node = &sceneBinary->nodes[i];
+        RBE_ASSERT_FMT(node->parentIndex == RBE_SCENE_BINARY_NO_PARENT || node->parentIndex < i, "Scene binary node '%zu' isn't stored after its parent!", i);
+        const Entity entity = rbe_ec_system_create_entity();
+        instanceEntities[i] = entity;
+        rbe_scene_tree_create_tree_node(entity, node->parentIndex == RBE_SCENE_BINARY_NO_PARENT ? parent : instanceEntities[node->parentIndex]);
+        // Node component is used for all scene nodes
+        NodeComponent* nodeComponent = node_component_create();
+        nodeComponent->name = rbe_string_intern(rbe_scene_binary_get_string(sceneBinary, node->name));
+        nodeComponent->type = node->type;
+        component_manager_set_component(entity, ComponentDataIndex_NODE, nodeComponent);
+        RBE_ASSERT(node->firstComponent + node->componentCount <= sceneBinary->header->componentCount);
+        for (uint32_t componentIndex = node->firstComponent; componentIndex < node->firstComponent + node->componentCount; componentIndex++) {
+            scene_binary_add_component(sceneBinary, entity, &sceneBinary->components[componentIndex]);
+        }
+        rbe_ec_system_update_entity_signature_with_systems(entity);
+    }
+    // Queued children before parents with siblings kept in order, a node is queued once the next node isn't in its subtree
+    size_t stackCount = 0;
+    for (uint32_t i = 0; i < (uint32_t) nodeCount; i++) {
+        while (stackCount > 0 && instanceStack[stackCount - 1] != sceneBinary->nodes[i].parentIndex) {
+            rbe_scene_manager_queue_entity_for_creation(instanceEntities[instanceStack[--stackCount]]);
+        }
+        instanceStack[stackCount++] = i;
+    }
+    while (stackCount > 0) {
+        rbe_scene_manager_queue_entity_for_creation(instanceEntities[instanceStack[--stackCount]]);
+    }
+    rbe_logger_debug("Instantiated scene binary with '%zu' nodes", nodeCount);
+    return instanceEntities[0];
+}
+
+size_t scene_binary_get_expected_size(const SceneBinaryHeader* header) {
+    return sizeof(SceneBinaryHeader)
+           + (size_t) header->nodeCount * sizeof(SceneBinaryNode)
+           + (size_t) header->componentCount * sizeof(SceneBinaryComponent)
+           + (size_t) header->animationCount * sizeof(SceneBinaryAnimation)
+           + (size_t) header->animationFrameCount * sizeof(SceneBinaryAnimationFrame)
+           + (size_t) header->stringTableSize;
+}
+
+void scene_binary_set_sections(SceneBinary* sceneBinary) {
+    const char* readPtr = sceneBinary->data;
+    sceneBinary->header = (const SceneBinaryHeader*) readPtr;
+    readPtr += sizeof(SceneBinaryHeader);
+    sceneBinary->nodes = (const SceneBinaryNode*) readPtr;
+    readPtr += sceneBinary->header->nodeCount * sizeof(SceneBinaryNode);
+    sceneBinary->components = (const SceneBinaryComponent*) readPtr;
+    readPtr += sceneBinary->header->componentCount * sizeof(SceneBinaryComponent);
+    sceneBinary->animations = (const SceneBinaryAnimation*) readPtr;
+    readPtr += sceneBinary->header->animationCount * sizeof(SceneBinaryAnimation);
+    sceneBinary->animationFrames = (const SceneBinaryAnimationFrame*) readPtr;
+    readPtr += sceneBinary->header->animationFrameCount * sizeof(SceneBinaryAnimationFrame);
+    sceneBinary->strings = readPtr;
+}
+
+void scene_binary_add_component(const SceneBinary* sceneBinary, Entity entity, const SceneBinaryComponent* component) {
+    switch (component->type) {
+    case ComponentDataIndex_TRANSFORM_2D: {
+        Transform2DComponent* transform2DComponent = transform2d_component_create();
+        transform2DComponent->localTransform = component->transform2D.localTransform;
+        transform2DComponent->zIndex = component->transform2D.zIndex;
+        transform2DComponent->isZIndexRelativeToParent = component->transform2D.isZIndexRelativeToParent;
+        transform2DComponent->ignoreCamera = component->transform2D.ignoreCamera;
+        component_manager_set_component(entity, ComponentDataIndex_TRANSFORM_2D, transform2DComponent);
+        break;
+    }
+    case ComponentDataIndex_SPRITE: {
+        const char* texturePath = rbe_scene_binary_get_string(sceneBinary, component->sprite.texturePath);
+        SpriteComponent* spriteComponent = sprite_component_create();
+        spriteComponent->texture = rbe_asset_manager_get_texture(texturePath);
+        RBE_ASSERT_FMT(spriteComponent->texture != NULL, "Unable to read texture path '%s'", texturePath);
+        spriteComponent->drawSource = component->sprite.drawSource;
+        spriteComponent->origin = component->sprite.origin;
+        spriteComponent->flipX = component->sprite.flipX;
+        spriteComponent->flipY = component->sprite.flipY;
+        spriteComponent->modulate = component->sprite.modulate;
+        component_manager_set_component(entity, ComponentDataIndex_SPRITE, spriteComponent);
+        break;
+    }
+    case ComponentDataIndex_ANIMATED_SPRITE: {
+        const SceneBinaryAnimatedSprite* binaryAnimatedSprite = &component->animatedSprite;
+        const char* currentAnimationName = rbe_scene_binary_get_string(sceneBinary, binaryAnimatedSprite->currentAnimationName);
+        AnimatedSpriteComponent* animatedSpriteComponent = animated_sprite_component_create();
+        animatedSpriteComponent->isPlaying = binaryAnimatedSprite->isPlaying;
+        animatedSpriteComponent->origin = binaryAnimatedSprite->origin;
+        animatedSpriteComponent->flipX = binaryAnimatedSprite->flipX;
+        animatedSpriteComponent->flipY = binaryAnimatedSprite->flipY;
+        RBE_ASSERT(binaryAnimatedSprite->firstAnimation + binaryAnimatedSprite->animationCount <= sceneBinary->header->animationCount);
+        for (uint32_t animationIndex = 0; animationIndex < binaryAnimatedSprite->animationCount; animationIndex++) {
+            const SceneBinaryAnimation* binaryAnimation = &sceneBinary->animations[binaryAnimatedSprite->firstAnimation + animationIndex];
+            Animation animation;
+            memset(&animation, 0, sizeof(Animation));
+            animation.isValid = true;
+            animation.speed = binaryAnimation->speed;
+            animation.doesLoop = binaryAnimation->doesLoop;
+            strncpy(animation.name, rbe_scene_binary_get_string(sceneBinary, binaryAnimation->name), sizeof(animation.name) - 1);
+            RBE_ASSERT(binaryAnimation->firstFrame + binaryAnimation->frameCount <= sceneBinary->header->animationFrameCount);
+            for (uint32_t frameIndex = 0; frameIndex < binaryAnimation->frameCount; frameIndex++) {
+                const SceneBinaryAnimationFrame* binaryFrame = &sceneBinary->animationFrames[binaryAnimation->firstFrame + frameIndex];
+                RBE_ASSERT_FMT(binaryFrame->frame >= 0 && binaryFrame->frame < RBE_MAX_ANIMATION_FRAMES, "Invalid animation frame '%d'!", binaryFrame->frame);
+                AnimationFrame animationFrame;
+                animationFrame.texture = rbe_asset_manager_get_texture(rbe_scene_binary_get_string(sceneBinary, binaryFrame->texturePath));
+                RBE_ASSERT(animationFrame.texture != NULL);
+                animationFrame.frame = binaryFrame->frame;
+                animationFrame.drawSource = binaryFrame->drawSource;
+                animation.animationFrames[animationFrame.frame] = animationFrame;
+                animation.frameCount++;
+            }
+            animated_sprite_component_add_animation(animatedSpriteComponent, animation);
+            // Set current animation if the name matches
+            if (strcmp(animation.name, currentAnimationName) == 0) {
+                animatedSpriteComponent->currentAnimation = animation;
+            }
+        }
+        component_manager_set_component(entity, ComponentDataIndex_ANIMATED_SPRITE, animatedSpriteComponent);
+        break;
+    }
+    case ComponentDataIndex_TEXT_LABEL: {
+        TextLabelComponent* textLabelComponent = text_label_component_create();
+        textLabelComponent->font = rbe_asset_manager_get_font(rbe_scene_binary_get_string(sceneBinary, component->textLabel.fontUID));
+        RBE_ASSERT(textLabelComponent->font != NULL);
+        text_label_component_set_text(textLabelComponent, rbe_scene_binary_get_string(sceneBinary, component->textLabel.text));
+        textLabelComponent->color = component->textLabel.color;
+        component_manager_set_component(entity, ComponentDataIndex_TEXT_LABEL, textLabelComponent);
+        break;
+    }
+    case ComponentDataIndex_SCRIPT: {
+        // Script classes are referenced by path and name, the script context creates the instance once the node is created
+        ScriptComponent* scriptComponent = script_component_create();
+        scriptComponent->classPath = rbe_scene_binary_get_string(sceneBinary, component->script.classPath);
+        scriptComponent->className = rbe_scene_binary_get_string(sceneBinary, component->script.className);
+        scriptComponent->contextType = ScriptContextType_PYTHON;
+        component_manager_set_component(entity, ComponentDataIndex_SCRIPT, scriptComponent);
+        break;
+    }
+    case ComponentDataIndex_COLLIDER_2D: {
+        Collider2DComponent* collider2DComponent = collider2d_component_create();
+        collider2DComponent->extents = component->collider2D.extents;
+        collider2DComponent->color = component->collider2D.color;
+        collider2DComponent->collisionExceptionCount = 0;
+        component_manager_set_component(entity, ComponentDataIndex_COLLIDER_2D, collider2DComponent);
+        break;
+    }
+    case ComponentDataIndex_COLOR_SQUARE: {
+        ColorSquareComponent* colorSquareComponent = color_square_component_create();
+        colorSquareComponent->size = component->colorSquare.size;
+        colorSquareComponent->color = component->colorSquare.color;
+        component_manager_set_component(entity, ComponentDataIndex_COLOR_SQUARE, colorSquareComponent);
+        break;
+    }
+    default:
+        rbe_logger_error("Invalid scene binary component type '%d'", component->type);
+        break;
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../ecs/entity/entity.h"
+#include "../ecs/component/component.h"
+#include "../ecs/component/node_component.h"
+#include "../math/rbe_math.h"
+
+// Compiled scene definition, one contiguous blob laid out as
+//   header | nodes | components | animations | animation frames | string table
+// Nodes are stored parent first and reference their components as a range, strings are offsets into the string table.
+// Instantiating a scene binary creates entities and components directly without going through python.
+#define RBE_SCENE_BINARY_FILE_EXTENSION ".rbscene"
+#define RBE_SCENE_BINARY_NO_PARENT UINT32_MAX
+
+typedef uint32_t SceneBinaryString; // Offset into the string table, 0 is the empty string
+
+typedef struct SceneBinaryNode {
+    uint32_t parentIndex;
+    SceneBinaryString name;
+    NodeBaseType type;
+    uint32_t firstComponent;
+    uint32_t componentCount;
+} SceneBinaryNode;
+
+typedef struct SceneBinaryTransform2D {
+    Transform2D localTransform;
+    int zIndex;
+    bool isZIndexRelativeToParent;
+    bool ignoreCamera;
+} SceneBinaryTransform2D;
+
+typedef struct SceneBinarySprite {
+    SceneBinaryString texturePath;
+    Rect2 drawSource;
+    Vector2 origin;
+    bool flipX;
+    bool flipY;
+    Color modulate;
+} SceneBinarySprite;
+
+typedef struct SceneBinaryAnimatedSprite {
+    SceneBinaryString currentAnimationName;
+    bool isPlaying;
+    Vector2 origin;
+    bool flipX;
+    bool flipY;
+    uint32_t firstAnimation;
+    uint32_t animationCount;
+} SceneBinaryAnimatedSprite;
+
+typedef struct SceneBinaryTextLabel {
+    SceneBinaryString fontUID;
+    SceneBinaryString text;
+    Color color;
+} SceneBinaryTextLabel;
+
+typedef struct SceneBinaryScript {
+    SceneBinaryString classPath;
+    SceneBinaryString className;
+} SceneBinaryScript;
+
+typedef struct SceneBinaryCollider2D {
+    Size2D extents;
+    Color color;
+} SceneBinaryCollider2D;
+
+typedef struct SceneBinaryColorSquare {
+    Size2D size;
+    Color color;
+} SceneBinaryColorSquare;
+
+typedef struct SceneBinaryComponent {
+    ComponentDataIndex type;
+    union {
+        SceneBinaryTransform2D transform2D;
+        SceneBinarySprite sprite;
+        SceneBinaryAnimatedSprite animatedSprite;
+        SceneBinaryTextLabel textLabel;
+        SceneBinaryScript script;
+        SceneBinaryCollider2D collider2D;
+        SceneBinaryColorSquare colorSquare;
+    };
+} SceneBinaryComponent;
+
+typedef struct SceneBinaryAnimation {
+    SceneBinaryString name;
+    int speed;
+    bool doesLoop;
+    uint32_t firstFrame;
+    uint32_t frameCount;
+} SceneBinaryAnimation;
+
+typedef struct SceneBinaryAnimationFrame {
+    SceneBinaryString texturePath;
+    Rect2 drawSource;
+    int frame;
+} SceneBinaryAnimationFrame;
+
+typedef struct SceneBinary SceneBinary;
+typedef struct SceneBinaryBuilder SceneBinaryBuilder;
+
+// --- Scene Binary Builder --- //
+// Nodes must be added parent first, components and animations belong to the last added node and component
+SceneBinaryBuilder* rbe_scene_binary_builder_create();
+SceneBinaryString rbe_scene_binary_builder_add_string(SceneBinaryBuilder* builder, const char* string);
+uint32_t rbe_scene_binary_builder_add_node(SceneBinaryBuilder* builder, uint32_t parentIndex, const char* name, NodeBaseType type);
+void rbe_scene_binary_builder_add_component(SceneBinaryBuilder* builder, const SceneBinaryComponent* component);
+// Adds to the last added animated sprite component
+void rbe_scene_binary_builder_add_animation(SceneBinaryBuilder* builder, const char* name, int speed, bool doesLoop);
+// Adds to the last added animation
+void rbe_scene_binary_builder_add_animation_frame(SceneBinaryBuilder* builder, const SceneBinaryAnimationFrame* animationFrame);
+// Packs everything added into a scene binary and destroys the builder
+SceneBinary* rbe_scene_binary_builder_finish(SceneBinaryBuilder* builder);
+
+// --- Scene Binary --- //
+// Frees scratch used while instantiating
+void rbe_scene_binary_finalize();
+void rbe_scene_binary_destroy(SceneBinary* sceneBinary);
+size_t rbe_scene_binary_get_node_count(const SceneBinary* sceneBinary);
+const char* rbe_scene_binary_get_string(const SceneBinary* sceneBinary, SceneBinaryString string);
+// Returns NULL if the file is missing or isn't a compatible scene binary
+SceneBinary* rbe_scene_binary_load_file(const char* filePath);
+bool rbe_scene_binary_save_file(const SceneBinary* sceneBinary, const char* filePath);
+// Creates the scene's nodes under 'parent' and queues them for creation, returns the first root node's entity or
+// NULL_ENTITY if the scene is empty.
+// Script components point at the scene binary's strings, so it needs to outlive the instantiated nodes.
+Entity rbe_scene_binary_instantiate(const SceneBinary* sceneBinary, Entity parent);
@@ -1,5 +1,8 @@
+#include <stdio.h>
 #include <string.h>
 #include "scene_manager.h"
+#include "prefab_registry.h"
+#include "scene_binary.h"
 
 #include "../math/rbe_math.h"
 #include "../scripting/python/py_helper.h"
@@ -10,30 +13,137 @@
 #include "../ecs/component/node_component.h"
 #include "../memory/rbe_mem.h"
 #include "../data_structures/rbe_hash_map.h"
+#include "../data_structures/rbe_hash_map_string.h"
+#include "../data_structures/rbe_dynamic_array.h"
+#include "../utils/rbe_string_intern.h"
 #include "../utils/logger.h"
 #include "../utils/rbe_assert.h"
 
 // --- Scene Tree --- //
 typedef void (*ExecuteOnAllTreeNodesFunc) (SceneTreeNode*);
 
-// Executes function on passed in tree node and all child tree nodes
-void rbe_scene_execute_on_all_tree_nodes(SceneTreeNode* treeNode, ExecuteOnAllTreeNodesFunc func) {
-    for (size_t i = 0; i < treeNode->childCount; i++) {
-        rbe_scene_execute_on_all_tree_nodes(treeNode->children[i], func);
+// Slots are empty while their entity is NULL_ENTITY
+static SceneTreeNode* treeNodes = NULL;
+static size_t treeNodeCapacity = 0;
+
+static inline SceneTreeNode* scene_tree_get_node(Entity entity) {
+    return &treeNodes[entity_get_index(entity)];
+}
+
+// Executes function on passed in tree node and all child tree nodes, children first
+void rbe_scene_execute_on_all_tree_nodes(Entity entity, ExecuteOnAllTreeNodesFunc func) {
+    for (Entity child = scene_tree_get_node(entity)->firstChild; child != NULL_ENTITY; child = scene_tree_get_node(child)->nextSibling) {
+        rbe_scene_execute_on_all_tree_nodes(child, func);
     }
-    func(treeNode);
+    func(scene_tree_get_node(entity));
 }
 
 typedef struct SceneTree {
-    SceneTreeNode* root;
+    Entity root;
 } SceneTree;
 
-SceneTreeNode* rbe_scene_tree_create_tree_node(Entity entity, SceneTreeNode* parent) {
-    SceneTreeNode* treeNode = RBE_MEM_ALLOCATE(SceneTreeNode);
-    treeNode->entity = entity;
-    treeNode->parent = parent;
-    treeNode->childCount = 0;
-    return treeNode;
+void rbe_scene_tree_create_tree_node(Entity entity, Entity parent) {
+    const uint32_t entityIndex = entity_get_index(entity);
+    if (entityIndex >= treeNodeCapacity) {
+        const size_t oldCapacity = treeNodeCapacity;
+        treeNodeCapacity = oldCapacity == 0 ? 64 : oldCapacity;
+        while (entityIndex >= treeNodeCapacity) {
+            treeNodeCapacity *= 2;
+        }
+        treeNodes = RBE_MEM_REALLOCATE(treeNodes, treeNodeCapacity * sizeof(SceneTreeNode));
+        memset(treeNodes + oldCapacity, 0, (treeNodeCapacity - oldCapacity) * sizeof(SceneTreeNode));
+    }
+    SceneTreeNode* treeNode = &treeNodes[entityIndex];
+    RBE_ASSERT_FMT(treeNode->entity == NULL_ENTITY, "Entity '%u' already has a tree node!", entity);
+    *treeNode = (SceneTreeNode) { .entity = entity, .parent = parent };
+    if (parent != NULL_ENTITY) {
+        RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(parent), "Parent entity '%u' isn't in the scene tree!", parent);
+        SceneTreeNode* parentNode = scene_tree_get_node(parent);
+        if (parentNode->lastChild != NULL_ENTITY) {
+            scene_tree_get_node(parentNode->lastChild)->nextSibling = entity;
+            treeNode->prevSibling = parentNode->lastChild;
+        } else {
+            parentNode->firstChild = entity;
+        }
+        parentNode->lastChild = entity;
+        parentNode->childCount++;
+    }
+}
+
+// Children are looked up by interned name through one table keyed by parent and name.  They're indexed once queued for
+// creation and the first child added with a name wins, like the linear search it replaces.
+typedef struct SceneTreeChildNameKey {
+    Entity parent;
+    StringId name;
+} SceneTreeChildNameKey;
+
+static RBEHashMap* childNameIndex = NULL;
+
+StringId scene_tree_get_node_name(Entity entity) {
+    const NodeComponent* nodeComponent = component_manager_get_component_unsafe(entity, ComponentDataIndex_NODE);
+    return nodeComponent != NULL ? nodeComponent->name : RBE_STRING_ID_NONE;
+}
+
+void scene_tree_index_child_name(Entity entity) {
+    const Entity parent = scene_tree_get_node(entity)->parent;
+    SceneTreeChildNameKey key = { .parent = parent, .name = scene_tree_get_node_name(entity) };
+    if (parent != NULL_ENTITY && key.name != RBE_STRING_ID_NONE && !rbe_hash_map_has(childNameIndex, &key)) {
+        rbe_hash_map_add(childNameIndex, &key, &entity);
+    }
+}
+
+void scene_tree_unindex_child_name(Entity entity) {
+    const Entity parent = scene_tree_get_node(entity)->parent;
+    SceneTreeChildNameKey key = { .parent = parent, .name = scene_tree_get_node_name(entity) };
+    if (parent == NULL_ENTITY || key.name == RBE_STRING_ID_NONE) {
+        return;
+    }
+    const Entity* indexedChild = (Entity*) rbe_hash_map_get(childNameIndex, &key);
+    if (indexedChild != NULL && *indexedChild == entity) {
+        rbe_hash_map_erase(childNameIndex, &key);
+        // Next sibling with the same name takes its place
+        for (Entity sibling = scene_tree_get_node(parent)->firstChild; sibling != NULL_ENTITY; sibling = scene_tree_get_node(sibling)->nextSibling) {
+            if (sibling != entity && scene_tree_get_node_name(sibling) == key.name) {
+                rbe_hash_map_add(childNameIndex, &key, &sibling);
+                break;
+            }
+        }
+    }
+}
+
+Entity scene_tree_get_child_by_name(Entity parent, StringId name) {
+    SceneTreeChildNameKey key = { .parent = parent, .name = name };
+    const Entity* child = (Entity*) rbe_hash_map_get(childNameIndex, &key);
+    return child != NULL ? *child : NULL_ENTITY;
+}
+
+// Unlinks the node from its parent, remaining children become roots
+void scene_tree_remove_tree_node(Entity entity) {
+    scene_tree_unindex_child_name(entity);
+    SceneTreeNode* treeNode = scene_tree_get_node(entity);
+    if (treeNode->parent != NULL_ENTITY) {
+        SceneTreeNode* parentNode = scene_tree_get_node(treeNode->parent);
+        if (treeNode->prevSibling != NULL_ENTITY) {
+            scene_tree_get_node(treeNode->prevSibling)->nextSibling = treeNode->nextSibling;
+        } else {
+            parentNode->firstChild = treeNode->nextSibling;
+        }
+        if (treeNode->nextSibling != NULL_ENTITY) {
+            scene_tree_get_node(treeNode->nextSibling)->prevSibling = treeNode->prevSibling;
+        } else {
+            parentNode->lastChild = treeNode->prevSibling;
+        }
+        parentNode->childCount--;
+    }
+    for (Entity child = treeNode->firstChild; child != NULL_ENTITY;) {
+        scene_tree_unindex_child_name(child);
+        SceneTreeNode* childNode = scene_tree_get_node(child);
+        child = childNode->nextSibling;
+        childNode->parent = NULL_ENTITY;
+        childNode->prevSibling = NULL_ENTITY;
+        childNode->nextSibling = NULL_ENTITY;
+    }
+    *treeNode = (SceneTreeNode) { .entity = NULL_ENTITY };
 }
 
 // --- Scene --- //
@@ -46,73 +156,111 @@ Scene* rbe_scene_create_scene(const char* scenePath) {
     Scene* scene = RBE_MEM_ALLOCATE(Scene);
     scene->scenePath = scenePath;
     scene->sceneTree = RBE_MEM_ALLOCATE(SceneTree);
-    scene->sceneTree->root = NULL;
+    scene->sceneTree->root = NULL_ENTITY;
     return scene;
 }
 
 // --- Scene Manager --- //
-Entity entitiesQueuedForCreation[MAX_ENTITIES];
-size_t entitiesQueuedForCreationSize = 0;
-Entity entitiesQueuedForDeletion[MAX_ENTITIES];
-size_t entitiesQueuedForDeletionSize = 0;
+RBE_DYNAMIC_ARRAY_CREATE(Entity, entitiesQueuedForCreation);
+RBE_DYNAMIC_ARRAY_CREATE(Entity, entitiesQueuedForDeletion);
 
 Scene* activeScene = NULL;
 Scene* queuedSceneToChangeTo = NULL;
 
-static RBEHashMap* entityToTreeNodeMap = NULL;
+// Flat transform hierarchy needs to be rebuilt once the tree changes
+static bool isTransformHierarchyDirty = true;
+
+// Compiled scenes by scene path, loading a scene again instantiates its scene binary instead of running the scene file
+static RBEStringHashMap* sceneBinaryCache = NULL;
+static SceneBinary** sceneBinaries = NULL;
+static size_t sceneBinaryCount = 0;
+static char sceneBinaryExportDirectory[128] = { 0 };
+
+void scene_manager_free_transform_hierarchy();
+const SceneBinary* scene_manager_get_scene_binary(const char* scenePath);
+void scene_manager_instantiate_active_scene(const SceneBinary* sceneBinary);
+void scene_manager_cache_scene_binary(const char* scenePath, SceneBinary* sceneBinary);
+void scene_manager_export_scene_binary(const char* scenePath, const SceneBinary* sceneBinary);
 
 void rbe_scene_manager_initialize() {
-    RBE_ASSERT(entityToTreeNodeMap == NULL);
-    entityToTreeNodeMap = rbe_hash_map_create(sizeof(Entity), sizeof(SceneTreeNode), 16); // TODO: Update capacity
+    RBE_ASSERT(treeNodes == NULL);
+    rbe_string_intern_initialize();
+    childNameIndex = rbe_hash_map_create(sizeof(SceneTreeChildNameKey), sizeof(Entity), 16);
+    rbe_prefab_registry_initialize();
+    sceneBinaryCache = rbe_string_hash_map_create(16);
 }
 
 void rbe_scene_manager_finalize() {
-    RBE_ASSERT(entityToTreeNodeMap != NULL);
-    rbe_hash_map_destroy(entityToTreeNodeMap);
+    rbe_prefab_registry_finalize();
+    for (size_t i = 0; i < sceneBinaryCount; i++) {
+        rbe_scene_binary_destroy(sceneBinaries[i]);
+    }
+    if (sceneBinaries != NULL) {
+        RBE_MEM_FREE(sceneBinaries);
+    }
+    sceneBinaries = NULL;
+    sceneBinaryCount = 0;
+    rbe_string_hash_map_destroy(sceneBinaryCache);
+    sceneBinaryCache = NULL;
+    rbe_scene_binary_finalize();
+    scene_manager_free_transform_hierarchy();
+    if (treeNodes != NULL) {
+        RBE_MEM_FREE(treeNodes);
+    }
+    treeNodes = NULL;
+    treeNodeCapacity = 0;
+    rbe_hash_map_destroy(childNameIndex);
+    childNameIndex = NULL;
+    rbe_string_intern_finalize();
+    RBE_DYNAMIC_ARRAY_FREE(entitiesQueuedForCreation);
+    RBE_DYNAMIC_ARRAY_FREE(entitiesQueuedForDeletion);
 }
 
-void rbe_scene_manager_queue_entity_for_creation(SceneTreeNode* treeNode) {
-    entitiesQueuedForCreation[entitiesQueuedForCreationSize++] = treeNode->entity;
-    RBE_ASSERT_FMT(!rbe_hash_map_has(entityToTreeNodeMap, &treeNode->entity), "Entity '%d' already in entity to tree map!", treeNode->entity);
-    rbe_hash_map_add(entityToTreeNodeMap, &treeNode->entity, treeNode);
+void rbe_scene_manager_queue_entity_for_creation(Entity entity) {
+    RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(entity), "Entity '%u' needs a tree node before being queued for creation!", entity);
+    RBE_DYNAMIC_ARRAY_ADD(entitiesQueuedForCreation, entity);
+    scene_tree_index_child_name(entity);
+    isTransformHierarchyDirty = true;
 }
 
 void rbe_scene_manager_process_queued_creation_entities() {
-    for (size_t i = 0; i < entitiesQueuedForCreationSize; i++) {
+    for (size_t i = 0; i < entitiesQueuedForCreation_count; i++) {
         rbe_ec_system_entity_start(entitiesQueuedForCreation[i]);
     }
-    entitiesQueuedForCreationSize = 0;
+    RBE_DYNAMIC_ARRAY_EMPTY(entitiesQueuedForCreation);
 }
 
 void rbe_scene_manager_queue_entity_for_deletion(Entity entity) {
     // Check if entity is already queued exit out early if so
-    for (size_t i = 0; i < entitiesQueuedForDeletionSize; i++) {
+    for (size_t i = 0; i < entitiesQueuedForDeletion_count; i++) {
         if (entitiesQueuedForDeletion[i] == entity) {
             rbe_logger_warn("Entity '%d' already queued for deletion!", entity);
             return;
         }
     }
     // Insert queued entity
-    entitiesQueuedForDeletion[entitiesQueuedForDeletionSize++] = entity;
+    RBE_DYNAMIC_ARRAY_ADD(entitiesQueuedForDeletion, entity);
     // Clean up
     rbe_ec_system_entity_end(entity);
 }
 
 void rbe_scene_manager_process_queued_deletion_entities() {
-    for (size_t i = 0; i < entitiesQueuedForDeletionSize; i++) {
-        // Remove entity from entity to tree node map
+    for (size_t i = 0; i < entitiesQueuedForDeletion_count; i++) {
+        // Remove entity from the scene tree
         Entity entityToDelete = entitiesQueuedForDeletion[i];
-        RBE_ASSERT_FMT(rbe_hash_map_has(entityToTreeNodeMap, &entityToDelete), "Entity '%d' not in tree node map!?", entityToDelete);
-        // FIXME: Check if hashmap erase deletes treeNode and fix issue
-//        SceneTreeNode* treeNode = rbe_hash_map_get(entityToTreeNodeMap, &entityToDelete);
-//        RBE_MEM_FREE(treeNode);
-        rbe_hash_map_erase(entityToTreeNodeMap, &entityToDelete);
+        RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(entityToDelete), "Entity '%d' not in scene tree!?", entityToDelete);
+        scene_tree_remove_tree_node(entityToDelete);
         // Remove entity from systems
         rbe_ec_system_remove_entity_from_all_systems(entityToDelete);
         // Remove all components
         component_manager_remove_all_components(entityToDelete);
+        // Recycle entity, handles still referring to it are now stale
+        rbe_ec_system_destroy_entity(entityToDelete);
     }
-    entitiesQueuedForDeletionSize = 0;
+    if (entitiesQueuedForDeletion_count > 0) {
+        isTransformHierarchyDirty = true;
+    }
+    RBE_DYNAMIC_ARRAY_EMPTY(entitiesQueuedForDeletion);
 }
 
 void rbe_scene_manager_queue_scene_change(const char* scenePath) {
@@ -127,15 +275,22 @@ void rbe_queue_destroy_tree_node_entity(SceneTreeNode* treeNode) {
     rbe_scene_manager_queue_entity_for_deletion(treeNode->entity);
 }
 
-void rbe_queue_destroy_tree_node_entity_all(SceneTreeNode* treeNode) {
-    rbe_scene_execute_on_all_tree_nodes(treeNode, rbe_queue_destroy_tree_node_entity);
+void rbe_queue_destroy_tree_node_entity_all(Entity entity) {
+    if (!rbe_scene_manager_has_entity_tree_node(entity)) {
+        rbe_logger_warn("Entity '%u' isn't in the scene tree, not queueing it for deletion!", entity);
+        return;
+    }
+    rbe_scene_execute_on_all_tree_nodes(entity, rbe_queue_destroy_tree_node_entity);
 }
 
 void rbe_scene_manager_process_queued_scene_change() {
     if (queuedSceneToChangeTo != NULL) {
         // Destroy old scene
         if (activeScene != NULL) {
-            rbe_scene_execute_on_all_tree_nodes(activeScene->sceneTree->root, rbe_queue_destroy_tree_node_entity);
+            if (activeScene->sceneTree->root != NULL_ENTITY) {
+                rbe_scene_execute_on_all_tree_nodes(activeScene->sceneTree->root, rbe_queue_destroy_tree_node_entity);
+            }
+            RBE_MEM_FREE(activeScene->sceneTree);
             RBE_MEM_FREE(activeScene);
         }
 
@@ -147,97 +302,348 @@ void rbe_scene_manager_process_queued_scene_change() {
         queuedSceneToChangeTo = NULL;
         RBE_ASSERT(activeScene->scenePath != NULL);
         // Queues entities for creation
-        pyh_run_python_file(activeScene->scenePath);
+        const SceneBinary* sceneBinary = scene_manager_get_scene_binary(activeScene->scenePath);
+        if (sceneBinary != NULL) {
+            scene_manager_instantiate_active_scene(sceneBinary);
+        } else {
+            // Scene file compiles its stage nodes and hands them back through 'rbe_scene_manager_load_active_scene_binary'
+            pyh_run_python_file(activeScene->scenePath);
+        }
+    }
+}
+
+void rbe_scene_manager_load_active_scene_binary(SceneBinary* sceneBinary) {
+    RBE_ASSERT(activeScene != NULL);
+    RBE_ASSERT_FMT(!rbe_string_hash_map_has(sceneBinaryCache, activeScene->scenePath), "Scene '%s' already has a scene binary!", activeScene->scenePath);
+    scene_manager_cache_scene_binary(activeScene->scenePath, sceneBinary);
+    if (sceneBinaryExportDirectory[0] != '\0') {
+        scene_manager_export_scene_binary(activeScene->scenePath, sceneBinary);
+    }
+    scene_manager_instantiate_active_scene(sceneBinary);
+}
+
+void rbe_scene_manager_set_scene_binary_export_directory(const char* directory) {
+    strncpy(sceneBinaryExportDirectory, directory, sizeof(sceneBinaryExportDirectory) - 1);
+}
+
+const SceneBinary* scene_manager_get_scene_binary(const char* scenePath) {
+    if (rbe_string_hash_map_has(sceneBinaryCache, scenePath)) {
+        return *(SceneBinary**) rbe_string_hash_map_get(sceneBinaryCache, scenePath);
+    }
+    // Precompiled scenes are loaded from file the first time they're changed to
+    const size_t scenePathLength = strlen(scenePath);
+    const size_t extensionLength = strlen(RBE_SCENE_BINARY_FILE_EXTENSION);
+    if (scenePathLength > extensionLength && strcmp(scenePath + scenePathLength - extensionLength, RBE_SCENE_BINARY_FILE_EXTENSION) == 0) {
+        SceneBinary* sceneBinary = rbe_scene_binary_load_file(scenePath);
+        RBE_ASSERT_FMT(sceneBinary != NULL, "Failed to load scene binary '%s'!", scenePath);
+        scene_manager_cache_scene_binary(scenePath, sceneBinary);
+        return sceneBinary;
+    }
+    return NULL;
+}
+
+void scene_manager_instantiate_active_scene(const SceneBinary* sceneBinary) {
+    const Entity root = rbe_scene_binary_instantiate(sceneBinary, NULL_ENTITY);
+    if (root != NULL_ENTITY) {
+        rbe_scene_manager_set_active_scene_root(root);
+    }
+}
+
+void scene_manager_cache_scene_binary(const char* scenePath, SceneBinary* sceneBinary) {
+    rbe_string_hash_map_add(sceneBinaryCache, scenePath, &sceneBinary, sizeof(SceneBinary*));
+    sceneBinaries = RBE_MEM_REALLOCATE(sceneBinaries, (sceneBinaryCount + 1) * sizeof(SceneBinary*));
+    sceneBinaries[sceneBinaryCount++] = sceneBinary;
+}
+
+// Writes '<export dir>/<scene file name>.rbscene', the exported file can be used as a scene path in place of the scene file
+void scene_manager_export_scene_binary(const char* scenePath, const SceneBinary* sceneBinary) {
+    const char* fileName = scenePath;
+    for (const char* c = scenePath; *c != '\0'; c++) {
+        if (*c == '/' || *c == '\\') {
+            fileName = c + 1;
+        }
+    }
+    const char* extension = strrchr(fileName, '.');
+    const int fileNameLength = extension != NULL ? (int) (extension - fileName) : (int) strlen(fileName);
+    char exportPath[256];
+    snprintf(exportPath, sizeof(exportPath), "%s/%.*s%s", sceneBinaryExportDirectory, fileNameLength, fileName, RBE_SCENE_BINARY_FILE_EXTENSION);
+    if (rbe_scene_binary_save_file(sceneBinary, exportPath)) {
+        rbe_logger_debug("Exported scene '%s' to '%s'", scenePath, exportPath);
     }
 }
 
-void rbe_scene_manager_set_active_scene_root(SceneTreeNode* root) {
+void rbe_scene_manager_set_active_scene_root(Entity root) {
     RBE_ASSERT(activeScene != NULL);
-    RBE_ASSERT_FMT(activeScene->sceneTree->root == NULL, "Trying to overwrite an already existing scene root!");
+    RBE_ASSERT_FMT(activeScene->sceneTree->root == NULL_ENTITY, "Trying to overwrite an already existing scene root!");
     activeScene->sceneTree->root = root;
 }
 
-// TODO: Clean up temp stuff for CombineModelResult
-typedef struct CombineModelResult {
-    int entityCount;
-    Entity entities[10];
-} CombineModelResult;
+// --- Transform Hierarchy --- //
+// Scene tree mirrored into a flat array in depth first order.  Parents always come before their children and a node's
+// descendants directly follow it, so global transforms are resolved in one linear pass and a subtree is a single range.
+#define TRANSFORM_HIERARCHY_INVALID_INDEX UINT32_MAX
 
-// First index is the child
-CombineModelResult rbe_scene_manager_get_scene_graph_entity_hierarchy(Entity entity) {
-    CombineModelResult combineModelResult = { .entityCount = 0 };
-    combineModelResult.entities[combineModelResult.entityCount++] = entity;
+typedef struct TransformHierarchyNode {
+    Entity entity;
+    uint32_t parentIndex;
+    uint32_t subtreeSize; // Includes the node itself
+} TransformHierarchyNode;
 
-    SceneTreeNode* sceneTreeNode = rbe_scene_manager_get_entity_tree_node(entity);
-    SceneTreeNode* parentTreeNode = sceneTreeNode->parent;
-    while (parentTreeNode != NULL) {
-        combineModelResult.entities[combineModelResult.entityCount++] = parentTreeNode->entity;
-        parentTreeNode = parentTreeNode->parent;
+static TransformHierarchyNode* transformHierarchy = NULL;
+// Closest ancestor (or self) global transform per hierarchy node, scratch for the update pass
+static TransformModel2D** transformHierarchyGlobals = NULL;
+static size_t transformHierarchyCount = 0;
+static size_t transformHierarchyCapacity = 0;
+// Entity index to hierarchy index
+static uint32_t* entityToTransformHierarchyIndex = NULL;
+static size_t entityToTransformHierarchyIndexCapacity = 0;
+
+void scene_manager_add_transform_hierarchy_node(Entity entity, uint32_t parentIndex) {
+    if (transformHierarchyCount >= transformHierarchyCapacity) {
+        transformHierarchyCapacity = transformHierarchyCapacity == 0 ? 64 : transformHierarchyCapacity * 2;
+        transformHierarchy = RBE_MEM_REALLOCATE(transformHierarchy, transformHierarchyCapacity * sizeof(TransformHierarchyNode));
+        transformHierarchyGlobals = RBE_MEM_REALLOCATE(transformHierarchyGlobals, transformHierarchyCapacity * sizeof(TransformModel2D*));
+    }
+    const uint32_t entityIndex = entity_get_index(entity);
+    if (entityIndex >= entityToTransformHierarchyIndexCapacity) {
+        const size_t oldCapacity = entityToTransformHierarchyIndexCapacity;
+        entityToTransformHierarchyIndexCapacity = entityIndex + 1 > oldCapacity * 2 ? entityIndex + 1 : oldCapacity * 2;
+        entityToTransformHierarchyIndex = RBE_MEM_REALLOCATE(entityToTransformHierarchyIndex, entityToTransformHierarchyIndexCapacity * sizeof(uint32_t));
+        memset(entityToTransformHierarchyIndex + oldCapacity, 0xFF, (entityToTransformHierarchyIndexCapacity - oldCapacity) * sizeof(uint32_t));
+    }
+    const uint32_t nodeIndex = (uint32_t) transformHierarchyCount++;
+    entityToTransformHierarchyIndex[entityIndex] = nodeIndex;
+    transformHierarchy[nodeIndex].entity = entity;
+    transformHierarchy[nodeIndex].parentIndex = parentIndex;
+    for (Entity child = scene_tree_get_node(entity)->firstChild; child != NULL_ENTITY; child = scene_tree_get_node(child)->nextSibling) {
+        scene_manager_add_transform_hierarchy_node(child, nodeIndex);
+    }
+    transformHierarchy[nodeIndex].subtreeSize = (uint32_t) transformHierarchyCount - nodeIndex;
+}
+
+void scene_manager_rebuild_transform_hierarchy() {
+    for (size_t i = 0; i < transformHierarchyCount; i++) {
+        entityToTransformHierarchyIndex[entity_get_index(transformHierarchy[i].entity)] = TRANSFORM_HIERARCHY_INVALID_INDEX;
+    }
+    transformHierarchyCount = 0;
+    for (size_t i = 0; i < treeNodeCapacity; i++) {
+        const SceneTreeNode* treeNode = &treeNodes[i];
+        if (treeNode->entity != NULL_ENTITY && treeNode->parent == NULL_ENTITY) {
+            scene_manager_add_transform_hierarchy_node(treeNode->entity, TRANSFORM_HIERARCHY_INVALID_INDEX);
+        }
     }
-    return combineModelResult;
+    isTransformHierarchyDirty = false;
 }
 
-void rbe_scene_manager_update_global_tranform_model(Entity entity, TransformModel2D* globalTransform) {
-    glm_mat4_identity(globalTransform->model);
-    CombineModelResult combineModelResult = rbe_scene_manager_get_scene_graph_entity_hierarchy(entity);
-    Vector2 scaleTotal = { 1.0f, 1.0f };
-    for (int i = combineModelResult.entityCount - 1; i >= 0; i--) {
-        Entity currentEntity = combineModelResult.entities[i];
-        Transform2DComponent* transform2DComponent = component_manager_get_component_unsafe(currentEntity, ComponentDataIndex_TRANSFORM_2D);
+// Returns TRANSFORM_HIERARCHY_INVALID_INDEX for entities not mirrored, the hierarchy is only rebuilt by the per frame
+// pass so building a scene node by node doesn't rebuild it over and over
+uint32_t scene_manager_get_transform_hierarchy_index(Entity entity) {
+    if (isTransformHierarchyDirty) {
+        return TRANSFORM_HIERARCHY_INVALID_INDEX;
+    }
+    const uint32_t entityIndex = entity_get_index(entity);
+    if (entityIndex >= entityToTransformHierarchyIndexCapacity) {
+        return TRANSFORM_HIERARCHY_INVALID_INDEX;
+    }
+    const uint32_t nodeIndex = entityToTransformHierarchyIndex[entityIndex];
+    if (nodeIndex != TRANSFORM_HIERARCHY_INVALID_INDEX && transformHierarchy[nodeIndex].entity != entity) {
+        return TRANSFORM_HIERARCHY_INVALID_INDEX;
+    }
+    return nodeIndex;
+}
+
+void scene_manager_free_transform_hierarchy() {
+    if (transformHierarchy != NULL) {
+        RBE_MEM_FREE(transformHierarchy);
+        RBE_MEM_FREE(transformHierarchyGlobals);
+    }
+    if (entityToTransformHierarchyIndex != NULL) {
+        RBE_MEM_FREE(entityToTransformHierarchyIndex);
+    }
+    transformHierarchy = NULL;
+    transformHierarchyGlobals = NULL;
+    transformHierarchyCount = 0;
+    transformHierarchyCapacity = 0;
+    entityToTransformHierarchyIndex = NULL;
+    entityToTransformHierarchyIndexCapacity = 0;
+    isTransformHierarchyDirty = true;
+}
+
+// Global transform is the parent's global transform combined with the local one, parent is NULL for roots
+void scene_manager_update_global_transform(Transform2DComponent* transform2DComponent, const TransformModel2D* parentGlobalTransform) {
+    TransformModel2D* globalTransform = &transform2DComponent->globalTransform;
+    const Vector2 localScaleSign = rbe_math_signvec2(&transform2DComponent->localTransform.scale);
+    if (parentGlobalTransform != NULL) {
+        Affine2D localModel;
+        transform2d_component_get_local_model(&localModel, transform2DComponent);
+        rbe_math_affine2d_mul(&parentGlobalTransform->model, &localModel, &globalTransform->model);
+        globalTransform->scaleSign.x = parentGlobalTransform->scaleSign.x * localScaleSign.x;
+        globalTransform->scaleSign.y = parentGlobalTransform->scaleSign.y * localScaleSign.y;
+    } else {
+        transform2d_component_get_local_model(&globalTransform->model, transform2DComponent);
+        globalTransform->scaleSign = localScaleSign;
+    }
+    // Axes of the affine are the rotated and scaled unit axes, the scale sign puts reflections back on the axis they came from
+    const float* linear = globalTransform->model.linear;
+    globalTransform->position.x = globalTransform->model.translation[0];
+    globalTransform->position.y = globalTransform->model.translation[1];
+    globalTransform->scale.x = sqrtf(linear[0] * linear[0] + linear[1] * linear[1]) * globalTransform->scaleSign.x;
+    globalTransform->scale.y = sqrtf(linear[2] * linear[2] + linear[3] * linear[3]) * globalTransform->scaleSign.y;
+    const float xAxisSign = globalTransform->scaleSign.x < 0.0f ? -1.0f : 1.0f;
+    globalTransform->rotation = glm_deg(atan2f(linear[1] * xAxisSign, linear[0] * xAxisSign));
+    // Flag is no longer dirty since the global transform is up to date
+    transform2DComponent->isGlobalTransformDirty = false;
+    transform2DComponent->isGlobalBoundsDirty = true;
+}
+
+void rbe_scene_manager_update_global_transforms() {
+    if (isTransformHierarchyDirty) {
+        scene_manager_rebuild_transform_hierarchy();
+    }
+    for (size_t i = 0; i < transformHierarchyCount; i++) {
+        const TransformHierarchyNode* node = &transformHierarchy[i];
+        // Parents were resolved earlier in the pass, nodes without a transform pass their parent's through
+        TransformModel2D* parentGlobalTransform = node->parentIndex != TRANSFORM_HIERARCHY_INVALID_INDEX ? transformHierarchyGlobals[node->parentIndex] : NULL;
+        Transform2DComponent* transform2DComponent = component_manager_get_component_unsafe(node->entity, ComponentDataIndex_TRANSFORM_2D);
         if (transform2DComponent == NULL) {
+            transformHierarchyGlobals[i] = parentGlobalTransform;
             continue;
         }
-        scaleTotal.x *= transform2DComponent->localTransform.scale.x;
-        scaleTotal.y *= transform2DComponent->localTransform.scale.y;
-        mat4 newModel;
-        transform2d_component_get_local_model_matrix(newModel, transform2DComponent);
-        glm_mat4_mul(globalTransform->model, newModel, globalTransform->model);
+        if (transform2DComponent->isGlobalTransformDirty) {
+            scene_manager_update_global_transform(transform2DComponent, parentGlobalTransform);
+        }
+        transformHierarchyGlobals[i] = &transform2DComponent->globalTransform;
+    }
+}
+
+void scene_manager_flag_global_transform_dirty(Entity entity) {
+    Transform2DComponent* transform2DComponent = component_manager_get_component_unsafe(entity, ComponentDataIndex_TRANSFORM_2D);
+    if (transform2DComponent != NULL) {
+        transform2DComponent->isGlobalTransformDirty = true;
+        component_manager_mark_component_changed(entity, ComponentDataIndex_TRANSFORM_2D);
     }
-    globalTransform->scaleSign = rbe_math_signvec2(&scaleTotal);
 }
 
-// TODO: Make function to update flags for all children
+void scene_manager_flag_tree_node_global_transform_dirty(SceneTreeNode* treeNode) {
+    scene_manager_flag_global_transform_dirty(treeNode->entity);
+}
+
+// Global transforms are cached until invalidated, descendants are flagged and marked changed too as they're relative to the entity
+void rbe_scene_manager_invalidate_scene_node_global_transform(Entity entity) {
+    const uint32_t nodeIndex = scene_manager_get_transform_hierarchy_index(entity);
+    if (nodeIndex == TRANSFORM_HIERARCHY_INVALID_INDEX) {
+        if (rbe_scene_manager_has_entity_tree_node(entity)) {
+            rbe_scene_execute_on_all_tree_nodes(entity, scene_manager_flag_tree_node_global_transform_dirty);
+        } else {
+            scene_manager_flag_global_transform_dirty(entity);
+        }
+        return;
+    }
+    const uint32_t subtreeEnd = nodeIndex + transformHierarchy[nodeIndex].subtreeSize;
+    for (uint32_t i = nodeIndex; i < subtreeEnd; i++) {
+        scene_manager_flag_global_transform_dirty(transformHierarchy[i].entity);
+    }
+}
+
+// Closest ancestor with a transform, NULL_ENTITY if there isn't one
+Entity scene_manager_get_transform_parent(Entity entity) {
+    const uint32_t nodeIndex = scene_manager_get_transform_hierarchy_index(entity);
+    if (nodeIndex != TRANSFORM_HIERARCHY_INVALID_INDEX) {
+        for (uint32_t parentIndex = transformHierarchy[nodeIndex].parentIndex; parentIndex != TRANSFORM_HIERARCHY_INVALID_INDEX; parentIndex = transformHierarchy[parentIndex].parentIndex) {
+            if (component_manager_has_component(transformHierarchy[parentIndex].entity, ComponentDataIndex_TRANSFORM_2D)) {
+                return transformHierarchy[parentIndex].entity;
+            }
+        }
+    } else if (rbe_scene_manager_has_entity_tree_node(entity)) {
+        // Not mirrored yet, happens while a scene is being built
+        for (Entity parent = scene_tree_get_node(entity)->parent; parent != NULL_ENTITY; parent = scene_tree_get_node(parent)->parent) {
+            if (component_manager_has_component(parent, ComponentDataIndex_TRANSFORM_2D)) {
+                return parent;
+            }
+        }
+    }
+    return NULL_ENTITY;
+}
+
+// Resolves a single global transform outside of the per frame pass, only dirty ancestors are recomputed
 TransformModel2D* rbe_scene_manager_get_scene_node_global_transform(Entity entity, Transform2DComponent* transform2DComponent) {
     RBE_ASSERT_FMT(transform2DComponent != NULL, "Transform Model is NULL for entity '%d'", entity);
     if (transform2DComponent->isGlobalTransformDirty) {
-        // Walk up scene to root node and calculate global transform
-        rbe_scene_manager_update_global_tranform_model(entity, &transform2DComponent->globalTransform);
-        // Decompose trs matrix
-        vec4 translation;
-        mat4 rotation;
-        vec3 scale;
-        glm_decompose(transform2DComponent->globalTransform.model, translation, rotation, scale);
-        // Update global transform
-        transform2DComponent->globalTransform.position.x = translation[0];
-        transform2DComponent->globalTransform.position.y = translation[1];
-        // Scale sign is used to fix sign of scale not being properly decomposed in trs matrix
-        transform2DComponent->globalTransform.scale.x = fabsf(scale[0]) * transform2DComponent->globalTransform.scaleSign.x;
-        transform2DComponent->globalTransform.scale.y = fabsf(scale[1]) * transform2DComponent->globalTransform.scaleSign.y;
-        transform2DComponent->globalTransform.rotation = transform2d_component_get_rotation_deg_from_model(rotation);
-        // Flag is no longer dirty since the global transform is up to date
-        transform2DComponent->isGlobalTransformDirty = false;
+        const Entity parentEntity = scene_manager_get_transform_parent(entity);
+        const TransformModel2D* parentGlobalTransform = NULL;
+        if (parentEntity != NULL_ENTITY) {
+            parentGlobalTransform = rbe_scene_manager_get_scene_node_global_transform(parentEntity, component_manager_get_component_unsafe(parentEntity, ComponentDataIndex_TRANSFORM_2D));
+        }
+        scene_manager_update_global_transform(transform2DComponent, parentGlobalTransform);
     }
     return &transform2DComponent->globalTransform;
 }
 
+const Rect2* rbe_scene_manager_get_scene_node_global_bounds(Entity entity, Transform2DComponent* transform2DComponent, const Rect2* localRect) {
+    TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, transform2DComponent);
+    const Rect2* cachedLocalRect = &transform2DComponent->boundsLocalRect;
+    if (transform2DComponent->isGlobalBoundsDirty
+            || cachedLocalRect->x != localRect->x || cachedLocalRect->y != localRect->y
+            || cachedLocalRect->w != localRect->w || cachedLocalRect->h != localRect->h) {
+        transform2DComponent->globalBounds = rbe_math_get_transformed_rect2_bounds(&globalTransform->model, localRect);
+        transform2DComponent->boundsLocalRect = *localRect;
+        transform2DComponent->isGlobalBoundsDirty = false;
+    }
+    return &transform2DComponent->globalBounds;
+}
+
+// Z index with the z indices of parents added for as long as nodes are relative to their parent
+int rbe_scene_manager_get_scene_node_global_z_index(Entity entity, Transform2DComponent* transform2DComponent) {
+    RBE_ASSERT_FMT(transform2DComponent != NULL, "Transform Model is NULL for entity '%d'", entity);
+    int globalZIndex = transform2DComponent->zIndex;
+    const Transform2DComponent* currentTransform = transform2DComponent;
+    Entity parent = rbe_scene_manager_get_entity_tree_node(entity)->parent;
+    while (currentTransform->isZIndexRelativeToParent && parent != NULL_ENTITY) {
+        const Transform2DComponent* parentTransform = component_manager_get_component_unsafe(parent, ComponentDataIndex_TRANSFORM_2D);
+        if (parentTransform != NULL) {
+            globalZIndex += parentTransform->zIndex;
+            currentTransform = parentTransform;
+        }
+        parent = scene_tree_get_node(parent)->parent;
+    }
+    return globalZIndex;
+}
+
+bool rbe_scene_manager_has_entity_tree_node(Entity entity) {
+    const uint32_t entityIndex = entity_get_index(entity);
+    return entity != NULL_ENTITY && entityIndex < treeNodeCapacity && treeNodes[entityIndex].entity == entity;
+}
+
 SceneTreeNode* rbe_scene_manager_get_entity_tree_node(Entity entity) {
-    RBE_ASSERT_FMT(rbe_hash_map_has(entityToTreeNodeMap, &entity), "Doesn't have entity '%d' in scene tree!", entity);
-    SceneTreeNode* treeNode = (SceneTreeNode*) rbe_hash_map_get(entityToTreeNodeMap, &entity);
-    RBE_ASSERT(treeNode != NULL);
-    return treeNode;
+    RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(entity), "Doesn't have entity '%d' in scene tree!", entity);
+    return scene_tree_get_node(entity);
 }
 
 Entity rbe_scene_manager_get_entity_child_by_name(Entity parent, const char* childName) {
-    SceneTreeNode* parentNode = rbe_scene_manager_get_entity_tree_node(parent);
-    RBE_ASSERT(parentNode != NULL);
-    for (size_t childIndex = 0; childIndex < parentNode->childCount; childIndex++) {
-        const Entity childEntity = parentNode->children[childIndex]->entity;
-        if (component_manager_has_component(childEntity, ComponentDataIndex_NODE)) {
-            NodeComponent* childNodeComponent = component_manager_get_component(childEntity, ComponentDataIndex_NODE);
-            if (strcmp(childNodeComponent->name, childName) == 0) {
-                return childEntity;
-            }
+    RBE_ASSERT_FMT(rbe_scene_manager_has_entity_tree_node(parent), "Doesn't have entity '%d' in scene tree!", parent);
+    // Names that were never interned can't belong to any node
+    const StringId name = rbe_string_intern_find(childName);
+    return name != RBE_STRING_ID_NONE ? scene_tree_get_child_by_name(parent, name) : NULL_ENTITY;
+}
+
+Entity rbe_scene_manager_get_entity_child_by_path(Entity parent, const char* childPath) {
+    char name[SCENE_TREE_NODE_PATH_NAME_MAX];
+    Entity current = parent;
+    const char* nameStart = childPath;
+    while (current != NULL_ENTITY) {
+        const char* nameEnd = strchr(nameStart, '/');
+        const size_t nameLength = nameEnd != NULL ? (size_t) (nameEnd - nameStart) : strlen(nameStart);
+        if (nameLength >= SCENE_TREE_NODE_PATH_NAME_MAX) {
+            rbe_logger_warn("Name in path '%s' is longer than '%d' characters!", childPath, SCENE_TREE_NODE_PATH_NAME_MAX - 1);
+            return NULL_ENTITY;
+        }
+        memcpy(name, nameStart, nameLength);
+        name[nameLength] = '\0';
+        current = rbe_scene_manager_get_entity_child_by_name(current, name);
+        if (nameEnd == NULL) {
+            break;
         }
+        nameStart = nameEnd + 1;
     }
-    return NULL_ENTITY;
+    return current;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdbool.h>
+
 #include "../ecs/entity/entity.h"
 #include "../ecs/component/transform2d_component.h"
 
@@ -8,29 +10,52 @@
 #include <cglm/cglm.h>
 
 // --- Scene Tree --- //
-// Maintains parent child relationship between nodes
+#define SCENE_TREE_NODE_PATH_NAME_MAX 128
+
+// Maintains parent child relationship between nodes.  Nodes live in a pool indexed by entity index and link to each
+// other by entity, NULL_ENTITY when there is no link.  Children are kept in the order they were added.
 typedef struct SceneTreeNode {
     Entity entity;
-    struct SceneTreeNode* parent;
-    struct SceneTreeNode* children[MAX_ENTITIES / 2]; // TODO: Clean up temp
-    size_t childCount;
+    Entity parent;
+    Entity firstChild;
+    Entity lastChild;
+    Entity nextSibling;
+    Entity prevSibling;
+    uint32_t childCount;
 } SceneTreeNode;
 
-SceneTreeNode* rbe_scene_tree_create_tree_node(Entity entity, SceneTreeNode* parent);
+// Adds a node for 'entity' as the last child of 'parent', pass NULL_ENTITY for a root node
+void rbe_scene_tree_create_tree_node(Entity entity, Entity parent);
 
 // --- Scene Manager --- //
+typedef struct SceneBinary SceneBinary;
+
 void rbe_scene_manager_initialize();
 void rbe_scene_manager_finalize();
-void rbe_scene_manager_queue_entity_for_creation(SceneTreeNode* treeNode);
+void rbe_scene_manager_queue_entity_for_creation(Entity entity);
 void rbe_scene_manager_process_queued_creation_entities();
 void rbe_scene_manager_queue_entity_for_deletion(Entity entity);
-void rbe_queue_destroy_tree_node_entity_all(SceneTreeNode* treeNode);
+void rbe_queue_destroy_tree_node_entity_all(Entity entity);
 void rbe_scene_manager_process_queued_deletion_entities();
 void rbe_scene_manager_queue_scene_change(const char* scenePath);
 void rbe_scene_manager_process_queued_scene_change();
+// Takes ownership of the active scene's compiled stage nodes, caches them by scene path and instantiates them as the scene root
+void rbe_scene_manager_load_active_scene_binary(SceneBinary* sceneBinary);
+// Compiled scenes are also written to this directory so they can be shipped precompiled
+void rbe_scene_manager_set_scene_binary_export_directory(const char* directory);
 
 // Scene Tree related stuff, may separate into separate functionality later.
-void rbe_scene_manager_set_active_scene_root(SceneTreeNode* root);
+void rbe_scene_manager_set_active_scene_root(Entity root);
+void rbe_scene_manager_invalidate_scene_node_global_transform(Entity entity);
+// Resolves all dirty global transforms parent first in a single pass, called once per frame before rendering
+void rbe_scene_manager_update_global_transforms();
 TransformModel2D* rbe_scene_manager_get_scene_node_global_transform(Entity entity, Transform2DComponent* transform2DComponent);
+// World space axis aligned bounds of a rect local to the entity, used for culling
+const Rect2* rbe_scene_manager_get_scene_node_global_bounds(Entity entity, Transform2DComponent* transform2DComponent, const Rect2* localRect);
+int rbe_scene_manager_get_scene_node_global_z_index(Entity entity, Transform2DComponent* transform2DComponent);
 Entity rbe_scene_manager_get_entity_child_by_name(Entity parent, const char* childName);
+// Child names separated by '/', e.g. "PlayerOne/Collider"
+Entity rbe_scene_manager_get_entity_child_by_path(Entity parent, const char* childPath);
+bool rbe_scene_manager_has_entity_tree_node(Entity entity);
+// Pointer into the node pool, only valid until the next node is created
 SceneTreeNode* rbe_scene_manager_get_entity_tree_node(Entity entity);
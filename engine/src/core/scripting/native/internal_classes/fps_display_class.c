@@ -55,7 +55,9 @@ void fps_display_update(RBENativeScriptClass* nativeScriptClass, float deltaTime
     static char fpsAmountBuffer[6];
     // TODO: (FIXME) this is windows specific, needs to be replaced for other OS
     gcvt(rbe_engine_context_get()->averageFPS, 4, fpsAmountBuffer);
-    TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component(nativeScriptClass->entity, ComponentDataIndex_TEXT_LABEL);
-    strcpy(textLabelComponent->text, "FPS: ");
-    strcat(textLabelComponent->text, fpsAmountBuffer);
+    char fpsText[TEXT_LABEL_BUFFER_SIZE];
+    strcpy(fpsText, "FPS: ");
+    strcat(fpsText, fpsAmountBuffer);
+    TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component_for_write(nativeScriptClass->entity, ComponentDataIndex_TEXT_LABEL);
+    text_label_component_set_text(textLabelComponent, fpsText);
 }
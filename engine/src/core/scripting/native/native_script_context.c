@@ -3,7 +3,7 @@
 #include "../script_context.h"
 #include "../../data_structures/rbe_hash_map.h"
 #include "../../data_structures/rbe_hash_map_string.h"
-#include "../../data_structures/rbe_static_array.h"
+#include "../../data_structures/rbe_dynamic_array.h"
 #include "../../utils/rbe_assert.h"
 #include "../../memory/rbe_mem.h"
 
@@ -22,8 +22,8 @@ void native_on_end(Entity entity);
 RBEStringHashMap* classCache = NULL;
 RBEHashMap* entityToClassName = NULL;
 
-RBE_STATIC_ARRAY_CREATE(RBENativeScriptClass*, MAX_ENTITIES, entities_to_update);
-RBE_STATIC_ARRAY_CREATE(RBENativeScriptClass*, MAX_ENTITIES, entities_to_physics_update);
+RBE_DYNAMIC_ARRAY_CREATE(RBENativeScriptClass*, entities_to_update);
+RBE_DYNAMIC_ARRAY_CREATE(RBENativeScriptClass*, entities_to_physics_update);
 
 RBEScriptContext* rbe_native_create_script_context() {
     RBEScriptContext* scriptContext = rbe_script_context_create();
@@ -60,10 +60,10 @@ void native_on_create_instance(Entity entity, const char* classPath, const char*
     RBENativeScriptClass* newScriptClass = scriptClassRef->create_new_instance_func(entity);
     rbe_hash_map_add(entityToClassName, &entity, newScriptClass);
     if (newScriptClass->update_func != NULL) {
-        RBE_STATIC_ARRAY_ADD(entities_to_update, newScriptClass);
+        RBE_DYNAMIC_ARRAY_ADD(entities_to_update, newScriptClass);
     }
     if (newScriptClass->physics_update_func != NULL) {
-        RBE_STATIC_ARRAY_ADD(entities_to_physics_update, newScriptClass);
+        RBE_DYNAMIC_ARRAY_ADD(entities_to_physics_update, newScriptClass);
     }
 }
 
@@ -71,10 +71,10 @@ void native_on_delete_instance(Entity entity) {
     RBENativeScriptClass* scriptClassRef = (RBENativeScriptClass*) rbe_hash_map_get(entityToClassName, &entity);
 
     if (scriptClassRef->update_func != NULL) {
-        RBE_STATIC_ARRAY_REMOVE(entities_to_update, scriptClassRef, NULL);
+        RBE_DYNAMIC_ARRAY_REMOVE(entities_to_update, scriptClassRef);
     }
     if (scriptClassRef->physics_update_func != NULL) {
-        RBE_STATIC_ARRAY_REMOVE(entities_to_physics_update, scriptClassRef, NULL);
+        RBE_DYNAMIC_ARRAY_REMOVE(entities_to_physics_update, scriptClassRef);
     }
 
     RBE_MEM_FREE(scriptClassRef);
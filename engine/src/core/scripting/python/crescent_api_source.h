@@ -1149,6 +1149,22 @@
 "        crescent_api_internal.scene_tree_change_scene(path=path)\n"\
 "\n"\
 "\n"\
+"# PREFAB REGISTRY\n"\
+"class PrefabRegistry:\n"\
+"    @staticmethod\n"\
+"    def register(name: str, node) -> None:\n"\
+"        crescent_api_internal.prefab_registry_register(\n"\
+"            name=name, entity_id=node.entity_id\n"\
+"        )\n"\
+"\n"\
+"    @staticmethod\n"\
+"    def instantiate(name: str, parent):\n"\
+"        node = crescent_api_internal.prefab_registry_instantiate(\n"\
+"            name=name, parent_entity_id=parent.entity_id\n"\
+"        )\n"\
+"        return Node.parse_scene_node_from_engine(scene_node=node)\n"\
+"\n"\
+"\n"\
 "# AUDIO MANAGER\n"\
 "class AudioManager:\n"\
 "    @staticmethod\n"\
@@ -5,7 +5,7 @@
 #include "py_cache.h"
 #include "../script_context.h"
 #include "../../data_structures/rbe_hash_map.h"
-#include "../../data_structures/rbe_static_array.h"
+#include "../../data_structures/rbe_dynamic_array.h"
 #include "../../utils/rbe_assert.h"
 #include "../../memory/rbe_mem.h"
 #include "../../networking/rbe_network.h"
@@ -30,8 +30,8 @@ void py_on_physics_update_all_instances(float deltaTime);
 void py_on_end(Entity entity);
 void py_on_network_callback(const char* message);
 
-RBE_STATIC_ARRAY_CREATE(PyObject*, MAX_ENTITIES, entities_to_update);
-RBE_STATIC_ARRAY_CREATE(PyObject*, MAX_ENTITIES, entities_to_physics_update);
+RBE_DYNAMIC_ARRAY_CREATE(PyObject*, entities_to_update);
+RBE_DYNAMIC_ARRAY_CREATE(PyObject*, entities_to_physics_update);
 
 RBEHashMap* pythonInstanceHashMap = NULL;
 RBEScriptContext* python_script_context = NULL;
@@ -60,10 +60,10 @@ RBEScriptContext* rbe_py_get_script_context() {
 void py_on_create_instance(Entity entity, const char* classPath, const char* className) {
     PyObject* pScriptInstance = rbe_py_cache_create_instance(classPath, className, entity);
     if (PyObject_HasAttrString(pScriptInstance, "_update")) {
-        RBE_STATIC_ARRAY_ADD(entities_to_update, pScriptInstance);
+        RBE_DYNAMIC_ARRAY_ADD(entities_to_update, pScriptInstance);
     }
     if (PyObject_HasAttrString(pScriptInstance, "_physics_update")) {
-        RBE_STATIC_ARRAY_ADD(entities_to_physics_update, pScriptInstance);
+        RBE_DYNAMIC_ARRAY_ADD(entities_to_physics_update, pScriptInstance);
     }
     rbe_hash_map_add(pythonInstanceHashMap, &entity, &pScriptInstance);
 }
@@ -73,10 +73,10 @@ void py_on_delete_instance(Entity entity) {
     PyObject* pScriptInstance = (PyObject*) *(PyObject**) rbe_hash_map_get(pythonInstanceHashMap, &entity);
     // Remove from update arrays
     if (PyObject_HasAttrString(pScriptInstance, "_update")) {
-        RBE_STATIC_ARRAY_REMOVE(entities_to_update, pScriptInstance, NULL);
+        RBE_DYNAMIC_ARRAY_REMOVE(entities_to_update, pScriptInstance);
     }
     if (PyObject_HasAttrString(pScriptInstance, "_physics_update")) {
-        RBE_STATIC_ARRAY_REMOVE(entities_to_physics_update, pScriptInstance, NULL);
+        RBE_DYNAMIC_ARRAY_REMOVE(entities_to_physics_update, pScriptInstance);
     }
 
     Py_DecRef(pScriptInstance);
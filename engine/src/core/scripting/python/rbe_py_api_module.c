@@ -12,10 +12,13 @@
 #include "../../scripting/script_context.h"
 #include "../../scripting/python/py_helper.h"
 #include "../../scene/scene_manager.h"
+#include "../../scene/prefab_registry.h"
+#include "../../scene/scene_binary.h"
 #include "../../physics/collision/collision.h"
 #include "../../camera/camera.h"
 #include "../../camera/camera_manager.h"
 #include "../../ecs/ecs_manager.h"
+#include "../../ecs/ecs_command_buffer.h"
 #include "../../ecs/system/ec_system.h"
 #include "../../ecs/component/animated_sprite_component.h"
 #include "../../ecs/component/collider2d_component.h"
@@ -28,6 +31,20 @@
 #include "../../utils/rbe_string_util.h"
 #include "../../utils/rbe_assert.h"
 
+// Scripts can hold on to entities after their node is deleted, raises an error instead of touching a recycled entity
+#define RBE_PY_API_RETURN_IF_STALE_ENTITY(ENTITY)                                               \
+if (!rbe_ec_system_is_entity_alive(ENTITY)) {                                                  \
+PyErr_Format(PyExc_RuntimeError, "Entity '%u' is stale, its node was deleted!", ENTITY);       \
+return NULL;                                                                                   \
+}
+
+// Nodes created with Node.new() aren't in the scene tree until they're added as a child
+#define RBE_PY_API_RETURN_IF_NOT_IN_SCENE_TREE(ENTITY)                                         \
+if (!rbe_scene_manager_has_entity_tree_node(ENTITY)) {                                         \
+PyErr_Format(PyExc_RuntimeError, "Entity '%u' isn't in the scene tree!", ENTITY);              \
+return NULL;                                                                                   \
+}
+
 #ifdef _MSC_VER
 #pragma warning(disable : 4996) // for strcpy
 #endif
@@ -35,8 +52,8 @@
 // TODO: Clean up strdups
 
 //--- Node Utils ---//
-void setup_scene_stage_nodes(SceneTreeNode* parent, PyObject* stageNodeList);
-void setup_scene_component_node(Entity entity, PyObject* component);
+void compile_scene_stage_nodes(SceneBinaryBuilder* builder, uint32_t parentIndex, PyObject* stageNodeList);
+void compile_scene_component_node(SceneBinaryBuilder* builder, PyObject* component);
 
 //--- Py Utils ---//
 PyObject* rbe_py_utils_get_entity_instance(Entity entity);
@@ -202,7 +219,10 @@ PyObject* rbe_py_api_create_stage_nodes(PyObject* self, PyObject* args, PyObject
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "O", rbePyApiCreateStageNodesKWList, &stageNodeList)) {
         RBE_ASSERT_FMT(PyList_Check(stageNodeList), "Passed in stage nodes are not a python list, check python api implementation...");
         rbe_logger_debug("setup stage nodes:");
-        setup_scene_stage_nodes(NULL_ENTITY, stageNodeList); // Assumes this is the root entity node for the scene
+        // Compiled once per scene, the scene manager instantiates the scene binary for this and later loads of the scene
+        SceneBinaryBuilder* builder = rbe_scene_binary_builder_create();
+        compile_scene_stage_nodes(builder, RBE_SCENE_BINARY_NO_PARENT, stageNodeList); // Assumes this is the root entity node for the scene
+        rbe_scene_manager_load_active_scene_binary(rbe_scene_binary_builder_finish(builder));
         Py_RETURN_NONE;
     }
     return NULL;
@@ -213,25 +233,15 @@ PyObject* PyInit_rbe_py_API(void) {
 }
 
 //--- Node Utils ---//
-void setup_scene_stage_nodes(SceneTreeNode* parent, PyObject* stageNodeList) {
+void compile_scene_stage_nodes(SceneBinaryBuilder* builder, uint32_t parentIndex, PyObject* stageNodeList) {
     for (Py_ssize_t i = 0; i < PyList_Size(stageNodeList); i++) {
-        SceneTreeNode* node = rbe_scene_tree_create_tree_node(rbe_ec_system_create_entity(), parent);
-        // Set tree root if parent is absent
-        if (parent == NULL) {
-            rbe_scene_manager_set_active_scene_root(node);
-        } else {
-            parent->children[parent->childCount++] = node;
-        }
-
         PyObject* pStageNode = PyList_GetItem(stageNodeList, i);
         // Node component is used for all scene nodes
         const char* nodeName = phy_get_string_from_var(pStageNode, "name");
         const char* nodeType = phy_get_string_from_var(pStageNode, "type");
-        NodeComponent* nodeComponent = node_component_create();
-        strcpy(nodeComponent->name, nodeName);
-        nodeComponent->type = node_get_base_type(nodeType);
-        RBE_ASSERT_FMT(nodeComponent->type != NodeBaseType_INVALID, "Node '%s' has an invalid node type '%s'", nodeName, nodeType);
-        component_manager_set_component(node->entity, ComponentDataIndex_NODE, nodeComponent);
+        const NodeBaseType nodeBaseType = node_get_base_type(nodeType);
+        RBE_ASSERT_FMT(nodeBaseType != NodeBaseType_INVALID, "Node '%s' has an invalid node type '%s'", nodeName, nodeType);
+        const uint32_t nodeIndex = rbe_scene_binary_builder_add_node(builder, parentIndex, nodeName, nodeBaseType);
 
         // Process tags if tags var is a list
         PyObject* tagsListVar = PyObject_GetAttrString(pStageNode, "tags");
@@ -244,33 +254,30 @@ void setup_scene_stage_nodes(SceneTreeNode* parent, PyObject* stageNodeList) {
             const char* externalNodeSourcePath = phy_get_string_from_var(externalNodeSourceVar, "external_node_source");
         }
         // Components
-        // Testing module getting stuff to store component classes
         PyObject* componentsListVar = PyObject_GetAttrString(pStageNode, "components");
         if (PyList_Check(componentsListVar)) {
             for (Py_ssize_t componentIndex = 0; componentIndex < PyList_Size(componentsListVar); componentIndex++) {
                 PyObject* pComponent = PyList_GetItem(componentsListVar, componentIndex);
                 RBE_ASSERT(pComponent != NULL);
-                setup_scene_component_node(node->entity, pComponent);
+                compile_scene_component_node(builder, pComponent);
             }
         }
-        // TODO: Do in a different step or having different functionality to add node to scene tree
-        rbe_ec_system_update_entity_signature_with_systems(node->entity);
         // Children Nodes
         PyObject* childrenListVar = PyObject_GetAttrString(pStageNode, "children");
         if (PyList_Check(childrenListVar)) {
             // Recurse through children nodes
-            setup_scene_stage_nodes(node, childrenListVar);
+            compile_scene_stage_nodes(builder, nodeIndex, childrenListVar);
         }
 
-        rbe_scene_manager_queue_entity_for_creation(node); // May move in a different place TODO: Figure out...
-
         rbe_logger_debug("node_name = %s, node_type = %s", nodeName, nodeType);
         Py_DECREF(externalNodeSourceVar);
     }
 }
 
-void setup_scene_component_node(Entity entity, PyObject* component) {
+void compile_scene_component_node(SceneBinaryBuilder* builder, PyObject* component) {
     const char* className = Py_TYPE(component)->tp_name; // TODO: Should probably Py_DecRed()?
+    SceneBinaryComponent binaryComponent;
+    memset(&binaryComponent, 0, sizeof(SceneBinaryComponent));
     if (strcmp(className, "Transform2DComponent") == 0) {
         rbe_logger_debug("Building transform 2d component");
         PyObject* pPosition = PyObject_GetAttrString(component, "position");
@@ -283,16 +290,16 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         const int zIndex = phy_get_int_from_var(component, "z_index");
         const bool zIndexRelativeToParent = phy_get_bool_from_var(component, "z_index_relative_to_parent");
         const bool ignoreCamera = phy_get_bool_from_var(component, "ignore_camera");
-        Transform2DComponent* transform2DComponent = transform2d_component_create();
-        transform2DComponent->localTransform.position.x = positionX;
-        transform2DComponent->localTransform.position.y = positionY;
-        transform2DComponent->localTransform.scale.x = scaleX;
-        transform2DComponent->localTransform.scale.y = scaleY;
-        transform2DComponent->localTransform.rotation = rotation;
-        transform2DComponent->zIndex = zIndex;
-        transform2DComponent->isZIndexRelativeToParent = zIndexRelativeToParent;
-        transform2DComponent->ignoreCamera = ignoreCamera;
-        component_manager_set_component(entity, ComponentDataIndex_TRANSFORM_2D, transform2DComponent);
+        binaryComponent.type = ComponentDataIndex_TRANSFORM_2D;
+        binaryComponent.transform2D.localTransform.position.x = positionX;
+        binaryComponent.transform2D.localTransform.position.y = positionY;
+        binaryComponent.transform2D.localTransform.scale.x = scaleX;
+        binaryComponent.transform2D.localTransform.scale.y = scaleY;
+        binaryComponent.transform2D.localTransform.rotation = rotation;
+        binaryComponent.transform2D.zIndex = zIndex;
+        binaryComponent.transform2D.isZIndexRelativeToParent = zIndexRelativeToParent;
+        binaryComponent.transform2D.ignoreCamera = ignoreCamera;
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
         rbe_logger_debug("position: (%f, %f), scale: (%f, %f), rotation: %f, z_index: %d, z_index_relative: %d, ignore_camera: %d",
                          positionX, positionY, scaleX, scaleY, rotation, zIndex, zIndexRelativeToParent, ignoreCamera);
         Py_DECREF(pPosition);
@@ -315,23 +322,15 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         const int modulateG = phy_get_int_from_var(pModulate, "g");
         const int modulateB = phy_get_int_from_var(pModulate, "b");
         const int modulateA = phy_get_int_from_var(pModulate, "a");
-        SpriteComponent* spriteComponent = sprite_component_create();
-        spriteComponent->texture = rbe_asset_manager_get_texture(texturePath);
-        RBE_ASSERT_FMT(spriteComponent->texture != NULL, "Unable to read texture path '%s'", texturePath);
-        spriteComponent->drawSource.x = drawSourceX;
-        spriteComponent->drawSource.y = drawSourceY;
-        spriteComponent->drawSource.w = drawSourceW;
-        spriteComponent->drawSource.h = drawSourceH;
-        spriteComponent->origin.x = originX;
-        spriteComponent->origin.y = originY;
-        spriteComponent->flipX = flipX;
-        spriteComponent->flipY = flipY;
-        const Color modulateColor = rbe_color_get_normalized_color(modulateR, modulateG, modulateB, modulateA);
-        spriteComponent->modulate.r = modulateColor.r;
-        spriteComponent->modulate.g = modulateColor.g;
-        spriteComponent->modulate.b = modulateColor.b;
-        spriteComponent->modulate.a = modulateColor.a;
-        component_manager_set_component(entity, ComponentDataIndex_SPRITE, spriteComponent);
+        binaryComponent.type = ComponentDataIndex_SPRITE;
+        binaryComponent.sprite.texturePath = rbe_scene_binary_builder_add_string(builder, texturePath);
+        binaryComponent.sprite.drawSource = (Rect2) { drawSourceX, drawSourceY, drawSourceW, drawSourceH };
+        binaryComponent.sprite.origin.x = originX;
+        binaryComponent.sprite.origin.y = originY;
+        binaryComponent.sprite.flipX = flipX;
+        binaryComponent.sprite.flipY = flipY;
+        binaryComponent.sprite.modulate = rbe_color_get_normalized_color(modulateR, modulateG, modulateB, modulateA);
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
         rbe_logger_debug("texture_path = %s, draw_source = (%f, %f, %f, %f), origin: (%f, %f), flip_x: %d, flip_y: %d, modulate: (%d, %d, %d, %d)",
                          texturePath, drawSourceX, drawSourceY, drawSourceW, drawSourceH, originX, originY, flipX, flipY, modulateR, modulateG, modulateB, modulateA);
         Py_DECREF(pDrawSource);
@@ -339,7 +338,6 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         Py_DECREF(pModulate);
     } else if (strcmp(className, "AnimatedSpriteComponent") == 0) {
         rbe_logger_debug("Building animated sprite component");
-        AnimatedSpriteComponent* animatedSpriteComponent = animated_sprite_component_create();
         const char* currentAnimationName = phy_get_string_from_var(component, "current_animation_name");
         const bool isPlaying = phy_get_bool_from_var(component, "is_playing");
         PyObject* pOrigin = PyObject_GetAttrString(component, "origin");
@@ -349,28 +347,25 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         const bool flipY = phy_get_bool_from_var(component, "flip_y");
         rbe_logger_debug("current_animation_name: '%s', is_playing: '%d', origin: (%f, %f), flip_x: '%d', flip_y: '%d'",
                          currentAnimationName, isPlaying, originX, originY, flipX, flipY);
-        animatedSpriteComponent->isPlaying = isPlaying;
-        animatedSpriteComponent->origin.x = originX;
-        animatedSpriteComponent->origin.y = originY;
-        animatedSpriteComponent->flipX = flipX;
-        animatedSpriteComponent->flipY = flipY;
+        binaryComponent.type = ComponentDataIndex_ANIMATED_SPRITE;
+        binaryComponent.animatedSprite.currentAnimationName = rbe_scene_binary_builder_add_string(builder, currentAnimationName);
+        binaryComponent.animatedSprite.isPlaying = isPlaying;
+        binaryComponent.animatedSprite.origin.x = originX;
+        binaryComponent.animatedSprite.origin.y = originY;
+        binaryComponent.animatedSprite.flipX = flipX;
+        binaryComponent.animatedSprite.flipY = flipY;
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
 
         PyObject* pyAnimationsList = PyObject_GetAttrString(component, "animations");
         RBE_ASSERT(PyList_Check(pyAnimationsList));
         for (Py_ssize_t animationIndex = 0; animationIndex < PyList_Size(pyAnimationsList); animationIndex++) {
-            Animation animation;
-            animation.frameCount = 0;
-            animation.currentFrame = 0;
-            animation.isValid = true;
             PyObject* pyAnimation = PyList_GetItem(pyAnimationsList, animationIndex);
             RBE_ASSERT(pyAnimation != NULL);
             const char* animationName = phy_get_string_from_var(pyAnimation, "name");
             const int animationSpeed = phy_get_int_from_var(pyAnimation, "speed");
             const bool animationLoops = phy_get_bool_from_var(pyAnimation, "loops");
             rbe_logger_debug("building anim - name: '%s', speed: '%d', loops: '%d'", animationName, animationSpeed, animationLoops);
-            strcpy(animation.name, animationName);
-            animation.speed = animationSpeed;
-            animation.doesLoop = animationLoops;
+            rbe_scene_binary_builder_add_animation(builder, animationName, animationSpeed, animationLoops);
 
             PyObject* pyAnimationFramesList = PyObject_GetAttrString(pyAnimation, "frames");
             RBE_ASSERT(PyList_Check(pyAnimationFramesList));
@@ -386,27 +381,17 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
                 const float drawSourceH = phy_get_float_from_var(pyDrawSource, "h");
                 rbe_logger_debug("frame: %d, texture_path: %s, draw_source: (%f, %f, %f, %f)",
                                  animationFrameNumber, animationFrameTexturePath, drawSourceX, drawSourceY, drawSourceW, drawSourceH);
-                AnimationFrame animationFrame;
-                animationFrame.texture = rbe_asset_manager_get_texture(animationFrameTexturePath);
-                RBE_ASSERT(animationFrame.texture != NULL);
-                animationFrame.frame = animationFrameNumber;
-                const Rect2 frameDrawSource = { drawSourceX, drawSourceY, drawSourceW, drawSourceH };
-                animationFrame.drawSource = frameDrawSource;
-                animation.animationFrames[animationFrame.frame] = animationFrame;
-                animation.frameCount++;
+                const SceneBinaryAnimationFrame animationFrame = {
+                    .texturePath = rbe_scene_binary_builder_add_string(builder, animationFrameTexturePath),
+                    .drawSource = { drawSourceX, drawSourceY, drawSourceW, drawSourceH },
+                    .frame = animationFrameNumber
+                };
+                rbe_scene_binary_builder_add_animation_frame(builder, &animationFrame);
 
                 Py_DECREF(pyDrawSource);
             }
-
-            // Set current animation if the name matches
-            animated_sprite_component_add_animation(animatedSpriteComponent, animation);
-            if (strcmp(animation.name, currentAnimationName) == 0) {
-                animatedSpriteComponent->currentAnimation = animation;
-            }
         }
 
-        component_manager_set_component(entity, ComponentDataIndex_ANIMATED_SPRITE, animatedSpriteComponent);
-
         Py_DECREF(pOrigin);
     } else if (strcmp(className, "TextLabelComponent") == 0) {
         rbe_logger_debug("Building text label component");
@@ -417,24 +402,21 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         const int colorG = phy_get_int_from_var(pColor, "g");
         const int colorB = phy_get_int_from_var(pColor, "b");
         const int colorA = phy_get_int_from_var(pColor, "a");
-        const Color textLabelColor = rbe_color_get_normalized_color(colorR, colorG, colorB, colorA);
-        TextLabelComponent* textLabelComponent = text_label_component_create();
-        textLabelComponent->font = rbe_asset_manager_get_font(textLabelUID);
-        RBE_ASSERT(textLabelComponent->font != NULL);
-        strcpy(textLabelComponent->text, textLabelText);
-        textLabelComponent->color = textLabelColor;
-        component_manager_set_component(entity, ComponentDataIndex_TEXT_LABEL, textLabelComponent);
+        binaryComponent.type = ComponentDataIndex_TEXT_LABEL;
+        binaryComponent.textLabel.fontUID = rbe_scene_binary_builder_add_string(builder, textLabelUID);
+        binaryComponent.textLabel.text = rbe_scene_binary_builder_add_string(builder, textLabelText);
+        binaryComponent.textLabel.color = rbe_color_get_normalized_color(colorR, colorG, colorB, colorA);
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
         rbe_logger_debug("uid: %s, text: %s, color(%d, %d, %d, %d)", textLabelUID, textLabelText, colorR, colorG, colorB, colorA);
         Py_DECREF(pColor);
     } else if (strcmp(className, "ScriptComponent") == 0) {
         rbe_logger_debug("Building script component");
         const char* scriptClassPath = phy_get_string_from_var(component, "class_path");
         const char* scriptClassName = phy_get_string_from_var(component, "class_name");
-        ScriptComponent* scriptComponent = script_component_create();
-        scriptComponent->classPath = scriptClassPath;
-        scriptComponent->className = scriptClassName;
-        scriptComponent->contextType = ScriptContextType_PYTHON;
-        component_manager_set_component(entity, ComponentDataIndex_SCRIPT, scriptComponent);
+        binaryComponent.type = ComponentDataIndex_SCRIPT;
+        binaryComponent.script.classPath = rbe_scene_binary_builder_add_string(builder, scriptClassPath);
+        binaryComponent.script.className = rbe_scene_binary_builder_add_string(builder, scriptClassName);
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
         rbe_logger_debug("class_path: %s, class_name: %s", scriptClassPath, scriptClassName);
     } else if (strcmp(className, "Collider2DComponent") == 0) {
         rbe_logger_debug("Building collider2d component");
@@ -448,17 +430,15 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         const int colorG = phy_get_int_from_var(pyColor, "g");
         const int colorB = phy_get_int_from_var(pyColor, "b");
         const int colorA = phy_get_int_from_var(pyColor, "a");
-        Collider2DComponent* collider2DComponent = collider2d_component_create();
-        collider2DComponent->extents.w = rectW;
-        collider2DComponent->extents.h = rectH;
-        collider2DComponent->color.r = (float) colorR / 255.0f;
-        collider2DComponent->color.g = (float) colorG / 255.0f;
-        collider2DComponent->color.b = (float) colorB / 255.0f;
-        collider2DComponent->color.a = (float) colorA / 255.0f;
-        collider2DComponent->collisionExceptionCount = 0;
-        component_manager_set_component(entity, ComponentDataIndex_COLLIDER_2D, collider2DComponent);
-        rbe_logger_debug("extents: (%f, %f), color: (%f, %f, %f, %f)",
-                         rectW, rectH, collider2DComponent->color.r, collider2DComponent->color.g, collider2DComponent->color.b, collider2DComponent->color.a);
+        binaryComponent.type = ComponentDataIndex_COLLIDER_2D;
+        binaryComponent.collider2D.extents.w = rectW;
+        binaryComponent.collider2D.extents.h = rectH;
+        binaryComponent.collider2D.color.r = (float) colorR / 255.0f;
+        binaryComponent.collider2D.color.g = (float) colorG / 255.0f;
+        binaryComponent.collider2D.color.b = (float) colorB / 255.0f;
+        binaryComponent.collider2D.color.a = (float) colorA / 255.0f;
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
+        rbe_logger_debug("extents: (%f, %f), color: (%d, %d, %d, %d)", rectW, rectH, colorR, colorG, colorB, colorA);
 
         Py_DECREF(pyExtents);
         Py_DECREF(pyColor);
@@ -474,17 +454,15 @@ void setup_scene_component_node(Entity entity, PyObject* component) {
         const int colorG = phy_get_int_from_var(pyColor, "g");
         const int colorB = phy_get_int_from_var(pyColor, "b");
         const int colorA = phy_get_int_from_var(pyColor, "a");
-        ColorSquareComponent* colorSquareComponent = color_square_component_create();
-        colorSquareComponent->size.w = rectW;
-        colorSquareComponent->size.h = rectH;
-        colorSquareComponent->color.r = (float) colorR / 255.0f;
-        colorSquareComponent->color.g = (float) colorG / 255.0f;
-        colorSquareComponent->color.b = (float) colorB / 255.0f;
-        colorSquareComponent->color.a = (float) colorA / 255.0f;
-        component_manager_set_component(entity, ComponentDataIndex_COLOR_SQUARE, colorSquareComponent);
-        rbe_logger_debug("size: (%f, %f), color: (%f, %f, %f, %f)",
-                         rectW, rectH, colorSquareComponent->color.r, colorSquareComponent->color.g,
-                         colorSquareComponent->color.b, colorSquareComponent->color.a);
+        binaryComponent.type = ComponentDataIndex_COLOR_SQUARE;
+        binaryComponent.colorSquare.size.w = rectW;
+        binaryComponent.colorSquare.size.h = rectH;
+        binaryComponent.colorSquare.color.r = (float) colorR / 255.0f;
+        binaryComponent.colorSquare.color.g = (float) colorG / 255.0f;
+        binaryComponent.colorSquare.color.b = (float) colorB / 255.0f;
+        binaryComponent.colorSquare.color.a = (float) colorA / 255.0f;
+        rbe_scene_binary_builder_add_component(builder, &binaryComponent);
+        rbe_logger_debug("size: (%f, %f), color: (%d, %d, %d, %d)", rectW, rectH, colorR, colorG, colorB, colorA);
 
         Py_DECREF(pySize);
         Py_DECREF(pyColor);
@@ -638,6 +616,34 @@ PyObject* rbe_py_api_scene_tree_change_scene(PyObject* self, PyObject* args, PyO
     return NULL;
 }
 
+// Prefab Registry
+PyObject* rbe_py_api_prefab_registry_register(PyObject* self, PyObject* args, PyObject* kwargs) {
+    char* name;
+    Entity entity;
+    if (PyArg_ParseTupleAndKeywords(args, kwargs, "si", rbePyApiPrefabRegistryRegisterKWList, &name, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        RBE_PY_API_RETURN_IF_NOT_IN_SCENE_TREE(entity);
+        rbe_prefab_registry_register(name, entity);
+        Py_RETURN_NONE;
+    }
+    return NULL;
+}
+
+PyObject* rbe_py_api_prefab_registry_instantiate(PyObject* self, PyObject* args, PyObject* kwargs) {
+    char* name;
+    Entity parentEntity;
+    if (PyArg_ParseTupleAndKeywords(args, kwargs, "si", rbePyApiPrefabRegistryInstantiateKWList, &name, &parentEntity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(parentEntity);
+        RBE_PY_API_RETURN_IF_NOT_IN_SCENE_TREE(parentEntity);
+        if (!rbe_prefab_registry_has(name)) {
+            PyErr_Format(PyExc_KeyError, "Prefab '%s' isn't registered!", name);
+            return NULL;
+        }
+        return rbe_py_utils_get_entity_instance(rbe_prefab_registry_instantiate(name, parentEntity));
+    }
+    return NULL;
+}
+
 PyObject* rbe_py_api_camera2D_set_boundary(PyObject* self, PyObject* args, PyObject* kwargs) {
     float x;
     float y;
@@ -701,10 +707,10 @@ PyObject* rbe_py_api_node_new(PyObject* self, PyObject* args, PyObject* kwargs)
         RBE_ASSERT_FMT(entityInstance != NULL, "Entity instance '%d' is NULL!", newEntity);
 
         NodeComponent* nodeComponent = node_component_create();
-        strcpy(nodeComponent->name, nodeType);
+        nodeComponent->name = rbe_string_intern(nodeType);
         nodeComponent->type = node_get_base_type(nodeType);
         RBE_ASSERT_FMT(nodeComponent->type != NodeBaseType_INVALID, "Node '%s' has an invalid node type '%s'", nodeType, nodeType);
-        component_manager_set_component(newEntity, ComponentDataIndex_NODE, nodeComponent);
+        nodeComponent = (NodeComponent*) component_manager_set_component(newEntity, ComponentDataIndex_NODE, nodeComponent);
 
         const NodeBaseInheritanceType inheritanceType = node_get_type_inheritance(nodeComponent->type);
 
@@ -747,8 +753,13 @@ PyObject* rbe_py_api_node_new(PyObject* self, PyObject* args, PyObject* kwargs)
 PyObject* rbe_py_api_node_queue_deletion(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
-        SceneTreeNode* node = rbe_scene_manager_get_entity_tree_node(entity);
-        rbe_queue_destroy_tree_node_entity_all(node);
+        if (!rbe_ec_system_is_entity_alive(entity)) {
+            rbe_logger_warn("Entity '%u' was already deleted!", entity);
+            Py_RETURN_NONE;
+        }
+        RBE_PY_API_RETURN_IF_NOT_IN_SCENE_TREE(entity);
+        // Deferred to the command buffer playback, which queues the node and its children for deletion
+        rbe_ecs_command_buffer_destroy_entity(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -758,14 +769,12 @@ PyObject* rbe_py_api_node_add_child(PyObject* self, PyObject* args, PyObject* kw
     Entity parentEntity;
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "ii", rbePyApiNodeAddChildKWList, &parentEntity, &entity)) {
-        SceneTreeNode* parentNode = rbe_scene_manager_get_entity_tree_node(parentEntity);
-        SceneTreeNode* node = rbe_scene_tree_create_tree_node(entity, parentNode);
-        if (parentNode != NULL) {
-            parentNode->children[parentNode->childCount++] = node;
-        }
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(parentEntity);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        rbe_scene_tree_create_tree_node(entity, parentEntity);
 
         rbe_ec_system_update_entity_signature_with_systems(entity);
-        rbe_scene_manager_queue_entity_for_creation(node);
+        rbe_scene_manager_queue_entity_for_creation(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -790,7 +799,8 @@ PyObject* rbe_py_api_node_get_child(PyObject* self, PyObject* args, PyObject* kw
     Entity parentEntity;
     char* childName;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "is", rbePyApiNodeGetChildKWList, &parentEntity, &childName)) {
-        Entity childEntity = rbe_scene_manager_get_entity_child_by_name(parentEntity, childName);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(parentEntity);
+        Entity childEntity = rbe_scene_manager_get_entity_child_by_path(parentEntity, childName);
         if (childEntity == NULL_ENTITY) {
             rbe_logger_warn("Failed to get child node from parent entity '%d' with the name '%s'", parentEntity, childName);
             Py_RETURN_NONE;
@@ -803,13 +813,12 @@ PyObject* rbe_py_api_node_get_child(PyObject* self, PyObject* args, PyObject* kw
 PyObject* rbe_py_api_node_get_children(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity parentEntity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &parentEntity)) {
-        const SceneTreeNode* parentTreeNode = rbe_scene_manager_get_entity_tree_node(parentEntity);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(parentEntity);
         PyObject* pyChildList = PyList_New(0);
-        for (size_t i = 0; i < parentTreeNode->childCount; i++) {
-            const SceneTreeNode* childTreeNode = parentTreeNode->children[i];
-            PyObject* childNode = rbe_py_utils_get_entity_instance(childTreeNode->entity);
+        for (Entity childEntity = rbe_scene_manager_get_entity_tree_node(parentEntity)->firstChild; childEntity != NULL_ENTITY; childEntity = rbe_scene_manager_get_entity_tree_node(childEntity)->nextSibling) {
+            PyObject* childNode = rbe_py_utils_get_entity_instance(childEntity);
             if (PyList_Append(pyChildList, childNode) == -1) {
-                rbe_logger_error("Failed to append entity '%d' to '%d' children list!", parentEntity, childTreeNode->entity);
+                rbe_logger_error("Failed to append entity '%d' to '%d' children list!", parentEntity, childEntity);
                 PyErr_Print();
             }
         }
@@ -821,11 +830,12 @@ PyObject* rbe_py_api_node_get_children(PyObject* self, PyObject* args, PyObject*
 PyObject* rbe_py_api_node_get_parent(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
-        SceneTreeNode* treeNode = rbe_scene_manager_get_entity_tree_node(entity);
-        if (treeNode->parent == NULL) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        const Entity parentEntity = rbe_scene_manager_get_entity_tree_node(entity)->parent;
+        if (parentEntity == NULL_ENTITY) {
             Py_RETURN_NONE;
         }
-        return rbe_py_utils_get_entity_instance(treeNode->parent->entity);
+        return rbe_py_utils_get_entity_instance(parentEntity);
     }
     return NULL;
 }
@@ -836,10 +846,11 @@ PyObject* rbe_py_api_node2D_set_position(PyObject* self, PyObject* args, PyObjec
     float x;
     float y;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iff", rbePyApiNode2DSetXYKWList, &entity, &x, &y)) {
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TRANSFORM_2D);
         transformComp->localTransform.position.x = x;
         transformComp->localTransform.position.y = y;
-        transformComp->isGlobalTransformDirty = true;
+        rbe_scene_manager_invalidate_scene_node_global_transform(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -850,10 +861,11 @@ PyObject* rbe_py_api_node2D_add_to_position(PyObject* self, PyObject* args, PyOb
     float x;
     float y;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iff", rbePyApiNode2DSetXYKWList, &entity, &x, &y)) {
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TRANSFORM_2D);
         transformComp->localTransform.position.x += x;
         transformComp->localTransform.position.y += y;
-        transformComp->isGlobalTransformDirty = true;
+        rbe_scene_manager_invalidate_scene_node_global_transform(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -862,6 +874,7 @@ PyObject* rbe_py_api_node2D_add_to_position(PyObject* self, PyObject* args, PyOb
 PyObject* rbe_py_api_node2D_get_position(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
         return Py_BuildValue("(ff)", transformComp->localTransform.position.x, transformComp->localTransform.position.y);
     }
@@ -871,6 +884,7 @@ PyObject* rbe_py_api_node2D_get_position(PyObject* self, PyObject* args, PyObjec
 PyObject* rbe_py_api_node2D_get_global_position(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
         TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(entity, transformComp);
         return Py_BuildValue("(ff)", globalTransform->position.x, globalTransform->position.y);
@@ -883,10 +897,11 @@ PyObject* rbe_py_api_node2D_set_scale(PyObject* self, PyObject* args, PyObject*
     float x;
     float y;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iff", rbePyApiNode2DSetXYKWList, &entity, &x, &y)) {
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TRANSFORM_2D);
         transformComp->localTransform.scale.x = x;
         transformComp->localTransform.scale.y = y;
-        transformComp->isGlobalTransformDirty = true;
+        rbe_scene_manager_invalidate_scene_node_global_transform(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -897,10 +912,11 @@ PyObject* rbe_py_api_node2D_add_to_scale(PyObject* self, PyObject* args, PyObjec
     float x;
     float y;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iff", rbePyApiNode2DSetXYKWList, &entity, &x, &y)) {
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TRANSFORM_2D);
         transformComp->localTransform.scale.x += x;
         transformComp->localTransform.scale.y += y;
-        transformComp->isGlobalTransformDirty = true;
+        rbe_scene_manager_invalidate_scene_node_global_transform(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -909,6 +925,7 @@ PyObject* rbe_py_api_node2D_add_to_scale(PyObject* self, PyObject* args, PyObjec
 PyObject* rbe_py_api_node2D_get_scale(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
         return Py_BuildValue("(ff)", transformComp->localTransform.scale.x, transformComp->localTransform.scale.y);
     }
@@ -919,9 +936,10 @@ PyObject* rbe_py_api_node2D_set_rotation(PyObject* self, PyObject* args, PyObjec
     Entity entity;
     float rotation;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "if", rbePyApiNode2DSetRotationKWList, &entity, &rotation)) {
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TRANSFORM_2D);
         transformComp->localTransform.rotation = rotation;
-        transformComp->isGlobalTransformDirty = true;
+        rbe_scene_manager_invalidate_scene_node_global_transform(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -931,9 +949,10 @@ PyObject* rbe_py_api_node2D_add_to_rotation(PyObject* self, PyObject* args, PyOb
     Entity entity;
     float rotation;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "if", rbePyApiNode2DSetRotationKWList, &entity, &rotation)) {
-        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TRANSFORM_2D);
         transformComp->localTransform.rotation += rotation;
-        transformComp->isGlobalTransformDirty = true;
+        rbe_scene_manager_invalidate_scene_node_global_transform(entity);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -942,6 +961,7 @@ PyObject* rbe_py_api_node2D_add_to_rotation(PyObject* self, PyObject* args, PyOb
 PyObject* rbe_py_api_node2D_get_rotation(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const Transform2DComponent* transformComp = (Transform2DComponent*) component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
         return Py_BuildValue("f", transformComp->localTransform.rotation);
     }
@@ -953,7 +973,8 @@ PyObject* rbe_py_api_sprite_set_texture(PyObject* self, PyObject* args, PyObject
     Entity entity;
     char* filePath;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "is", rbePyApiSpriteSetTextureKWList, &entity, &filePath)) {
-        SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component(entity, ComponentDataIndex_SPRITE);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_SPRITE);
         RBE_ASSERT_FMT(rbe_asset_manager_has_texture(filePath), "Doesn't have texture with file path '%s'", filePath);
         spriteComponent->texture = rbe_asset_manager_get_texture(filePath);
         Py_RETURN_NONE;
@@ -964,6 +985,7 @@ PyObject* rbe_py_api_sprite_set_texture(PyObject* self, PyObject* args, PyObject
 PyObject* rbe_py_api_sprite_get_texture(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component(entity, ComponentDataIndex_SPRITE);
         return Py_BuildValue("(sssss)", spriteComponent->texture->fileName, "clamp_to_border", "clamp_to_border", "nearest", "nearest");
     }
@@ -977,7 +999,8 @@ PyObject* rbe_py_api_sprite_set_draw_source(PyObject* self, PyObject* args, PyOb
     float w;
     float h;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iffff", rbePyApiGenericSetEntityRectKWList, &entity, &x, &y, &w, &h)) {
-        SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component(entity, ComponentDataIndex_SPRITE);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_SPRITE);
         spriteComponent->drawSource.x = x;
         spriteComponent->drawSource.y = y;
         spriteComponent->drawSource.w = w;
@@ -990,6 +1013,7 @@ PyObject* rbe_py_api_sprite_set_draw_source(PyObject* self, PyObject* args, PyOb
 PyObject* rbe_py_api_sprite_get_draw_source(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const SpriteComponent* spriteComponent = (SpriteComponent*) component_manager_get_component(entity, ComponentDataIndex_SPRITE);
         return Py_BuildValue("(ffff)", spriteComponent->drawSource.x, spriteComponent->drawSource.y, spriteComponent->drawSource.w, spriteComponent->drawSource.h);
     }
@@ -1001,7 +1025,8 @@ PyObject* rbe_py_api_animated_sprite_play(PyObject* self, PyObject* args, PyObje
     Entity entity;
     char* animationName;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "is", rbePyApiAnimatedSpriteSetAnimationKWList, &entity, &animationName)) {
-        AnimatedSpriteComponent* animatedSpriteComponent = (AnimatedSpriteComponent *) component_manager_get_component(entity, ComponentDataIndex_ANIMATED_SPRITE);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        AnimatedSpriteComponent* animatedSpriteComponent = (AnimatedSpriteComponent *) component_manager_get_component_for_write(entity, ComponentDataIndex_ANIMATED_SPRITE);
         const bool success = animated_sprite_component_set_animation(animatedSpriteComponent, animationName);
         animatedSpriteComponent->isPlaying = true;
         if (success) {
@@ -1015,7 +1040,8 @@ PyObject* rbe_py_api_animated_sprite_play(PyObject* self, PyObject* args, PyObje
 PyObject* rbe_py_api_animated_sprite_stop(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "is", rbePyApiGenericGetEntityKWList, &entity)) {
-        AnimatedSpriteComponent* animatedSpriteComponent = (AnimatedSpriteComponent *) component_manager_get_component(entity, ComponentDataIndex_ANIMATED_SPRITE);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        AnimatedSpriteComponent* animatedSpriteComponent = (AnimatedSpriteComponent *) component_manager_get_component_for_write(entity, ComponentDataIndex_ANIMATED_SPRITE);
         animatedSpriteComponent->isPlaying = false;
     }
     return NULL;
@@ -1026,8 +1052,9 @@ PyObject* rbe_py_api_text_label_set_text(PyObject* self, PyObject* args, PyObjec
     Entity entity;
     char* text;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "is", rbePyApiTextLabelSetTextKWList, &entity, &text)) {
-        TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component(entity, ComponentDataIndex_TEXT_LABEL);
-        strcpy(textLabelComponent->text, text);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TEXT_LABEL);
+        text_label_component_set_text(textLabelComponent, text);
         Py_RETURN_NONE;
     }
     return NULL;
@@ -1036,6 +1063,7 @@ PyObject* rbe_py_api_text_label_set_text(PyObject* self, PyObject* args, PyObjec
 PyObject* rbe_py_api_text_label_get_text(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component(entity, ComponentDataIndex_TEXT_LABEL);
         return Py_BuildValue("s", textLabelComponent->text);
     }
@@ -1049,7 +1077,8 @@ PyObject* rbe_py_api_text_label_set_color(PyObject* self, PyObject* args, PyObje
     int blue;
     int alpha;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iffff", rbePyApiGenericSetEntityColorKWList, &entity, &red, &green, &blue, &alpha)) {
-        TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component(entity, ComponentDataIndex_TEXT_LABEL);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_TEXT_LABEL);
         textLabelComponent->color = rbe_color_get_normalized_color(red, green, blue, alpha);
         Py_RETURN_NONE;
     }
@@ -1059,6 +1088,7 @@ PyObject* rbe_py_api_text_label_set_color(PyObject* self, PyObject* args, PyObje
 PyObject* rbe_py_api_text_label_get_color(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         TextLabelComponent* textLabelComponent = (TextLabelComponent*) component_manager_get_component(entity, ComponentDataIndex_TEXT_LABEL);
         const int red = (int) (textLabelComponent->color.r * 255.0f);
         const int green = (int) (textLabelComponent->color.r * 255.0f);
@@ -1075,7 +1105,8 @@ PyObject* rbe_py_api_collider2D_set_extents(PyObject* self, PyObject* args, PyOb
     float w;
     float h;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iff", rbePyApiGenericSetEntitySize2DKWList, &entity, &w, &h)) {
-        Collider2DComponent* collider2DComponent = (Collider2DComponent*) component_manager_get_component(entity, ComponentDataIndex_COLLIDER_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Collider2DComponent* collider2DComponent = (Collider2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_COLLIDER_2D);
         collider2DComponent->extents.w = w;
         collider2DComponent->extents.h = h;
         Py_RETURN_NONE;
@@ -1086,6 +1117,7 @@ PyObject* rbe_py_api_collider2D_set_extents(PyObject* self, PyObject* args, PyOb
 PyObject* rbe_py_api_collider2D_get_extents(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const Collider2DComponent* collider2DComponent = (Collider2DComponent *) component_manager_get_component(entity, ComponentDataIndex_COLLIDER_2D);
         return Py_BuildValue("(ff)", collider2DComponent->extents.w, collider2DComponent->extents.h);
     }
@@ -1099,7 +1131,8 @@ PyObject* rbe_py_api_collider2D_set_color(PyObject* self, PyObject* args, PyObje
     int blue;
     int alpha;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iiiii", rbePyApiGenericSetEntityColorKWList, &entity, &red, &green, &blue, &alpha)) {
-        Collider2DComponent* collider2DComponent = (Collider2DComponent*) component_manager_get_component(entity, ComponentDataIndex_COLLIDER_2D);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        Collider2DComponent* collider2DComponent = (Collider2DComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_COLLIDER_2D);
         collider2DComponent->color = rbe_color_get_normalized_color(red, green, blue, alpha);
         Py_RETURN_NONE;
     }
@@ -1109,6 +1142,7 @@ PyObject* rbe_py_api_collider2D_set_color(PyObject* self, PyObject* args, PyObje
 PyObject* rbe_py_api_collider2D_get_color(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         Collider2DComponent* collider2DComponent = (Collider2DComponent *) component_manager_get_component(entity, ComponentDataIndex_COLLIDER_2D);
         const int red = (int) (collider2DComponent->color.r * 255.0f);
         const int green = (int) (collider2DComponent->color.g * 255.0f);
@@ -1125,7 +1159,8 @@ PyObject* rbe_py_api_color_square_set_size(PyObject* self, PyObject* args, PyObj
     float w;
     float h;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iff", rbePyApiGenericSetEntitySize2DKWList, &entity, &w, &h)) {
-        ColorSquareComponent* colorSquareComponent = (ColorSquareComponent*) component_manager_get_component(entity, ComponentDataIndex_COLOR_SQUARE);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        ColorSquareComponent* colorSquareComponent = (ColorSquareComponent*) component_manager_get_component_for_write(entity, ComponentDataIndex_COLOR_SQUARE);
         colorSquareComponent->size.w = w;
         colorSquareComponent->size.h = h;
         Py_RETURN_NONE;
@@ -1136,6 +1171,7 @@ PyObject* rbe_py_api_color_square_set_size(PyObject* self, PyObject* args, PyObj
 PyObject* rbe_py_api_color_square_get_size(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         const ColorSquareComponent* colorSquareComponent = (ColorSquareComponent*) component_manager_get_component(entity, ComponentDataIndex_COLOR_SQUARE);
         return Py_BuildValue("(ff)", colorSquareComponent->size.w, colorSquareComponent->size.h);
     }
@@ -1149,7 +1185,8 @@ PyObject* rbe_py_api_color_square_set_color(PyObject* self, PyObject* args, PyOb
     int blue;
     int alpha;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "iiiii", rbePyApiGenericSetEntityColorKWList, &entity, &red, &green, &blue, &alpha)) {
-        ColorSquareComponent* colorSquareComponent = (ColorSquareComponent *) component_manager_get_component(entity, ComponentDataIndex_COLOR_SQUARE);
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
+        ColorSquareComponent* colorSquareComponent = (ColorSquareComponent *) component_manager_get_component_for_write(entity, ComponentDataIndex_COLOR_SQUARE);
         colorSquareComponent->color = rbe_color_get_normalized_color(red, green, blue, alpha);
         Py_RETURN_NONE;
     }
@@ -1159,6 +1196,7 @@ PyObject* rbe_py_api_color_square_set_color(PyObject* self, PyObject* args, PyOb
 PyObject* rbe_py_api_color_square_get_color(PyObject* self, PyObject* args, PyObject* kwargs) {
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         ColorSquareComponent* colorSquareComponent = (ColorSquareComponent*) component_manager_get_component(entity, ComponentDataIndex_COLOR_SQUARE);
         const int red = (int) (colorSquareComponent->color.r * 255.0f);
         const int green = (int) (colorSquareComponent->color.g * 255.0f);
@@ -1263,6 +1301,7 @@ PyObject* rbe_py_api_collision_handler_process_collisions(PyObject* self, PyObje
 #define TYPE_BUFFER_SIZE 32
     Entity entity;
     if (PyArg_ParseTupleAndKeywords(args, kwargs, "i", rbePyApiGenericGetEntityKWList, &entity)) {
+        RBE_PY_API_RETURN_IF_STALE_ENTITY(entity);
         char typeBuffer[TYPE_BUFFER_SIZE];
         PyObject* pyCollidedEntityList = PyList_New(0);
         CollisionResult collisionResult = rbe_collision_process_entity_collisions(entity);
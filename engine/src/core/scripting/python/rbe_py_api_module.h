@@ -42,6 +42,10 @@ PyObject* rbe_py_api_camera2D_get_boundary(PyObject* self, PyObject* args);
 // SceneTree
 PyObject* rbe_py_api_scene_tree_change_scene(PyObject* self, PyObject* args, PyObject* kwargs);
 
+// Prefab Registry
+PyObject* rbe_py_api_prefab_registry_register(PyObject* self, PyObject* args, PyObject* kwargs);
+PyObject* rbe_py_api_prefab_registry_instantiate(PyObject* self, PyObject* args, PyObject* kwargs);
+
 // Audio Manager
 PyObject* rbe_py_api_audio_manager_play_sound(PyObject* self, PyObject* args, PyObject* kwargs);
 PyObject* rbe_py_api_audio_manager_stop_sound(PyObject* self, PyObject* args, PyObject* kwargs);
@@ -218,6 +222,15 @@ static struct PyMethodDef rbePyApiMethods[] = {
         "scene_tree_change_scene", (PyCFunction) rbe_py_api_scene_tree_change_scene,
         METH_VARARGS | METH_KEYWORDS, "Change to a new scene."
     },
+    // PREFAB REGISTRY
+    {
+        "prefab_registry_register", (PyCFunction) rbe_py_api_prefab_registry_register,
+        METH_VARARGS | METH_KEYWORDS, "Captures a node and its children as a prefab."
+    },
+    {
+        "prefab_registry_instantiate", (PyCFunction) rbe_py_api_prefab_registry_instantiate,
+        METH_VARARGS | METH_KEYWORDS, "Clones a prefab under a parent node."
+    },
     // AUDIO MANAGER
     {
         "audio_manager_play_sound", (PyCFunction) rbe_py_api_audio_manager_play_sound,
@@ -447,6 +460,9 @@ static char *rbePyApiInputActionInputCheckKWList[] = {"name", NULL};
 
 static char *rbePyApiAudioManagerPlaySoundKWList[] = {"path", "loops", NULL};
 
+static char *rbePyApiPrefabRegistryRegisterKWList[] = {"name", "entity_id", NULL};
+static char *rbePyApiPrefabRegistryInstantiateKWList[] = {"name", "parent_entity_id", NULL};
+
 static char *rbePyApiNodeNewKWList[] = {"class_path", "class_name", "node_type", NULL};
 static char *rbePyApiNodeAddChildKWList[] = {"parent_entity_id", "child_entity_id", NULL};
 static char *rbePyApiNodeGetChildKWList[] = {"entity_id", "child_name", NULL};
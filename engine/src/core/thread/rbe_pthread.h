@@ -8,6 +8,13 @@
 #include <pthread.h>
 #endif
 
+// Msvc's C compiler doesn't support '_Thread_local'
+#ifdef _MSC_VER
+#define RBE_THREAD_LOCAL __declspec(thread)
+#else
+#define RBE_THREAD_LOCAL _Thread_local
+#endif
+
 #ifdef _WIN32
 typedef CRITICAL_SECTION pthread_mutex_t;
 typedef void pthread_mutexattr_t;
@@ -174,7 +174,8 @@ void tpool_wait(ThreadPool* tp) {
 
     pthread_mutex_lock(&(tp->workMutex));
     while (true) {
-        if ((!tp->shouldStop && tp->workingCount != 0) || (tp->shouldStop && tp->threadCount != 0)) {
+        // Queued work that no worker has picked up yet counts as pending too
+        if ((!tp->shouldStop && (tp->workingCount != 0 || tp->workFirst != NULL)) || (tp->shouldStop && tp->threadCount != 0)) {
             pthread_cond_wait(&(tp->workingCond), &(tp->workMutex));
         } else {
             break;
@@ -182,3 +183,101 @@ void tpool_wait(ThreadPool* tp) {
     }
     pthread_mutex_unlock(&(tp->workMutex));
 }
+
+// --- Parallel For --- //
+// Heap allocated and shared with the helper jobs, helpers may only start after the caller has returned
+typedef struct ParallelForTask {
+    ParallelForFunc func;
+    void* context;
+    size_t count;
+    size_t chunkSize;
+    size_t chunkCount;
+    size_t nextChunk;
+    size_t completedChunks;
+    size_t refCount;
+    pthread_mutex_t mutex;
+    pthread_cond_t completedCond;
+} ParallelForTask;
+
+static void tpool_parallel_for_task_release(ParallelForTask* task) {
+    pthread_mutex_lock(&(task->mutex));
+    const bool isLastRef = --task->refCount == 0;
+    pthread_mutex_unlock(&(task->mutex));
+    if (isLastRef) {
+        pthread_mutex_destroy(&(task->mutex));
+        pthread_cond_destroy(&(task->completedCond));
+        RBE_MEM_FREE(task);
+    }
+}
+
+static void tpool_parallel_for_run_chunks(ParallelForTask* task) {
+    while (true) {
+        pthread_mutex_lock(&(task->mutex));
+        if (task->nextChunk >= task->chunkCount) {
+            pthread_mutex_unlock(&(task->mutex));
+            break;
+        }
+        const size_t chunkIndex = task->nextChunk++;
+        pthread_mutex_unlock(&(task->mutex));
+
+        const size_t start = chunkIndex * task->chunkSize;
+        const size_t end = start + task->chunkSize < task->count ? start + task->chunkSize : task->count;
+        task->func(start, end, chunkIndex, task->context);
+
+        pthread_mutex_lock(&(task->mutex));
+        if (++task->completedChunks == task->chunkCount) {
+            pthread_cond_signal(&(task->completedCond));
+        }
+        pthread_mutex_unlock(&(task->mutex));
+    }
+}
+
+static void tpool_parallel_for_helper(void* arg) {
+    ParallelForTask* task = (ParallelForTask*) arg;
+    tpool_parallel_for_run_chunks(task);
+    tpool_parallel_for_task_release(task);
+}
+
+size_t tpool_parallel_for(ThreadPool* tp, size_t count, size_t chunkSize, ParallelForFunc func, void* context) {
+    if (count == 0) {
+        return 0;
+    }
+    if (chunkSize == 0) {
+        chunkSize = 1;
+    }
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount == 1 || tp == NULL) {
+        for (size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++) {
+            const size_t start = chunkIndex * chunkSize;
+            func(start, start + chunkSize < count ? start + chunkSize : count, chunkIndex, context);
+        }
+        return chunkCount;
+    }
+
+    ParallelForTask* task = RBE_MEM_ALLOCATE(ParallelForTask);
+    task->func = func;
+    task->context = context;
+    task->count = count;
+    task->chunkSize = chunkSize;
+    task->chunkCount = chunkCount;
+    task->nextChunk = 0;
+    task->completedChunks = 0;
+    pthread_mutex_init(&(task->mutex), NULL);
+    pthread_cond_init(&(task->completedCond), NULL);
+    // Calling thread takes chunks too, so at most one helper per remaining chunk
+    const size_t helperCount = chunkCount - 1 < tp->threadCount ? chunkCount - 1 : tp->threadCount;
+    task->refCount = helperCount + 1;
+    for (size_t i = 0; i < helperCount; i++) {
+        tpool_add_work(tp, tpool_parallel_for_helper, task);
+    }
+
+    tpool_parallel_for_run_chunks(task);
+    // Helpers that haven't started by now find no chunks left and only release the task
+    pthread_mutex_lock(&(task->mutex));
+    while (task->completedChunks < task->chunkCount) {
+        pthread_cond_wait(&(task->completedCond), &(task->mutex));
+    }
+    pthread_mutex_unlock(&(task->mutex));
+    tpool_parallel_for_task_release(task);
+    return chunkCount;
+}
@@ -6,6 +6,8 @@
 #include "rbe_pthread.h"
 
 typedef void (*ThreadFunc)(void* arg);
+// Runs on items [start, end), chunk index is stable for a given count and chunk size so it can pick an output buffer
+typedef void (*ParallelForFunc)(size_t start, size_t end, size_t chunkIndex, void* context);
 
 typedef struct ThreadPoolWork {
     ThreadFunc func;
@@ -30,3 +32,6 @@ void tpool_destroy(ThreadPool* tp);
 bool tpool_add_work(ThreadPool* tp, ThreadFunc func, void* arg);
 // Blocking function that finishes once all work is completed.
 void tpool_wait(ThreadPool* tp);
+// Splits [0, count) into chunks and runs 'func' on them with the pool's workers and the calling thread.
+// Only waits on chunks, not the pool, so it's safe to call from inside a pool job.  Returns the chunk count.
+size_t tpool_parallel_for(ThreadPool* tp, size_t count, size_t chunkSize, ParallelForFunc func, void* context);
@@ -1,5 +1,6 @@
 #include "command_line_args_util.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "logger.h"
@@ -10,8 +11,15 @@
 
 CommandLineFlagResult rbe_command_line_args_parse(int argv, char** args) {
     const int WORKING_DIR_OVERRIDE_CAPACITY = 128;
+    const int FRAME_DUMP_DIR_CAPACITY = 128;
+    const int SCENE_EXPORT_DIR_CAPACITY = 128;
     CommandLineFlagResult flagResult;
     memset(flagResult.workingDirOverride, 0, WORKING_DIR_OVERRIDE_CAPACITY);
+    flagResult.isHeadless = false;
+    flagResult.frameLimit = 0;
+    flagResult.logFrameChecksums = false;
+    memset(flagResult.frameDumpDir, 0, FRAME_DUMP_DIR_CAPACITY);
+    memset(flagResult.sceneExportDir, 0, SCENE_EXPORT_DIR_CAPACITY);
     flagResult.flagCount = 0;
     if (argv <= 1) {
         return flagResult;
@@ -20,6 +28,13 @@ CommandLineFlagResult rbe_command_line_args_parse(int argv, char** args) {
         // Can process single argument if needed
         const char* argument = args[argumentIndex];
         rbe_logger_debug("command line argument = '%s'", argument);
+        if (strcmp(argument, RBE_COMMAND_LINE_FLAG_HEADLESS) == 0) {
+            flagResult.isHeadless = true;
+            continue;
+        } else if (strcmp(argument, RBE_COMMAND_LINE_FLAG_FRAME_CHECKSUMS) == 0) {
+            flagResult.logFrameChecksums = true;
+            continue;
+        }
         // Process arg value
         const int nextArgumentIndex = argumentIndex + 1;
         if (nextArgumentIndex >= argv) {
@@ -30,6 +45,18 @@ CommandLineFlagResult rbe_command_line_args_parse(int argv, char** args) {
             strcpy(flagResult.workingDirOverride, workingDirectoryOverride);
             rbe_logger_debug("working directory override = '%s'", flagResult.workingDirOverride);
             argumentIndex++;
+        } else if (strcmp(argument, RBE_COMMAND_LINE_FLAG_FRAME_LIMIT) == 0) {
+            flagResult.frameLimit = atoi(args[nextArgumentIndex]);
+            rbe_logger_debug("frame limit = '%d'", flagResult.frameLimit);
+            argumentIndex++;
+        } else if (strcmp(argument, RBE_COMMAND_LINE_FLAG_FRAME_DUMP_DIR) == 0) {
+            strncpy(flagResult.frameDumpDir, args[nextArgumentIndex], FRAME_DUMP_DIR_CAPACITY - 1);
+            rbe_logger_debug("frame dump directory = '%s'", flagResult.frameDumpDir);
+            argumentIndex++;
+        } else if (strcmp(argument, RBE_COMMAND_LINE_FLAG_SCENE_EXPORT_DIR) == 0) {
+            strncpy(flagResult.sceneExportDir, args[nextArgumentIndex], SCENE_EXPORT_DIR_CAPACITY - 1);
+            rbe_logger_debug("scene export directory = '%s'", flagResult.sceneExportDir);
+            argumentIndex++;
         }
     }
     return flagResult;
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <stdbool.h>
+
 #define RBE_COMMAND_LINE_FLAG_WORK_DIR "-d"
+#define RBE_COMMAND_LINE_FLAG_HEADLESS "-headless"
+#define RBE_COMMAND_LINE_FLAG_FRAME_LIMIT "-frames"
+#define RBE_COMMAND_LINE_FLAG_FRAME_CHECKSUMS "-frame-checksums"
+#define RBE_COMMAND_LINE_FLAG_FRAME_DUMP_DIR "-frame-dump-dir"
+#define RBE_COMMAND_LINE_FLAG_SCENE_EXPORT_DIR "-scene-export-dir"
 
 typedef struct CommandLineFlagResult {
     char workingDirOverride[128];
+    bool isHeadless; // Renders offscreen without a window
+    int frameLimit; // Stops the engine after this many frames when greater than zero
+    bool logFrameChecksums;
+    char frameDumpDir[128];
+    char sceneExportDir[128]; // Scenes compiled from python are also written here as scene binaries
     int flagCount;
 } CommandLineFlagResult;
 
@@ -0,0 +1,62 @@
+#include "rbe_string_intern.h"
+
+#include "rbe_string_util.h"
+#include "rbe_assert.h"
+#include "../data_structures/rbe_hash_map_string.h"
+#include "../memory/rbe_mem.h"
+
+static RBEStringHashMap* stringToIdMap = NULL;
+// Indexed by id, id 0 is RBE_STRING_ID_NONE
+static char** internedStrings = NULL;
+static size_t internedStringCount = 0;
+static size_t internedStringCapacity = 0;
+
+void rbe_string_intern_initialize() {
+    RBE_ASSERT(stringToIdMap == NULL);
+    stringToIdMap = rbe_string_hash_map_create(64);
+    internedStringCapacity = 64;
+    internedStrings = RBE_MEM_ALLOCATE_SIZE(internedStringCapacity * sizeof(char*));
+    internedStrings[RBE_STRING_ID_NONE] = NULL;
+    internedStringCount = 1;
+}
+
+void rbe_string_intern_finalize() {
+    RBE_ASSERT(stringToIdMap != NULL);
+    for (size_t i = 1; i < internedStringCount; i++) {
+        RBE_MEM_FREE(internedStrings[i]);
+    }
+    RBE_MEM_FREE(internedStrings);
+    rbe_string_hash_map_destroy(stringToIdMap);
+    stringToIdMap = NULL;
+    internedStrings = NULL;
+    internedStringCount = 0;
+    internedStringCapacity = 0;
+}
+
+StringId rbe_string_intern(const char* string) {
+    const StringId existingId = rbe_string_intern_find(string);
+    if (existingId != RBE_STRING_ID_NONE) {
+        return existingId;
+    }
+    if (internedStringCount >= internedStringCapacity) {
+        internedStringCapacity *= 2;
+        internedStrings = RBE_MEM_REALLOCATE(internedStrings, internedStringCapacity * sizeof(char*));
+    }
+    const StringId newId = (StringId) internedStringCount++;
+    internedStrings[newId] = rbe_strdup(string);
+    rbe_string_hash_map_add_int(stringToIdMap, string, (int) newId);
+    return newId;
+}
+
+StringId rbe_string_intern_find(const char* string) {
+    RBE_ASSERT(stringToIdMap != NULL);
+    if (!rbe_string_hash_map_has(stringToIdMap, string)) {
+        return RBE_STRING_ID_NONE;
+    }
+    return (StringId) rbe_string_hash_map_get_int(stringToIdMap, string);
+}
+
+const char* rbe_string_intern_get(StringId id) {
+    RBE_ASSERT_FMT(id < internedStringCount, "Invalid string id '%u'!", id);
+    return internedStrings[id];
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// Interned strings are stored once and referred to by id, ids compare as integers and stay valid until finalize
+typedef uint32_t StringId;
+
+#define RBE_STRING_ID_NONE 0
+
+void rbe_string_intern_initialize();
+void rbe_string_intern_finalize();
+// Returns the id for 'string', interning it if it's new
+StringId rbe_string_intern(const char* string);
+// Returns RBE_STRING_ID_NONE if 'string' was never interned, doesn't grow the table
+StringId rbe_string_intern_find(const char* string);
+const char* rbe_string_intern_get(StringId id);
@@ -5,9 +5,17 @@
 #include <unity.h>
 
 #include "../core/memory/rbe_mem.h"
+#include "../core/math/rbe_math.h"
 #include "../core/scene/scene_manager.h"
+#include "../core/scene/prefab_registry.h"
+#include "../core/scene/scene_binary.h"
 #include "../core/ecs/component/component.h"
+#include "../core/ecs/component/collider2d_component.h"
+#include "../core/ecs/component/color_square_component.h"
+#include "../core/ecs/component/script_component.h"
 #include "../core/ecs/component/transform2d_component.h"
+#include "../core/ecs/system/ec_system.h"
+#include "../core/ecs/ecs_command_buffer.h"
 #include "../core/data_structures/rbe_hash_map.h"
 #include "../core/data_structures/rbe_hash_map_string.h"
 #include "../core/data_structures/rbe_array_list.h"
@@ -15,13 +23,24 @@
 #include "../core/thread/rbe_pthread.h"
 #include "../core/thread/rbe_thread_pool.h"
 #include "../core/utils/rbe_string_util.h"
+#include "../core/utils/rbe_string_intern.h"
 
 void rbe_hash_main_test();
 void rbe_string_hashmap_test();
+void rbe_string_intern_test();
 void rbe_static_array_test();
 void rbe_array_list_test();
 void rbe_thread_main_test();
 void rbe_scene_graph_test();
+void rbe_scene_binary_test();
+void rbe_ecs_command_buffer_test();
+void rbe_rect2_bounds_test();
+void rbe_entity_generation_test();
+void rbe_ec_system_scheduler_test();
+void rbe_thread_pool_parallel_for_test();
+void rbe_component_archetype_test();
+void rbe_component_change_tick_test();
+void rbe_prefab_registry_test();
 
 void setUp() {}
 void tearDown() {}
@@ -30,10 +49,20 @@ int main(int argv, char** args) {
     UNITY_BEGIN();
     RUN_TEST(rbe_hash_main_test);
     RUN_TEST(rbe_string_hashmap_test);
+    RUN_TEST(rbe_string_intern_test);
     RUN_TEST(rbe_array_list_test);
     RUN_TEST(rbe_static_array_test);
     RUN_TEST(rbe_thread_main_test);
     RUN_TEST(rbe_scene_graph_test);
+    RUN_TEST(rbe_scene_binary_test);
+    RUN_TEST(rbe_ecs_command_buffer_test);
+    RUN_TEST(rbe_rect2_bounds_test);
+    RUN_TEST(rbe_entity_generation_test);
+    RUN_TEST(rbe_ec_system_scheduler_test);
+    RUN_TEST(rbe_thread_pool_parallel_for_test);
+    RUN_TEST(rbe_component_archetype_test);
+    RUN_TEST(rbe_component_change_tick_test);
+    RUN_TEST(rbe_prefab_registry_test);
     return UNITY_END();
 }
 
@@ -177,6 +206,19 @@ void rbe_string_hashmap_test() {
     rbe_string_hash_map_destroy(map);
 }
 
+void rbe_string_intern_test() {
+    rbe_string_intern_initialize();
+    const StringId playerId = rbe_string_intern("PlayerOne");
+    const StringId colliderId = rbe_string_intern("Collider");
+    TEST_ASSERT_NOT_EQUAL(RBE_STRING_ID_NONE, playerId);
+    TEST_ASSERT_NOT_EQUAL(playerId, colliderId);
+    TEST_ASSERT_EQUAL_UINT32(playerId, rbe_string_intern("PlayerOne"));
+    TEST_ASSERT_EQUAL_UINT32(colliderId, rbe_string_intern_find("Collider"));
+    TEST_ASSERT_EQUAL_UINT32(RBE_STRING_ID_NONE, rbe_string_intern_find("TimeDisplay"));
+    TEST_ASSERT_EQUAL_STRING("PlayerOne", rbe_string_intern_get(playerId));
+    rbe_string_intern_finalize();
+}
+
 void rbe_array_list_test() {
     RBEArrayList* arrayList = rbe_array_list_create(10, sizeof(int));
     TEST_ASSERT_EQUAL_INT(arrayList->size, 10);
@@ -266,48 +308,482 @@ void rbe_scene_graph_test() {
     parentTransform->localTransform.rotation = 180.0f;
     parentTransform->localTransform.scale.x = 4.0f;
     parentTransform->localTransform.scale.y = 4.0f;
-    component_manager_set_component(parentEntity, ComponentDataIndex_TRANSFORM_2D, parentTransform);
-    SceneTreeNode* parentNode = rbe_scene_tree_create_tree_node(parentEntity, NULL);
-    rbe_scene_manager_queue_entity_for_creation(parentNode);
+    parentTransform = (Transform2DComponent*) component_manager_set_component(parentEntity, ComponentDataIndex_TRANSFORM_2D, parentTransform);
+    rbe_scene_tree_create_tree_node(parentEntity, NULL_ENTITY);
+    rbe_scene_manager_queue_entity_for_creation(parentEntity);
 
-    mat4 parentModel;
-    transform2d_component_get_local_model_matrix(parentModel, parentTransform);
-    glm_mat4_print(parentModel, stdout);
+    Affine2D parentModel;
+    transform2d_component_get_local_model(&parentModel, parentTransform);
     // Child 1
     Entity childOneEntity = 2;
     Transform2DComponent* childOneTransform = transform2d_component_create();
     childOneTransform->localTransform.position.x = 100.0f;
     childOneTransform->localTransform.position.y = 20.0f;
-    component_manager_set_component(childOneEntity, ComponentDataIndex_TRANSFORM_2D, childOneTransform);
-    SceneTreeNode* childOneNode = rbe_scene_tree_create_tree_node(childOneEntity, parentNode);
-    rbe_scene_manager_queue_entity_for_creation(childOneNode);
-
-    mat4 childOneModel;
-    transform2d_component_get_local_model_matrix(childOneModel, childOneTransform);
+    childOneTransform = (Transform2DComponent*) component_manager_set_component(childOneEntity, ComponentDataIndex_TRANSFORM_2D, childOneTransform);
+    rbe_scene_tree_create_tree_node(childOneEntity, parentEntity);
+    rbe_scene_manager_queue_entity_for_creation(childOneEntity);
+    TEST_ASSERT_EQUAL_UINT32(childOneEntity, rbe_scene_manager_get_entity_tree_node(parentEntity)->firstChild);
+    TEST_ASSERT_EQUAL_UINT32(parentEntity, rbe_scene_manager_get_entity_tree_node(childOneEntity)->parent);
+
+    Affine2D childOneModel;
+    transform2d_component_get_local_model(&childOneModel, childOneTransform);
     // Multiply with parent to get world space
-//    glm_mat4_mul(childOneModel, parentModel, childOneModel);
-    glm_mat4_mul(parentModel, childOneModel, childOneModel);
-    glm_mat4_print(childOneModel, stdout);
-
-    Vector2 childTranslatedPos = transform2d_component_get_position_from_model(childOneModel);
-//    TEST_ASSERT_EQUAL_FLOAT(childTranslatedPos.x, 120.0f);
-//    TEST_ASSERT_EQUAL_FLOAT(childTranslatedPos.y, 280.0f);
-
-    // Scene graph model getting
-//    mat4 childOneCombinedModel;
-//    rbe_scene_manager_update_global_tranform_model(childOneEntity, childOneCombinedModel);
-//    glm_mat4_print(childOneCombinedModel, stdout);
-//    childTranslatedPos = transform2d_component_get_position_from_model(childOneCombinedModel);
-////    TEST_ASSERT_EQUAL_FLOAT(childTranslatedPos.x, 120.0f);
-////    TEST_ASSERT_EQUAL_FLOAT(childTranslatedPos.y, 280.0f);
-//
-//    const Vector2 childOneScale = transform2d_component_get_scale_from_model(childOneCombinedModel);
-//    TEST_ASSERT_EQUAL_FLOAT(childOneScale.x, 4.0f);
-//    TEST_ASSERT_EQUAL_FLOAT(childOneScale.y, 4.0f);
-//
-//    TransformModel2D* globalTransform = rbe_scene_manager_get_scene_node_global_transform(childOneEntity, childOneTransform);
-//    transform2d_component_print(&childOneCombinedTransform);
+    rbe_math_affine2d_mul(&parentModel, &childOneModel, &childOneModel);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -180.0f, childOneModel.translation[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 220.0f, childOneModel.translation[1]);
+    // Inverse brings world space points back to the child's local space
+    Affine2D childOneInverse;
+    TEST_ASSERT_TRUE(rbe_math_affine2d_inverse(&childOneModel, &childOneInverse));
+    const Vector2 childLocalOrigin = rbe_math_affine2d_transform_point(&childOneInverse, (Vector2) { -180.0f, 220.0f });
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, childLocalOrigin.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, childLocalOrigin.y);
+
+    // Global transform pass resolves the child as parent * child
+    rbe_scene_manager_update_global_transforms();
+    parentTransform = (Transform2DComponent*) component_manager_get_component_unsafe(parentEntity, ComponentDataIndex_TRANSFORM_2D);
+    childOneTransform = (Transform2DComponent*) component_manager_get_component_unsafe(childOneEntity, ComponentDataIndex_TRANSFORM_2D);
+    TEST_ASSERT_FALSE(parentTransform->isGlobalTransformDirty);
+    TEST_ASSERT_FALSE(childOneTransform->isGlobalTransformDirty);
+    const TransformModel2D* childOneGlobalTransform = &childOneTransform->globalTransform;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, childOneModel.linear[i], childOneGlobalTransform->model.linear[i]);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, childOneModel.translation[0], childOneGlobalTransform->model.translation[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, childOneModel.translation[1], childOneGlobalTransform->model.translation[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -180.0f, childOneGlobalTransform->position.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 220.0f, childOneGlobalTransform->position.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.0f, childOneGlobalTransform->scale.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.0f, childOneGlobalTransform->scale.y);
+
+    // Invalidating the parent re-dirties the child subtree, the next pass picks up the parent's new position
+    parentTransform->localTransform.position.x = 20.0f;
+    rbe_scene_manager_invalidate_scene_node_global_transform(parentEntity);
+    TEST_ASSERT_TRUE(parentTransform->isGlobalTransformDirty);
+    TEST_ASSERT_TRUE(childOneTransform->isGlobalTransformDirty);
+    rbe_scene_manager_update_global_transforms();
+    TEST_ASSERT_FALSE(parentTransform->isGlobalTransformDirty);
+    TEST_ASSERT_FALSE(childOneTransform->isGlobalTransformDirty);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -380.0f, childOneGlobalTransform->position.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 220.0f, childOneGlobalTransform->position.y);
 
     component_manager_finalize();
     rbe_scene_manager_finalize();
 }
+
+// RBE Scene Binary Test
+void rbe_scene_binary_test() {
+    component_manager_initialize();
+    rbe_ec_system_initialize();
+    rbe_scene_manager_initialize();
+
+    SceneBinaryBuilder* builder = rbe_scene_binary_builder_create();
+    const uint32_t rootIndex = rbe_scene_binary_builder_add_node(builder, RBE_SCENE_BINARY_NO_PARENT, "Main", NodeBaseType_NODE2D);
+    SceneBinaryComponent scriptComponent = { .type = ComponentDataIndex_SCRIPT };
+    scriptComponent.script.classPath = rbe_scene_binary_builder_add_string(builder, "src.main");
+    scriptComponent.script.className = rbe_scene_binary_builder_add_string(builder, "Main");
+    rbe_scene_binary_builder_add_component(builder, &scriptComponent);
+    const uint32_t playerIndex = rbe_scene_binary_builder_add_node(builder, rootIndex, "PlayerOne", NodeBaseType_NODE2D);
+    SceneBinaryComponent transformComponent = { .type = ComponentDataIndex_TRANSFORM_2D };
+    transformComponent.transform2D.localTransform = (Transform2D) { .position = { 40.0f, 20.0f }, .scale = { 1.0f, 1.0f } };
+    rbe_scene_binary_builder_add_component(builder, &transformComponent);
+    rbe_scene_binary_builder_add_node(builder, playerIndex, "Collider", NodeBaseType_COLLIDER2D);
+    SceneBinary* sceneBinary = rbe_scene_binary_builder_finish(builder);
+    TEST_ASSERT_EQUAL_size_t(3, rbe_scene_binary_get_node_count(sceneBinary));
+
+    const Entity rootEntity = rbe_scene_binary_instantiate(sceneBinary, NULL_ENTITY);
+    const Entity playerEntity = rbe_scene_manager_get_entity_child_by_name(rootEntity, "PlayerOne");
+    TEST_ASSERT_NOT_EQUAL(NULL_ENTITY, playerEntity);
+    TEST_ASSERT_NOT_EQUAL(NULL_ENTITY, rbe_scene_manager_get_entity_child_by_path(rootEntity, "PlayerOne/Collider"));
+    const ScriptComponent* rootScript = component_manager_get_component(rootEntity, ComponentDataIndex_SCRIPT);
+    TEST_ASSERT_EQUAL_STRING("src.main", rootScript->classPath);
+    TEST_ASSERT_EQUAL_STRING("Main", rootScript->className);
+    const Transform2DComponent* playerTransform = component_manager_get_component(playerEntity, ComponentDataIndex_TRANSFORM_2D);
+    TEST_ASSERT_EQUAL_FLOAT(40.0f, playerTransform->localTransform.position.x);
+
+    rbe_scene_binary_destroy(sceneBinary);
+    rbe_scene_manager_finalize();
+    rbe_ec_system_finalize();
+    component_manager_finalize();
+}
+
+// RBE ECS Command Buffer Test
+void rbe_ecs_command_buffer_test() {
+    component_manager_initialize();
+    rbe_ec_system_initialize();
+    rbe_scene_manager_initialize();
+    rbe_ecs_command_buffer_initialize();
+
+    // Nothing is applied until playback
+    const Entity entity = rbe_ecs_command_buffer_create_entity();
+    Transform2DComponent* transform2DComponent = transform2d_component_create();
+    transform2DComponent->localTransform.position.x = 12.0f;
+    rbe_ecs_command_buffer_set_component(entity, ComponentDataIndex_TRANSFORM_2D, transform2DComponent);
+    rbe_ecs_command_buffer_set_component(entity, ComponentDataIndex_SCRIPT, script_component_create());
+    TEST_ASSERT_FALSE(component_manager_has_component(entity, ComponentDataIndex_TRANSFORM_2D));
+    rbe_ecs_command_buffer_playback();
+    const Transform2DComponent* storedTransform = component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+    TEST_ASSERT_EQUAL_FLOAT(12.0f, storedTransform->localTransform.position.x);
+    TEST_ASSERT_TRUE(component_manager_has_component(entity, ComponentDataIndex_SCRIPT));
+
+    rbe_ecs_command_buffer_remove_component(entity, ComponentDataIndex_SCRIPT);
+    rbe_ecs_command_buffer_playback();
+    TEST_ASSERT_FALSE(component_manager_has_component(entity, ComponentDataIndex_SCRIPT));
+    TEST_ASSERT_TRUE(component_manager_has_component(entity, ComponentDataIndex_TRANSFORM_2D));
+
+    // Commands recorded after an entity's destroy command are dropped
+    rbe_ecs_command_buffer_destroy_entity(entity);
+    rbe_ecs_command_buffer_set_component(entity, ComponentDataIndex_SCRIPT, script_component_create());
+    rbe_ecs_command_buffer_playback();
+    TEST_ASSERT_FALSE(rbe_ec_system_is_entity_alive(entity));
+    // Commands for a stale handle don't land on entities created since
+    const Entity newEntity = rbe_ec_system_create_entity();
+    rbe_ecs_command_buffer_set_component(entity, ComponentDataIndex_SCRIPT, script_component_create());
+    rbe_ecs_command_buffer_playback();
+    TEST_ASSERT_FALSE(rbe_ec_system_is_entity_alive(entity));
+    TEST_ASSERT_FALSE(component_manager_has_component(newEntity, ComponentDataIndex_SCRIPT));
+
+    rbe_ecs_command_buffer_finalize();
+    rbe_scene_manager_finalize();
+    rbe_ec_system_finalize();
+    component_manager_finalize();
+}
+
+// RBE Rect2 Bounds Test
+void rbe_rect2_bounds_test() {
+    const Rect2 localRect = { -8.0f, -4.0f, 16.0f, 8.0f };
+    // Translated and scaled
+    Affine2D model;
+    rbe_math_affine2d_from_trs(&model, &(Vector2) { 100.0f, 50.0f }, 0.0f, &(Vector2) { 2.0f, 2.0f });
+    Rect2 bounds = rbe_math_get_transformed_rect2_bounds(&model, &localRect);
+    TEST_ASSERT_EQUAL_FLOAT(84.0f, bounds.x);
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, bounds.y);
+    TEST_ASSERT_EQUAL_FLOAT(32.0f, bounds.w);
+    TEST_ASSERT_EQUAL_FLOAT(16.0f, bounds.h);
+    // Rotated a quarter turn swaps width and height
+    rbe_math_affine2d_from_trs(&model, &(Vector2) { 0.0f, 0.0f }, 90.0f, &(Vector2) { 1.0f, 1.0f });
+    bounds = rbe_math_get_transformed_rect2_bounds(&model, &localRect);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 8.0f, bounds.w);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 16.0f, bounds.h);
+
+    const Rect2 viewRect = { 0.0f, 0.0f, 800.0f, 600.0f };
+    const Rect2 insideRect = { 790.0f, 590.0f, 20.0f, 20.0f };
+    const Rect2 outsideRect = { 800.0f, 100.0f, 20.0f, 20.0f };
+    TEST_ASSERT_TRUE(rbe_math_does_rect2_intersect(&insideRect, &viewRect));
+    TEST_ASSERT_FALSE(rbe_math_does_rect2_intersect(&outsideRect, &viewRect));
+}
+
+// RBE Entity Generation Test
+void rbe_entity_generation_test() {
+    rbe_ec_system_initialize();
+
+    // Destroying an entity bumps its index's generation, handles from before are stale
+    const Entity entity = rbe_ec_system_create_entity();
+    TEST_ASSERT_TRUE(rbe_ec_system_is_entity_alive(entity));
+    rbe_ec_system_destroy_entity(entity);
+    TEST_ASSERT_FALSE(rbe_ec_system_is_entity_alive(entity));
+    TEST_ASSERT_FALSE(rbe_ec_system_is_entity_alive(NULL_ENTITY));
+
+    // Freed indices aren't reused until more than 1024 are queued in the free ring
+    const Entity freshEntity = rbe_ec_system_create_entity();
+    TEST_ASSERT_NOT_EQUAL(entity_get_index(entity), entity_get_index(freshEntity));
+    rbe_ec_system_destroy_entity(freshEntity);
+    for (int i = 0; i < 1023; i++) {
+        rbe_ec_system_destroy_entity(rbe_ec_system_create_entity());
+    }
+    const Entity recycledEntity = rbe_ec_system_create_entity();
+    TEST_ASSERT_EQUAL_UINT32(entity_get_index(entity), entity_get_index(recycledEntity));
+    TEST_ASSERT_EQUAL_UINT32(entity_get_generation(entity) + 1, entity_get_generation(recycledEntity));
+    TEST_ASSERT_TRUE(rbe_ec_system_is_entity_alive(recycledEntity));
+    TEST_ASSERT_FALSE(rbe_ec_system_is_entity_alive(entity));
+
+    // Stale handles don't affect the entity now using their index
+    rbe_ec_system_destroy_entity(entity);
+    TEST_ASSERT_TRUE(rbe_ec_system_is_entity_alive(recycledEntity));
+
+    rbe_ec_system_finalize();
+}
+
+static volatile bool schedulerTestWriterFinished = false;
+static volatile bool schedulerTestReaderSawWriter = false;
+
+void scheduler_test_writer_render() {
+    usleep(20000);
+    schedulerTestWriterFinished = true;
+}
+
+void scheduler_test_reader_render() {
+    schedulerTestReaderSawWriter = schedulerTestWriterFinished;
+}
+
+void rbe_ec_system_scheduler_test() {
+    component_manager_initialize();
+    rbe_ec_system_initialize();
+
+    // Writer stays on the main thread, anything sharing its wave would run on a worker at the same time
+    EntitySystem* writerSystem = rbe_ec_system_create();
+    writerSystem->render_func = scheduler_test_writer_render;
+    writerSystem->write_components = component_signature_create(ComponentType_TRANSFORM_2D);
+    rbe_ec_system_register(writerSystem);
+
+    // Reading what the writer writes conflicts, so the reader waits for the next wave
+    EntitySystem* readerSystem = rbe_ec_system_create();
+    readerSystem->render_func = scheduler_test_reader_render;
+    readerSystem->read_components = component_signature_create(ComponentType_TRANSFORM_2D);
+    readerSystem->is_main_thread_only = false;
+    rbe_ec_system_register(readerSystem);
+
+    rbe_ec_system_render_systems();
+    TEST_ASSERT_TRUE(schedulerTestWriterFinished);
+    TEST_ASSERT_TRUE(schedulerTestReaderSawWriter);
+
+    rbe_ec_system_finalize();
+    component_manager_finalize();
+}
+
+#define PARALLEL_FOR_TEST_COUNT 1000
+#define PARALLEL_FOR_TEST_CHUNK_SIZE 64
+
+typedef struct ParallelForTestContext {
+    int indexHits[PARALLEL_FOR_TEST_COUNT];
+    int chunkHits[(PARALLEL_FOR_TEST_COUNT + PARALLEL_FOR_TEST_CHUNK_SIZE - 1) / PARALLEL_FOR_TEST_CHUNK_SIZE];
+} ParallelForTestContext;
+
+void parallel_for_test_func(size_t start, size_t end, size_t chunkIndex, void* context) {
+    ParallelForTestContext* testContext = (ParallelForTestContext*) context;
+    // Chunks only touch their own range, so no locking needed
+    testContext->chunkHits[chunkIndex]++;
+    for (size_t i = start; i < end; i++) {
+        testContext->indexHits[i]++;
+    }
+}
+
+void rbe_thread_pool_parallel_for_test() {
+    // 1000 isn't a multiple of 64, last chunk is short
+    const size_t expectedChunkCount = (PARALLEL_FOR_TEST_COUNT + PARALLEL_FOR_TEST_CHUNK_SIZE - 1) / PARALLEL_FOR_TEST_CHUNK_SIZE;
+    ThreadPool* tp = tpool_create(3);
+    ParallelForTestContext* context = RBE_MEM_ALLOCATE(ParallelForTestContext);
+    memset(context, 0, sizeof(ParallelForTestContext));
+    const size_t chunkCount = tpool_parallel_for(tp, PARALLEL_FOR_TEST_COUNT, PARALLEL_FOR_TEST_CHUNK_SIZE, parallel_for_test_func, context);
+    TEST_ASSERT_EQUAL_UINT(expectedChunkCount, chunkCount);
+    for (size_t i = 0; i < PARALLEL_FOR_TEST_COUNT; i++) {
+        TEST_ASSERT_EQUAL_INT(1, context->indexHits[i]);
+    }
+    for (size_t i = 0; i < chunkCount; i++) {
+        TEST_ASSERT_EQUAL_INT(1, context->chunkHits[i]);
+    }
+
+    // Without a pool every chunk runs inline on the calling thread
+    memset(context, 0, sizeof(ParallelForTestContext));
+    TEST_ASSERT_EQUAL_UINT(expectedChunkCount, tpool_parallel_for(NULL, PARALLEL_FOR_TEST_COUNT, PARALLEL_FOR_TEST_CHUNK_SIZE, parallel_for_test_func, context));
+    for (size_t i = 0; i < PARALLEL_FOR_TEST_COUNT; i++) {
+        TEST_ASSERT_EQUAL_INT(1, context->indexHits[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, tpool_parallel_for(tp, 0, PARALLEL_FOR_TEST_CHUNK_SIZE, parallel_for_test_func, context));
+
+    RBE_MEM_FREE(context);
+    tpool_destroy(tp);
+}
+
+Entity archetype_test_create_entity(float positionX) {
+    const Entity entity = rbe_ec_system_create_entity();
+    Transform2DComponent* transform2DComponent = transform2d_component_create();
+    transform2DComponent->localTransform.position.x = positionX;
+    component_manager_set_component(entity, ComponentDataIndex_TRANSFORM_2D, transform2DComponent);
+    return entity;
+}
+
+float archetype_test_get_position_x(Entity entity) {
+    const Transform2DComponent* transform2DComponent = component_manager_get_component(entity, ComponentDataIndex_TRANSFORM_2D);
+    return transform2DComponent->localTransform.position.x;
+}
+
+void rbe_component_archetype_test() {
+    component_manager_initialize();
+    rbe_ec_system_initialize();
+
+    ComponentQuery* transformOnlyQuery = component_manager_query(component_signature_create(ComponentType_TRANSFORM_2D));
+    ComponentQuery* colorSquareQuery = component_manager_query(component_signature_create(ComponentType_TRANSFORM_2D | ComponentType_COLOR_SQUARE));
+    const Entity entityOne = archetype_test_create_entity(1.0f);
+    const Entity entityTwo = archetype_test_create_entity(2.0f);
+    const Entity entityThree = archetype_test_create_entity(3.0f);
+    size_t chunkCount = 0;
+    const ComponentQueryChunk* chunks = component_query_get_chunks(colorSquareQuery, &chunkCount);
+    TEST_ASSERT_EQUAL_UINT(0, chunkCount);
+
+    // Adding a component moves the entity and its existing components to the matching archetype
+    ColorSquareComponent* colorSquareComponent = color_square_component_create();
+    colorSquareComponent->size.w = 16.0f;
+    component_manager_set_component(entityOne, ComponentDataIndex_COLOR_SQUARE, colorSquareComponent);
+    chunks = component_query_get_chunks(colorSquareQuery, &chunkCount);
+    TEST_ASSERT_EQUAL_UINT(1, chunkCount);
+    TEST_ASSERT_EQUAL_UINT(1, chunks[0].count);
+    TEST_ASSERT_EQUAL_UINT32(entityOne, chunks[0].entities[0]);
+    const Transform2DComponent* chunkTransforms = component_query_chunk_get_components(&chunks[0], ComponentDataIndex_TRANSFORM_2D);
+    const ColorSquareComponent* chunkColorSquares = component_query_chunk_get_components(&chunks[0], ComponentDataIndex_COLOR_SQUARE);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, chunkTransforms[0].localTransform.position.x);
+    TEST_ASSERT_EQUAL_FLOAT(16.0f, chunkColorSquares[0].size.w);
+
+    // The last row is swapped into the row the entity left, rows stay lined up with their entities
+    chunks = component_query_get_chunks(transformOnlyQuery, &chunkCount);
+    size_t rowCount = 0;
+    for (size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++) {
+        const ComponentQueryChunk* chunk = &chunks[chunkIndex];
+        if (component_manager_has_component(chunk->entities[0], ComponentDataIndex_COLOR_SQUARE)) {
+            continue;
+        }
+        chunkTransforms = component_query_chunk_get_components(chunk, ComponentDataIndex_TRANSFORM_2D);
+        for (size_t i = 0; i < chunk->count; i++) {
+            TEST_ASSERT_EQUAL_FLOAT(archetype_test_get_position_x(chunk->entities[i]), chunkTransforms[i].localTransform.position.x);
+            rowCount++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(2, rowCount);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, archetype_test_get_position_x(entityTwo));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, archetype_test_get_position_x(entityThree));
+
+    // Removing it moves the entity back, keeping the components it still has
+    component_manager_remove_component(entityOne, ComponentDataIndex_COLOR_SQUARE);
+    chunks = component_query_get_chunks(colorSquareQuery, &chunkCount);
+    TEST_ASSERT_EQUAL_UINT(0, chunkCount);
+    TEST_ASSERT_FALSE(component_manager_has_component(entityOne, ComponentDataIndex_COLOR_SQUARE));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, archetype_test_get_position_x(entityOne));
+
+    // Entities left behind by a removed row keep their data
+    component_manager_remove_all_components(entityTwo);
+    TEST_ASSERT_FALSE(component_manager_has_component(entityTwo, ComponentDataIndex_TRANSFORM_2D));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, archetype_test_get_position_x(entityOne));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, archetype_test_get_position_x(entityThree));
+
+    rbe_ec_system_finalize();
+    component_manager_finalize();
+}
+
+static EntitySystem* changeTickTestSystem = NULL;
+static ComponentQuery* changeTickTestQuery = NULL;
+static size_t changeTickTestChangedCount = 0;
+
+void change_tick_test_process(float deltaTime) {
+    changeTickTestChangedCount = 0;
+    size_t chunkCount = 0;
+    const ComponentQueryChunk* chunks = component_query_get_chunks(changeTickTestQuery, &chunkCount);
+    for (size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++) {
+        const ComponentQueryChunk* chunk = &chunks[chunkIndex];
+        if (!component_query_chunk_has_changed(chunk, ComponentDataIndex_TRANSFORM_2D, changeTickTestSystem->last_change_tick)) {
+            continue;
+        }
+        const uint32_t* changeTicks = component_query_chunk_get_change_ticks(chunk, ComponentDataIndex_TRANSFORM_2D);
+        for (size_t i = 0; i < chunk->count; i++) {
+            if (changeTicks[i] > changeTickTestSystem->last_change_tick) {
+                changeTickTestChangedCount++;
+            }
+        }
+    }
+}
+
+void rbe_component_change_tick_test() {
+    component_manager_initialize();
+    rbe_ec_system_initialize();
+
+    changeTickTestQuery = component_manager_query(component_signature_create(ComponentType_TRANSFORM_2D));
+    changeTickTestSystem = rbe_ec_system_create();
+    changeTickTestSystem->process_func = change_tick_test_process;
+    changeTickTestSystem->read_components = component_signature_create(ComponentType_TRANSFORM_2D);
+    rbe_ec_system_register(changeTickTestSystem);
+
+    // First run sees every component set before it
+    const Entity entityOne = archetype_test_create_entity(1.0f);
+    archetype_test_create_entity(2.0f);
+    rbe_ec_system_process_systems(0.1f);
+    TEST_ASSERT_EQUAL_UINT(2, changeTickTestChangedCount);
+
+    // Reading doesn't count as a change
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, archetype_test_get_position_x(entityOne));
+    rbe_ec_system_process_systems(0.1f);
+    TEST_ASSERT_EQUAL_UINT(0, changeTickTestChangedCount);
+
+    // Writing between frames is seen by the next run only
+    Transform2DComponent* transform2DComponent = component_manager_get_component_for_write(entityOne, ComponentDataIndex_TRANSFORM_2D);
+    transform2DComponent->localTransform.position.x = 5.0f;
+    TEST_ASSERT_TRUE(component_manager_get_component_change_tick(entityOne, ComponentDataIndex_TRANSFORM_2D) > changeTickTestSystem->last_change_tick);
+    rbe_ec_system_process_systems(0.1f);
+    TEST_ASSERT_EQUAL_UINT(1, changeTickTestChangedCount);
+    rbe_ec_system_process_systems(0.1f);
+    TEST_ASSERT_EQUAL_UINT(0, changeTickTestChangedCount);
+
+    rbe_ec_system_finalize();
+    component_manager_finalize();
+    changeTickTestSystem = NULL;
+    changeTickTestQuery = NULL;
+}
+
+Entity prefab_test_create_node(Entity parent, float positionX) {
+    const Entity entity = archetype_test_create_entity(positionX);
+    rbe_scene_tree_create_tree_node(entity, parent);
+    rbe_scene_manager_queue_entity_for_creation(entity);
+    return entity;
+}
+
+void prefab_test_add_collider(Entity entity, Entity exceptionOne, Entity exceptionTwo) {
+    Collider2DComponent* collider2DComponent = collider2d_component_create();
+    collider2DComponent->collisionExceptions[collider2DComponent->collisionExceptionCount++] = exceptionOne;
+    if (exceptionTwo != NULL_ENTITY) {
+        collider2DComponent->collisionExceptions[collider2DComponent->collisionExceptionCount++] = exceptionTwo;
+    }
+    component_manager_set_component(entity, ComponentDataIndex_COLLIDER_2D, collider2DComponent);
+}
+
+void rbe_prefab_registry_test() {
+    component_manager_initialize();
+    rbe_ec_system_initialize();
+    rbe_scene_manager_initialize();
+
+    // Scene root -> prefab root (script) -> child one, child two.  Colliders reference each other and an outside entity.
+    const Entity sceneRoot = prefab_test_create_node(NULL_ENTITY, 0.0f);
+    const Entity outsideEntity = prefab_test_create_node(sceneRoot, 0.0f);
+    const Entity prefabRoot = prefab_test_create_node(sceneRoot, 10.0f);
+    const Entity childOne = prefab_test_create_node(prefabRoot, 11.0f);
+    const Entity childTwo = prefab_test_create_node(prefabRoot, 12.0f);
+    prefab_test_add_collider(childOne, childTwo, outsideEntity);
+    prefab_test_add_collider(childTwo, prefabRoot, NULL_ENTITY);
+    char* classPath = rbe_strdup("test.prefab_script");
+    ScriptComponent* scriptComponent = script_component_create();
+    scriptComponent->classPath = classPath;
+    scriptComponent->className = "PrefabScript";
+    component_manager_set_component(prefabRoot, ComponentDataIndex_SCRIPT, scriptComponent);
+    rbe_prefab_registry_register("test_prefab", prefabRoot);
+    TEST_ASSERT_TRUE(rbe_prefab_registry_has("test_prefab"));
+
+    const Entity instanceRoot = rbe_prefab_registry_instantiate("test_prefab", sceneRoot);
+    TEST_ASSERT_NOT_EQUAL(prefabRoot, instanceRoot);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, archetype_test_get_position_x(instanceRoot));
+    const SceneTreeNode* instanceRootNode = rbe_scene_manager_get_entity_tree_node(instanceRoot);
+    TEST_ASSERT_EQUAL_UINT(2, instanceRootNode->childCount);
+    const Entity instanceChildOne = instanceRootNode->firstChild;
+    const Entity instanceChildTwo = rbe_scene_manager_get_entity_tree_node(instanceChildOne)->nextSibling;
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, archetype_test_get_position_x(instanceChildOne));
+    TEST_ASSERT_EQUAL_FLOAT(12.0f, archetype_test_get_position_x(instanceChildTwo));
+    TEST_ASSERT_EQUAL_UINT(3, rbe_scene_manager_get_entity_tree_node(sceneRoot)->childCount);
+
+    // Exceptions pointing inside the prefab are remapped to the instance, outside ones are kept
+    const Collider2DComponent* instanceColliderOne = component_manager_get_component(instanceChildOne, ComponentDataIndex_COLLIDER_2D);
+    TEST_ASSERT_EQUAL_UINT(2, instanceColliderOne->collisionExceptionCount);
+    TEST_ASSERT_EQUAL_UINT32(instanceChildTwo, instanceColliderOne->collisionExceptions[0]);
+    TEST_ASSERT_EQUAL_UINT32(outsideEntity, instanceColliderOne->collisionExceptions[1]);
+    const Collider2DComponent* instanceColliderTwo = component_manager_get_component(instanceChildTwo, ComponentDataIndex_COLLIDER_2D);
+    TEST_ASSERT_EQUAL_UINT32(instanceRoot, instanceColliderTwo->collisionExceptions[0]);
+    const Collider2DComponent* sourceColliderOne = component_manager_get_component(childOne, ComponentDataIndex_COLLIDER_2D);
+    TEST_ASSERT_EQUAL_UINT32(childTwo, sourceColliderOne->collisionExceptions[0]);
+
+    // Instances keep valid script paths after the prefab is registered again and the source's path is freed
+    rbe_prefab_registry_register("test_prefab", prefabRoot);
+    scriptComponent = component_manager_get_component(prefabRoot, ComponentDataIndex_SCRIPT);
+    scriptComponent->classPath = NULL;
+    RBE_MEM_FREE(classPath);
+    const ScriptComponent* instanceScript = component_manager_get_component(instanceRoot, ComponentDataIndex_SCRIPT);
+    TEST_ASSERT_EQUAL_STRING("test.prefab_script", instanceScript->classPath);
+    TEST_ASSERT_EQUAL_STRING("PrefabScript", instanceScript->className);
+
+    rbe_scene_manager_finalize();
+    rbe_ec_system_finalize();
+    component_manager_finalize();
+}